@@ -0,0 +1,359 @@
+// mysa_bench: micro-benchmarks for the per-step hot paths.
+// Usage: mysa_bench [--ops <n>] [--reps <n>] [--warmup <n>] [--filter <text>] [--json <file>]
+//                   [--baseline <file.json> [--tolerance <percent>]]
+// Each benchmark runs `warmup` untimed repetitions, then `reps` timed repetitions of `ops` calls,
+// and reports the median ns/op, the fastest repetition, calls per second and heap allocations per
+// call. --json writes one benchmark object per line; --baseline compares against an earlier file
+// and exits with 1 if any median got slower than the tolerance (default 10%).
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "../include/Calibration.h"
+#include "../include/Soil.h"
+#include "../include/Plant.h"
+#include "../include/WaterPump.h"
+#include "../include/WeatherBatch.h"
+#include "../include/WeatherSensor.h"
+#include "../include/GardenZone.h"
+#include "../include/IrrigationController.h"
+#include "../include/Logger.h"
+#include "../include/LogSink.h"
+#include "../include/Profiler.h"
+
+// --- Allocation counting: every operator new in the process goes through here ---
+static std::atomic<unsigned long long> allocationCount(0);
+static std::atomic<unsigned long long> allocationBytes(0);
+
+// The replacements free what they malloc, but GCC 11+ flags free() inlined into a delete of a new'd pointer
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+void* operator new(std::size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    allocationBytes.fetch_add(size, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+void* operator new[](std::size_t size) { return operator new(size); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic pop
+#endif
+
+// Keeps results observable so the optimizer cannot drop the calls
+static volatile float blackHole = 0.0f;
+
+// Discards everything written to it (CSV sink target)
+class NullBuffer : public std::streambuf {
+protected:
+    int overflow(int c) override { return c; }
+    std::streamsize xsputn(const char*, std::streamsize n) override { return n; }
+};
+
+struct BenchResult {
+    std::string name;
+    long long ops;
+    int reps;
+    double medianNs;     // ns/op
+    double minNs;        // ns/op of the fastest repetition
+    double opsPerSecond; // From the median
+    double allocsPerOp;
+    double bytesPerOp;
+};
+
+struct BenchConfig {
+    long long ops = 200000;
+    int reps = 7;
+    int warmup = 2;
+    std::string filter;
+};
+
+// body(i) is one call of the measured path; i keeps increasing across repetitions
+template <typename Body>
+BenchResult runBench(const std::string& name, const BenchConfig& config, Body body) {
+    long long i = 0;
+    for (int w = 0; w < config.warmup; ++w) {
+        for (long long n = 0; n < config.ops; ++n) body(i++);
+    }
+    std::vector<double> nsPerOp;
+    unsigned long long allocs = 0, bytes = 0;
+    for (int r = 0; r < config.reps; ++r) {
+        unsigned long long a0 = allocationCount.load(), b0 = allocationBytes.load();
+        auto start = std::chrono::steady_clock::now();
+        for (long long n = 0; n < config.ops; ++n) body(i++);
+        auto end = std::chrono::steady_clock::now();
+        allocs += allocationCount.load() - a0;
+        bytes += allocationBytes.load() - b0;
+        nsPerOp.push_back(std::chrono::duration<double, std::nano>(end - start).count() / config.ops);
+    }
+    std::sort(nsPerOp.begin(), nsPerOp.end());
+    BenchResult result;
+    result.name = name;
+    result.ops = config.ops;
+    result.reps = config.reps;
+    result.medianNs = nsPerOp[nsPerOp.size() / 2];
+    result.minNs = nsPerOp.front();
+    result.opsPerSecond = result.medianNs > 0.0 ? 1e9 / result.medianNs : 0.0;
+    double totalOps = static_cast<double>(config.ops) * config.reps;
+    result.allocsPerOp = allocs / totalOps;
+    result.bytesPerOp = bytes / totalOps;
+    return result;
+}
+
+static std::string toJson(const BenchResult& r) {
+    std::ostringstream out;
+    out << std::setprecision(6) << "{\"name\": \"" << r.name << "\", \"ops\": " << r.ops << ", \"reps\": " << r.reps
+        << ", \"ns_per_op\": " << r.medianNs << ", \"min_ns_per_op\": " << r.minNs
+        << ", \"ops_per_sec\": " << r.opsPerSecond << ", \"allocs_per_op\": " << r.allocsPerOp
+        << ", \"bytes_per_op\": " << r.bytesPerOp << "}";
+    return out.str();
+}
+
+// Reads name -> ns_per_op from a file written by --json
+static std::map<std::string, double> loadBaseline(const std::string& path) {
+    std::map<std::string, double> baseline;
+    std::ifstream in(path);
+    std::string line;
+    while (std::getline(in, line)) {
+        size_t name = line.find("\"name\": \"");
+        size_t ns = line.find("\"ns_per_op\": ");
+        if (name == std::string::npos || ns == std::string::npos) continue;
+        name += 9;
+        baseline[line.substr(name, line.find('"', name) - name)] = std::atof(line.c_str() + ns + 13);
+    }
+    return baseline;
+}
+
+int main(int argc, char* argv[]) {
+    BenchConfig config;
+    std::string jsonPath, baselinePath;
+    double tolerance = 10.0;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--ops" && i + 1 < argc) config.ops = std::atoll(argv[++i]);
+        else if (arg == "--reps" && i + 1 < argc) config.reps = std::atoi(argv[++i]);
+        else if (arg == "--warmup" && i + 1 < argc) config.warmup = std::atoi(argv[++i]);
+        else if (arg == "--filter" && i + 1 < argc) config.filter = argv[++i];
+        else if (arg == "--json" && i + 1 < argc) jsonPath = argv[++i];
+        else if (arg == "--baseline" && i + 1 < argc) baselinePath = argv[++i];
+        else if (arg == "--tolerance" && i + 1 < argc) tolerance = std::atof(argv[++i]);
+        else {
+            std::cerr << "Usage: " << argv[0] << " [--ops <n>] [--reps <n>] [--warmup <n>] [--filter <text>] [--json <file>] [--baseline <file.json> [--tolerance <percent>]]" << std::endl;
+            return 12;
+        }
+    }
+    if (config.ops < 1 || config.reps < 1) {
+        std::cerr << "--ops and --reps must be at least 1" << std::endl;
+        return 15;
+    }
+
+    std::vector<BenchResult> results;
+    auto bench = [&](const std::string& name, const std::function<BenchResult()>& run) {
+        if (config.filter.empty() || name.find(config.filter) != std::string::npos) results.push_back(run());
+    };
+
+    bench("Soil::update", [&]() {
+        Soil soil(0.8f, 0.2f);
+        return runBench("Soil::update", config, [&](long long i) {
+            soil.update(0.01f, (i & 7) == 0 ? 1.0f : 0.0f, 0.0f);
+            blackHole = soil.getMoisture();
+        });
+    });
+    bench("Plant::update", [&]() {
+        Plant plant(10.0f, 10.0f, 0.05f);
+        return runBench("Plant::update", config, [&](long long i) {
+            plant.update(static_cast<float>(i & 63));
+            blackHole = plant.getStress();
+        });
+    });
+    // Calibration replays a 1024-step series; one op is one step of one candidate
+    ObservedSeries observed;
+    observed.anchor(40.0f, 0.0f);
+    for (int t = 0; t < 1024; ++t) observed.add(0.01f, (t & 7) == 0 ? 0.1f : 0.0f, 40.0f, 0.0f);
+    bench("evaluateFit (per step)", [&]() {
+        SoilPlantParams params;
+        return runBench("evaluateFit (per step)", config, [&](long long i) {
+            if ((i & 1023) == 0) blackHole = static_cast<float>(evaluateFit(observed, params, 10.0f).moistureSquared);
+        });
+    });
+    bench("evaluateFitBatch (per step and lane)", [&]() {
+        SoilPlantParams params[4];
+        FitError errors[4];
+        for (int k = 0; k < 4; ++k) params[k].soilRetentionRate = 0.5f + 0.1f * k;
+        return runBench("evaluateFitBatch (per step and lane)", config, [&](long long i) {
+            if ((i & 4095) == 0) {
+                evaluateFitBatch(observed, params, 4, 10.0f, 0, errors);
+                blackHole = static_cast<float>(errors[0].moistureSquared);
+            }
+        });
+    });
+    bench("WeatherSensor::update", [&]() {
+        WeatherSensor weather(CounterRng(1, 0));
+        return runBench("WeatherSensor::update", config, [&](long long i) {
+            weather.update(static_cast<int>(i));
+            if (weather.hasFailed()) weather.resetFailure();
+            blackHole = weather.getTemperature();
+        });
+    });
+    bench("WeatherBatch::generateTicks (per tick)", [&]() {
+        CounterRng rng = CounterRng(1, 0).withStream(CounterRng::WeatherStream);
+        float temperature[64], humidity[64], rainfall[64];
+        return runBench("WeatherBatch::generateTicks (per tick)", config, [&](long long i) {
+            if ((i & 63) == 0) WeatherBatch::generateTicks(rng, static_cast<int>(i % 1000000000), 64, temperature, humidity, rainfall);
+            blackHole = temperature[i & 63];
+        });
+    });
+    bench("WeatherBatch::generateZones (per zone, 256 zones)", [&]() {
+        std::vector<CounterRng> rngs;
+        for (uint32_t z = 0; z < 256; ++z) rngs.push_back(CounterRng(1, z).withStream(CounterRng::WeatherStream));
+        float temperature[256], humidity[256], rainfall[256];
+        return runBench("WeatherBatch::generateZones (per zone, 256 zones)", config, [&](long long i) {
+            if ((i & 255) == 0) WeatherBatch::generateZones(rngs.data(), 256, static_cast<int>((i >> 8) % 1000000000), temperature, humidity, rainfall);
+            blackHole = temperature[i & 255];
+        });
+    });
+    bench("WeatherSensor::getRainForecast", [&]() {
+        WeatherSensor weather(CounterRng(1, 0));
+        return runBench("WeatherSensor::getRainForecast", config, [&](long long i) {
+            if ((i & 63) == 0) weather.update(static_cast<int>(i));
+            blackHole = weather.getRainForecast(6);
+        });
+    });
+    bench("GardenZone::update", [&]() {
+        Soil soil(0.8f, 0.2f);
+        Plant plant(10.0f, 10.0f, 0.05f);
+        WaterPump pump(6.0f, 60.0f);
+        WeatherSensor weather(CounterRng(1, 0));
+        PumpBudget budget(2);
+        GardenZone zone(&plant, &soil, &weather, &pump, &budget);
+        return runBench("GardenZone::update", config, [&](long long i) {
+            zone.update(static_cast<int>(i));
+            if (weather.hasFailed()) weather.resetFailure();
+            blackHole = soil.getMoisture();
+        });
+    });
+    bench("GardenZone::update (profiled)", [&]() {
+        // The cases above run with the profiler disabled; this one shows what recording costs
+        Soil soil(0.8f, 0.2f);
+        Plant plant(10.0f, 10.0f, 0.05f);
+        WaterPump pump(6.0f, 60.0f);
+        WeatherSensor weather(CounterRng(1, 0));
+        PumpBudget budget(2);
+        GardenZone zone(&plant, &soil, &weather, &pump, &budget);
+        Profiler::enable(false);
+        BenchResult result = runBench("GardenZone::update (profiled)", config, [&](long long i) {
+            zone.update(static_cast<int>(i));
+            if (weather.hasFailed()) weather.resetFailure();
+            blackHole = soil.getMoisture();
+        });
+        Profiler::disable();
+        return result;
+    });
+    bench("IrrigationController::update", [&]() {
+        Soil soil(0.8f, 0.2f);
+        WaterPump pump(6.0f, 60.0f);
+        WeatherSensor weather(CounterRng(1, 0));
+        IrrigationController controller(&soil, &weather, &pump, nullptr, CounterRng(1, 0));
+        return runBench("IrrigationController::update", config, [&](long long i) {
+            if ((i & 63) == 0) weather.update(static_cast<int>(i));
+            controller.update(static_cast<int>(i));
+            blackHole = pump.isOn() ? 1.0f : 0.0f;
+        });
+    });
+    bench("IrrigationController::update (threshold only)", [&]() {
+        Soil soil(0.8f, 0.2f);
+        WaterPump pump(6.0f, 60.0f);
+        WeatherSensor weather(CounterRng(1, 0));
+        IrrigationController controller(&soil, &weather, &pump, nullptr, CounterRng(1, 0));
+        controller.setPredictiveWateringEnabled(false);
+        controller.setForecastDelayEnabled(false);
+        return runBench("IrrigationController::update (threshold only)", config, [&](long long i) {
+            if ((i & 63) == 0) weather.update(static_cast<int>(i));
+            controller.update(static_cast<int>(i));
+            blackHole = pump.isOn() ? 1.0f : 0.0f;
+        });
+    });
+    bench("IrrigationController::update (planner)", [&]() {
+        // Hourly re-plans and per-stage decisions amortised over the updates in between
+        Soil soil(0.8f, 0.2f);
+        WaterPump pump(6.0f, 60.0f);
+        WeatherSensor weather(CounterRng(1, 0));
+        IrrigationController controller(&soil, &weather, &pump, nullptr, CounterRng(1, 0));
+        controller.setPlannerModel(PlannerModel());
+        controller.setPlannerEnabled(true);
+        return runBench("IrrigationController::update (planner)", config, [&](long long i) {
+            if ((i & 63) == 0) weather.update(static_cast<int>(i));
+            controller.update(static_cast<int>(i));
+            blackHole = pump.isOn() ? 1.0f : 0.0f;
+        });
+    });
+    bench("Logger::logSecond (summary only)", [&]() {
+        Logger logger{std::unique_ptr<LogSink>()};
+        return runBench("Logger::logSecond (summary only)", config, [&](long long i) {
+            logger.logSecond(static_cast<int>(i), 50.0f, 49.5f, 20.0f, 60.0f, 0.0f, (i & 1) != 0, 6.0f, 0.1f,
+                             5.0f, false, "Zone1", "Loam", 0.016f);
+        });
+    });
+    bench("Logger::logSecond (CSV sink)", [&]() {
+        NullBuffer buffer;
+        std::ostream devNull(&buffer);
+        Logger logger{std::unique_ptr<LogSink>(new CsvLogSink(devNull))};
+        return runBench("Logger::logSecond (CSV sink)", config, [&](long long i) {
+            logger.logSecond(static_cast<int>(i), 50.0f, 49.5f, 20.0f, 60.0f, 0.0f, (i & 1) != 0, 6.0f, 0.1f,
+                             5.0f, false, "Zone1", "Loam", 0.016f);
+        });
+    });
+
+    std::cout << std::left << std::setw(48) << "Benchmark" << std::right << std::setw(12) << "ns/op"
+              << std::setw(12) << "min ns/op" << std::setw(14) << "ops/s" << std::setw(12) << "allocs/op" << std::endl;
+    for (const BenchResult& r : results) {
+        std::cout << std::left << std::setw(48) << r.name << std::right << std::fixed << std::setprecision(2)
+                  << std::setw(12) << r.medianNs << std::setw(12) << r.minNs << std::setprecision(0)
+                  << std::setw(14) << r.opsPerSecond << std::setprecision(3) << std::setw(12) << r.allocsPerOp << std::endl;
+    }
+    if (!jsonPath.empty()) {
+        std::ofstream json(jsonPath);
+        if (!json) {
+            std::cerr << "Failed to open " << jsonPath << std::endl;
+            return 1;
+        }
+        json << "[\n";
+        for (size_t i = 0; i < results.size(); ++i) json << "  " << toJson(results[i]) << (i + 1 < results.size() ? ",\n" : "\n");
+        json << "]\n";
+        std::cout << "JSON saved to: " << jsonPath << std::endl;
+    }
+    if (!baselinePath.empty()) {
+        std::map<std::string, double> baseline = loadBaseline(baselinePath);
+        if (baseline.empty()) {
+            std::cerr << "No benchmarks found in baseline " << baselinePath << std::endl;
+            return 1;
+        }
+        int regressions = 0;
+        std::cout << "\nAgainst " << baselinePath << " (tolerance " << std::setprecision(1) << tolerance << "%):" << std::endl;
+        for (const BenchResult& r : results) {
+            auto it = baseline.find(r.name);
+            if (it == baseline.end() || it->second <= 0.0) continue;
+            double change = (r.medianNs / it->second - 1.0) * 100.0;
+            bool regressed = change > tolerance;
+            if (regressed) ++regressions;
+            std::cout << std::left << std::setw(36) << r.name << std::right << std::showpos << std::setw(8) << change
+                      << std::noshowpos << "%" << (regressed ? "  REGRESSION" : "") << std::endl;
+        }
+        if (regressions > 0) return 1;
+    }
+    return 0;
+}
@@ -57,16 +57,39 @@ goto compile
 
 :compile
 echo Compiling Mysa Irrigation System...
-g++ -std=c++11 ^
+g++ -std=c++11 -pthread ^
     -IMysaIrrigationSystem/include ^
     MysaIrrigationSystem/main.cpp ^
     MysaIrrigationSystem/src/GardenZone.cpp ^
     MysaIrrigationSystem/src/IrrigationController.cpp ^
+    MysaIrrigationSystem/src/IrrigationPlanner.cpp ^
     MysaIrrigationSystem/src/Logger.cpp ^
+    MysaIrrigationSystem/src/LogSink.cpp ^
+    MysaIrrigationSystem/src/LogIndex.cpp ^
+    MysaIrrigationSystem/src/Calibration.cpp ^
+    MysaIrrigationSystem/src/Rollup.cpp ^
+    MysaIrrigationSystem/src/ParameterSweep.cpp ^
+    MysaIrrigationSystem/src/BinaryLog.cpp ^
+    MysaIrrigationSystem/src/AsyncLogSink.cpp ^
+    MysaIrrigationSystem/src/CounterRng.cpp ^
+    MysaIrrigationSystem/src/DeadlineScheduler.cpp ^
+    MysaIrrigationSystem/src/Checkpoint.cpp ^
+    MysaIrrigationSystem/src/Config.cpp ^
+    MysaIrrigationSystem/src/EventLog.cpp ^
+    MysaIrrigationSystem/src/EventSimulation.cpp ^
     MysaIrrigationSystem/src/Plant.cpp ^
+    MysaIrrigationSystem/src/Profiler.cpp ^
+    MysaIrrigationSystem/src/PumpArbiter.cpp ^
+    MysaIrrigationSystem/src/SensorIngest.cpp ^
+    MysaIrrigationSystem/src/SensorSlots.cpp ^
     MysaIrrigationSystem/src/Soil.cpp ^
     MysaIrrigationSystem/src/WaterPump.cpp ^
+    MysaIrrigationSystem/src/WeatherBatch.cpp ^
     MysaIrrigationSystem/src/WeatherSensor.cpp ^
+    MysaIrrigationSystem/src/WeatherTrace.cpp ^
+    MysaIrrigationSystem/src/ZoneBatch.cpp ^
+    MysaIrrigationSystem/src/ZoneScheduler.cpp ^
+    MysaIrrigationSystem/src/ZoneSimulation.cpp ^
     -o mysa_irrigation.exe
 
 if %ERRORLEVEL% EQU 0 (
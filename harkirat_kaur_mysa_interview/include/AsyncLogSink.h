@@ -0,0 +1,48 @@
+#ifndef ASYNCLOGSINK_H
+#define ASYNCLOGSINK_H
+
+#include "LogSink.h"
+#include "SpscRing.h"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+// What the simulation thread does when the log queue is full
+enum class Backpressure {
+    Block, // Wait for the writer thread to make room (no records lost)
+    Drop   // Discard the record and count it
+};
+
+// Moves formatting and I/O of another sink onto a background writer thread.
+// The simulation thread only copies a fixed-size LogRecord into a lock-free ring.
+class AsyncLogSink : public LogSink {
+public:
+    AsyncLogSink(std::unique_ptr<LogSink> inner, size_t queueCapacity = 65536,
+                 Backpressure policy = Backpressure::Block);
+    ~AsyncLogSink();
+    void defineName(uint16_t id, const std::string& name) override;
+    void write(const LogRecord& record) override;
+    void flush() override; // Blocks until every queued record reached the inner sink
+    // Queue statistics
+    size_t getQueueCapacity() const { return ring.capacity(); }
+    size_t getHighWaterMark() const { return highWaterMark; }
+    unsigned long long getDroppedRecords() const { return dropped; }
+    unsigned long long getWrittenRecords() const { return written.load(); }
+private:
+    void writerLoop();
+    size_t drainBatch();
+    std::unique_ptr<LogSink> inner;
+    SpscRing<LogRecord> ring;
+    Backpressure policy;
+    std::mutex innerMutex; // Serializes the writer thread with rare defineName()/flush() calls
+    std::atomic<bool> stopping{false};
+    size_t highWaterMark = 0;           // Producer-side only
+    unsigned long long dropped = 0;     // Producer-side only
+    unsigned long long pushed = 0;      // Producer-side only
+    std::atomic<unsigned long long> written{0};
+    std::unique_ptr<LogRecord[]> batch; // Writer-side scratch buffer
+    std::thread writer;
+};
+
+#endif // ASYNCLOGSINK_H
@@ -0,0 +1,59 @@
+#ifndef BINARYLOG_H
+#define BINARYLOG_H
+
+#include "LogSink.h"
+#include <fstream>
+#include <string>
+#include <vector>
+
+/*
+ * Binary columnar log format (.mlog), little-endian:
+ *
+ *   header : "MYSALOG\0" magic, uint32 version
+ *   chunks : uint8 tag followed by the chunk body
+ *     'N'  name dictionary entry: uint16 id, uint16 length, bytes
+ *     'B'  block of rows: uint32 rowCount, int32 baseTime, then one column at a time:
+ *            uint16 timeDelta[rowCount]   (seconds since previous row; first row is baseTime)
+ *            float  soilMoisture[], effectiveMoisture[], temperature[], humidity[],
+ *                   rainfall[], flowRate[], waterUsed[], plantStress[], powerUsed[]
+ *            uint16 zoneId[], soilType[]  (dictionary IDs)
+ *            uint8  flags[]               (bit0 pump on, bit1 sensor error)
+ *
+ * A block is closed when it is full or when a time delta does not fit in 16 bits.
+ */
+class BinaryLogSink : public LogSink {
+public:
+    explicit BinaryLogSink(const std::string& filename, size_t blockRows = 4096);
+    ~BinaryLogSink();
+    void defineName(uint16_t id, const std::string& name) override;
+    void write(const LogRecord& record) override;
+    void flush() override;
+private:
+    void writeBlock();
+    std::ofstream file;
+    size_t blockRows;
+    size_t rows = 0;
+    int32_t baseTime = 0;
+    int32_t lastTime = 0;
+    std::vector<uint16_t> timeDelta;
+    std::vector<float> floatColumns[9];
+    std::vector<uint16_t> zoneColumn;
+    std::vector<uint16_t> soilColumn;
+    std::vector<uint8_t> flagColumn;
+};
+
+class BinaryLogReader {
+public:
+    bool open(const std::string& filename);
+    // Reads the next block into rows (replacing its contents). Returns false at end of file.
+    bool readBlock(std::vector<LogRecord>& rows);
+    const std::vector<std::string>& names() const { return dictionary; }
+    bool hasError() const { return error; }
+private:
+    std::ifstream file;
+    std::vector<std::string> dictionary;
+    std::vector<float> scratch;
+    bool error = false;
+};
+
+#endif // BINARYLOG_H
@@ -0,0 +1,95 @@
+#ifndef CALIBRATION_H
+#define CALIBRATION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <string>
+#include <vector>
+
+class ZoneScheduler;
+
+// The soil and plant parameters a calibration fits, in config.yaml's units
+struct SoilPlantParams {
+    float soilRetentionRate = 0.8f;
+    float soilDrainageFactor = 0.2f;
+    float plantAbsorptionRate = 0.05f;
+};
+
+/*
+ * An observed bed, one entry per logged step, stored as struct-of-arrays so the kernel streams through it.
+ * evapotranspiration and water are the forcing GardenZone applies in that step. water is rain plus the
+ * pump's flow / 60 while the pump was on. moisture and stress were measured after the step. Rows flagged
+ * SensorError are dropped: the models saw -999 readings there, not the logged fallbacks, so the forcing is
+ * unknown. The replay restarts at the next trustworthy row, which becomes an anchor.
+ */
+struct ObservedSeries {
+    struct Anchor {
+        size_t index;   // The replay restarts before this step...
+        float moisture; // ...from this state
+        float stress;
+    };
+    std::vector<float> evapotranspiration;
+    std::vector<float> water;
+    std::vector<float> moisture;
+    std::vector<float> stress;
+    std::vector<Anchor> anchors; // Ascending; the first is at index 0
+    size_t stressedRows = 0;     // Rows with PlantStress above 0
+    size_t size() const { return water.size(); }
+    void add(float evapotranspiration, float water, float moisture, float stress);
+    void anchor(float moisture, float stress);
+};
+
+// Reads one zone of a CSV log in output.csv's layout, finding columns by header name. SoilMoisture,
+// Temperature, Humidity and Rainfall are required. PumpState/FlowRate, PlantStress, SensorError and
+// ZoneID are optional. With an empty zone, the first zone in the log is read.
+bool loadObservedSeries(std::istream& csv, const std::string& zone, ObservedSeries& series, std::string& error);
+
+struct FitError {
+    double moistureSquared = 0.0; // Sums over the steps
+    double stressSquared = 0.0;
+    uint32_t rows = 0;
+};
+
+// Replays the series through Soil::update and Plant::update, fused into one loop with the same float
+// operations, and scores it against the measurements. Allocation-free, with no branches besides the clamps.
+// With segmentSteps, the replay also restarts from the measurement every segmentSteps steps, so logging
+// round-off and unlogged disturbances do not accumulate over a long series. 0 restarts only at anchors.
+FitError evaluateFit(const ObservedSeries& series, const SoilPlantParams& params, float waterNeedPerDay,
+                     size_t segmentSteps = 0);
+
+// evaluateFit for count parameter sets, four at a time across SSE2 lanes (scalar without SSE2 and for the
+// tail). The replay is serial in time, so lanes are what make a step cheaper. Results match evaluateFit.
+void evaluateFitBatch(const ObservedSeries& series, const SoilPlantParams* params, size_t count,
+                      float waterNeedPerDay, size_t segmentSteps, FitError* out);
+
+struct CalibrationOptions {
+    float waterNeedPerDay = 10.0f; // plant_water_need_per_day (not fitted)
+    float stressWeight = 1.0f;     // Weight of a squared stress error against a squared moisture error
+    size_t segmentSteps = 3600;    // Replay length between re-anchors to the measurements, 0 for none
+    int gridPoints = 12;           // Per fitted parameter and round
+    int rounds = 4;                // Each round after the first zooms the grid in around the best point
+    int polishStarts = 4;          // Nelder-Mead runs, in parallel, from the best distinct grid points
+    int polishIterations = 200;    // Per run
+    float minStressedShare = 0.05f; // Share of rows with stress above 0 needed to fit plant_absorption_rate
+    SoilPlantParams initial;       // plant_absorption_rate stays here if too few rows are stressed to fit it
+};
+
+struct CalibrationResult {
+    SoilPlantParams params;
+    double loss = 0.0;          // (moisture SSE + stressWeight * stress SSE) / steps
+    double moistureRmse = 0.0;  // %
+    double stressRmse = 0.0;    // %
+    bool fittedAbsorption = false;
+    uint64_t evaluations = 0;
+};
+
+/*
+ * Fits the parameters by grid search and refinement. Each round evaluates gridPoints^d candidates
+ * (d = 2 or 3 fitted parameters) on the scheduler's threads. The next round's grid spans two cells on
+ * either side of the best candidate so far. Nelder-Mead then polishes the best distinct points, one run
+ * per worker. Every parameter stays in [0, 1]. Results do not depend on the thread count.
+ */
+CalibrationResult calibrate(const ObservedSeries& series, const CalibrationOptions& options, ZoneScheduler& scheduler);
+
+#endif // CALIBRATION_H
@@ -0,0 +1,47 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include "ZoneSimulation.h"
+#include "GardenZone.h"
+#include "Logger.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+/*
+ * Whole-run snapshot of a tick-engine simulation: the loop position, the params it was built
+ * with, the shared pump budget, the logger's summary accumulators and each zone's state
+ * (Soil, Plant, WaterPump timers, WeatherSensor, IrrigationController histories and last-known
+ * values, failure timers). RNG streams are counter-based, so (seed, zone, tick) is their whole
+ * state and is covered by params.seed and the loop position.
+ *
+ * File (.mckp): "MYSACKP\0" magic, uint32 version, the params, the loop position and budget,
+ * the logger state, then per zone its ID, soil type and state. Zone and logger states are kept
+ * as encoded blobs, so one loaded checkpoint can seed any number of forks: each fork builds
+ * its zone from its own (what-if) params and restores the blob into it.
+ * The weather trace pointer is not saved; re-attach the trace before building zones.
+ */
+struct Checkpoint {
+    SimulationParams params;
+    int64_t nextStep = 0;        // Index of the first step still to run
+    float secondsElapsed = 0.0f; // Simulation time of that step
+    int activePumps = 0;
+    int maxPumps = 2;
+    std::vector<std::string> zoneIds;
+    std::vector<std::string> soilTypes;
+    std::string loggerState;
+    std::vector<std::string> zoneStates;
+};
+
+Checkpoint captureCheckpoint(const SimulationParams& params, int64_t nextStep, float secondsElapsed,
+                             const std::vector<std::unique_ptr<ZoneSimulation>>& zones, const PumpBudget& budget,
+                             const Logger& logger);
+bool saveCheckpoint(const std::string& path, const Checkpoint& checkpoint);
+// Returns false and sets error if the file cannot be read, is not a checkpoint or is corrupt (no zones)
+bool loadCheckpoint(const std::string& path, Checkpoint& checkpoint, std::string& error);
+// Restore one zone (built with the same zone index) or the logger; false if the stored state is corrupt
+bool restoreZone(const Checkpoint& checkpoint, size_t zone, ZoneSimulation& sim);
+bool restoreLogger(const Checkpoint& checkpoint, Logger& logger);
+
+#endif // CHECKPOINT_H
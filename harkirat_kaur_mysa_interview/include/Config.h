@@ -0,0 +1,105 @@
+#ifndef CONFIG_H
+#define CONFIG_H
+
+#include "ZoneSimulation.h"
+#include <atomic>
+#include <cstdint>
+#include <istream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*
+ * Typed config.yaml schema. Each key maps to one SimulationParams field with its type, the
+ * accepted range, whether the file must set it and whether it can change while a run is live.
+ * Values may carry a trailing "# comment"; anything else after the value is an error.
+ */
+struct ConfigField {
+    const char* key;
+    float SimulationParams::*floatField; // Exactly one of the three is set
+    int SimulationParams::*intField;
+    bool SimulationParams::*boolField;
+    float min;
+    float max;
+    bool required;
+    bool reloadable; // Thresholds, water cost and controller features; physics, step and seed need a restart
+};
+
+// Schema entry for a key, nullptr if the key is not a simulation parameter
+const ConfigField* findConfigField(const std::string& key);
+
+enum class ConfigStatus { Ok, CannotOpen, MissingField, InvalidValue };
+
+// Contents of config.yaml, validated once when built
+struct Config {
+    SimulationParams params;
+    int simulationDuration = 0;    // simulation_duration; 0 or less means one day
+    std::vector<std::string> keys; // Keys the file set, in file order
+    bool has(const std::string& key) const;
+};
+
+// Error text names the file or line and the key; unknown keys are skipped (main.cpp has its own)
+ConfigStatus loadConfig(const std::string& path, Config& config, std::string& error);
+ConfigStatus parseConfig(std::istream& in, Config& config, std::string& error);
+// Sets the field for a config.yaml key from its value text, with parseConfig's parse and range check.
+// False with error naming the key and the accepted values if the key is unknown or the value is not valid.
+bool setSimulationParam(SimulationParams& params, const std::string& key, const std::string& value, std::string& error);
+// Copies the reloadable fields; returns true if any of them differed
+bool applyReloadable(const SimulationParams& from, SimulationParams& to);
+
+// One published config; immutable once published
+struct ConfigVersion {
+    uint64_t version;
+    SimulationParams params;
+};
+
+/*
+ * RCU-style publication of live config. The writer builds a new immutable version and swaps it
+ * in with a release store; readers (zone threads, once per step) take the current version with
+ * one acquire load, no lock and no reference count. Superseded versions are kept until the
+ * channel is destroyed, so a reader never holds a freed version; reloads are rare and each
+ * version is one SimulationParams.
+ */
+class ConfigChannel {
+public:
+    explicit ConfigChannel(const SimulationParams& initial);
+    ConfigChannel(const ConfigChannel&) = delete;
+    ConfigChannel& operator=(const ConfigChannel&) = delete;
+    const ConfigVersion* current() const { return head.load(std::memory_order_acquire); }
+    // Writer side (one writer at a time); returns the new version number
+    uint64_t publish(const SimulationParams& params);
+private:
+    std::vector<std::unique_ptr<ConfigVersion>> versions;
+    std::atomic<const ConfigVersion*> head;
+};
+
+/*
+ * Watches config.yaml on a background thread and publishes every edit that parses and
+ * changes a reloadable field. Linux uses inotify on the file's directory, so editors that save
+ * by renaming a temporary file are seen too; elsewhere the file's mtime is polled twice a second.
+ * Rejected edits, and edits of fields that need a restart, are reported on stderr; the running
+ * config keeps its previous values for them.
+ */
+class ConfigWatcher {
+public:
+    ConfigWatcher(const std::string& path, ConfigChannel& channel);
+    ~ConfigWatcher();
+    ConfigWatcher(const ConfigWatcher&) = delete;
+    ConfigWatcher& operator=(const ConfigWatcher&) = delete;
+    bool start(std::string& error);
+    void stop();
+    bool reload(); // Parse the file now and publish if a reloadable field changed
+    uint64_t getRejectedCount() const { return rejected.load(); }
+private:
+    void run();
+    std::string path;
+    ConfigChannel& channel;
+    std::thread thread;
+    std::atomic<bool> stopping{false};
+    std::atomic<uint64_t> rejected{0};
+    Config lastFile; // Last valid contents, to spot edits of fields that need a restart
+    int watchFd = -1;
+};
+
+#endif // CONFIG_H
@@ -0,0 +1,52 @@
+#ifndef COUNTERRNG_H
+#define COUNTERRNG_H
+
+#include <cstdint>
+
+/*
+ * Counter-based random numbers (SplitMix64 mixing). A draw is a pure function of
+ * (seed, zone, stream, tick, index): there is no hidden state to share, so zones and
+ * threads draw without contention, skipping ticks does not shift later draws, and the
+ * same seed always reproduces the same run.
+ */
+class CounterRng {
+public:
+    // Independent streams per consumer so the sensor and controller never reuse numbers
+    enum Stream : uint32_t {
+        WeatherStream = 1,
+        ForecastStream = 2,
+        ControllerStream = 3,
+        DisplayStream = 4,
+        SweepStream = 5   // Random sweep ranges (ParameterSweep)
+    };
+    CounterRng();  // Seeded from the clock, like the old srand(time(nullptr))
+    CounterRng(uint64_t seed, uint32_t zone = 0, uint32_t stream = 0);
+    CounterRng withStream(uint32_t stream) const { return CounterRng(seed, zone, stream); }
+    // 32 random bits for draw number `index` within `tick`
+    uint32_t draw(uint64_t tick, uint32_t index = 0) const {
+        return static_cast<uint32_t>(mix(mix(counter(tick)) + index) >> 32);
+    }
+    // Pre-mix counter of `tick`, for batched draws (WeatherBatch): draw() is mix(mix(counter) + index) >> 32
+    uint64_t counter(uint64_t tick) const { return key + tick * kGamma; }
+    // Integer in [0, n), replacing std::rand() % n
+    int drawInt(uint64_t tick, uint32_t index, int n) const {
+        return static_cast<int>(draw(tick, index) % static_cast<uint32_t>(n));
+    }
+    uint64_t getSeed() const { return seed; }
+    uint32_t getZone() const { return zone; }
+    static const uint64_t kGamma = 0x9E3779B97F4A7C15ULL;
+    static uint64_t mix(uint64_t x) {
+        x += kGamma;
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+        return x ^ (x >> 31);
+    }
+    static uint64_t timeSeed();
+private:
+    uint64_t seed;
+    uint32_t zone;
+    uint32_t stream;
+    uint64_t key;
+};
+
+#endif // COUNTERRNG_H
@@ -0,0 +1,51 @@
+#ifndef DEADLINESCHEDULER_H
+#define DEADLINESCHEDULER_H
+
+#include <cstdint>
+#include <ostream>
+
+// What happens when a step's work runs past the next period's deadline
+enum class OverrunPolicy {
+    CatchUp, // Keep the original grid: late periods start at once until the loop is back on time
+    Realign  // Start a new grid from now: no burst of back-to-back steps, the lost time is not made up
+};
+
+/*
+ * Paces the real-time loop on absolute deadlines: period k starts at start + k * period, so the
+ * time spent on a step never adds up into drift. Linux sleeps with clock_nanosleep(CLOCK_MONOTONIC,
+ * TIMER_ABSTIME); elsewhere std::this_thread::sleep_until on the steady clock. Every period's
+ * lateness (wake-up time minus deadline, or how far the work overran it) goes into a histogram.
+ * nowNs and sleepUntil are virtual so tests can drive the grid from a simulated clock.
+ */
+class DeadlineScheduler {
+public:
+    static const int kJitterBuckets = 8;
+    DeadlineScheduler(double periodSeconds, OverrunPolicy policy = OverrunPolicy::CatchUp);
+    virtual ~DeadlineScheduler() {}
+    void start(); // The first deadline is one period from now
+    // Blocks until the next deadline; false if it had already passed (an overrun)
+    bool waitForNextPeriod();
+    uint64_t getPeriods() const { return periods; }
+    uint64_t getOverruns() const { return overruns; }
+    uint64_t getRealignments() const { return realignments; }
+    double getMaxLatenessMs() const { return maxLatenessNs / 1e6; }
+    // Upper edge of the histogram bucket holding the p-th lateness (p in [0, 1]); the max for the last bucket
+    double latenessPercentileMs(double p) const;
+    uint64_t getBucketCount(int bucket) const { return histogram[bucket]; } // Edges: 0.05, 0.1, 0.5, 1, 5, 10, 100 ms
+    void printJitter(std::ostream& out) const; // One summary line: "<0.05ms 120 | <0.1ms 3 | ..."
+protected:
+    virtual int64_t nowNs() const;                // Monotonic time in ns
+    virtual void sleepUntil(int64_t deadlineNs);  // Returns at or after the deadline
+private:
+    void recordLateness(int64_t ns);
+    int64_t periodNs;
+    OverrunPolicy policy;
+    int64_t nextDeadlineNs = 0;
+    uint64_t periods = 0;
+    uint64_t overruns = 0;
+    uint64_t realignments = 0;
+    int64_t maxLatenessNs = 0;
+    uint64_t histogram[kJitterBuckets] = {};
+};
+
+#endif // DEADLINESCHEDULER_H
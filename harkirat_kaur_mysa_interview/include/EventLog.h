@@ -0,0 +1,61 @@
+#ifndef EVENTLOG_H
+#define EVENTLOG_H
+
+#include "ZoneSimulation.h"
+#include "LogSink.h"
+#include <cstdint>
+#include <fstream>
+#include <istream>
+#include <string>
+#include <vector>
+
+/*
+ * Change-only event log (.mevt), one comma-separated line per entry. Steps are simulation step
+ * numbers (time_s = step * simulation_step); zones are numbered in declaration order.
+ *
+ *   # mysa-events v1
+ *   Z,zone,zoneId,soilType,flowRate,powerWatts,simulationStep     zone declaration
+ *   K,step,zone,pump,weatherFailed,soilFailed,conservation,
+ *     soilMoisture,effectiveMoisture,temperature,humidity,rainfall,plantStress   keyframe
+ *   P,step,zone,0|1,reason       pump turned off/on (reason: pumpReasonName)
+ *   S,step,zone,weather|soil,0|1 sensor failure reset/start (first step with the new state)
+ *   C,step,zone,0|1              conservation mode left/entered
+ *   E,steps                      end of the log (number of steps simulated)
+ *
+ * Keyframes are written every keyframeInterval steps and on every step with an event, so the
+ * discrete state (pump, sensor errors, water and power used) of every step is exact and the
+ * continuous values are interpolated linearly between the surrounding keyframes.
+ */
+class EventLogWriter {
+public:
+    explicit EventLogWriter(const std::string& filename, int keyframeInterval = 300);
+    ~EventLogWriter();
+    bool isOpen() const { return static_cast<bool>(file); }
+    // Zones must be declared before their first record; the zone number is the declaration order
+    void declareZone(const std::string& zoneId, const std::string& soilType, float flowRate, float powerWatts,
+                     float simulationStep);
+    void record(size_t zone, int64_t step, const ZoneStepResult& r);
+    void finish(int64_t steps); // Final keyframes and the end marker
+    int64_t getEventCount() const { return events; }
+    int64_t getKeyframeCount() const { return keyframes; }
+private:
+    struct ZoneState {
+        bool started = false;
+        int64_t lastKeyframe = 0;
+        int64_t lastStep = 0;
+        ZoneStepResult last;
+    };
+    void writeKeyframe(size_t zone, int64_t step, const ZoneStepResult& r);
+    std::ofstream file;
+    int keyframeInterval;
+    std::vector<ZoneState> zones;
+    int64_t events = 0;
+    int64_t keyframes = 0;
+    bool finished = false;
+};
+
+// Rebuilds the per-step series of an event log into sink (in step order, zones in declaration
+// order). Returns false and sets error (with the line number) if the log is malformed.
+bool expandEventLog(std::istream& in, LogSink& sink, std::string& error);
+
+#endif // EVENTLOG_H
@@ -0,0 +1,110 @@
+#ifndef EVENTSIMULATION_H
+#define EVENTSIMULATION_H
+
+#include "ZoneSimulation.h"
+#include "RollingWindow.h"
+#include "WaterPump.h"
+#include "Logger.h"
+#include "CounterRng.h"
+#include <cstdint>
+#include <string>
+
+// How much of an event-driven run was stepped tick by tick
+struct EventRunStats {
+    int64_t exactTicks = 0;   // Ticks run one at a time (an event could happen on them)
+    int64_t skippedTicks = 0; // Ticks advanced in closed form
+    int64_t spans = 0;        // Closed-form jumps
+};
+
+/*
+ * Next-event simulation of one zone. It applies ZoneSimulation's rules (WaterPump timers,
+ * IrrigationController decisions, GardenZone pump permits, Soil and Plant updates) to the
+ * expected weather: the daily temperature/humidity curve without noise and the mean rainfall
+ * (10% x 2.75 mm per second), held constant over segments of weatherResolution seconds. With
+ * params.weatherTrace the segments take the trace's weather and mean rain rate instead.
+ *
+ * Ticks where a discrete decision can change are run exactly and logged as rows: pump
+ * max-runtime expiry, cooldown end, hourly history samples (which also cover conservation
+ * night-window boundaries), moisture crossing the watering or drought threshold, weather segment changes
+ * and the forced start. Between them the pump state is steady, moisture moves linearly
+ * (clamped to 0-100) and plant stress follows closed-form sums, so a multi-day run takes a few
+ * exact ticks per simulated hour. Weather sensor failures are replayed from the zone's
+ * CounterRng, so they start on the same ticks as in ZoneSimulation; finding the next one
+ * costs one hash per healthy tick, and each failure episode is stepped exactly. While the pump
+ * runs, the heavy-rain readings (over 2 mm) that stop it are replayed the same way. The rain
+ * forecast is WeatherSensor's hourly forecast, recomputed from the same keyed draws.
+ * Requires a 1 s simulation step.
+ */
+class EventSimulation {
+public:
+    EventSimulation(const SimulationParams& params, uint32_t zoneIndex = 0, const std::string& zoneId = "Zone1",
+                    const std::string& soilType = "Loam");
+    void setWeatherResolution(int seconds);
+    void setSkipping(bool enabled); // false steps every tick exactly (reference for the closed form)
+    // Simulates ticks [0, durationSeconds) into logger's summary
+    EventRunStats run(int durationSeconds, Logger& logger);
+    float getSoilMoisture() const { return moisture; }
+    float getPlantStress() const { return stress; }
+    bool isPumpOn() const { return pump.isOn(); }
+private:
+    struct Weather {
+        float temperature;
+        float humidity;
+        float rainfall;
+    };
+    enum Decision { Forced, Delayed, Water, Idle };
+    // Discrete state after a tick; two equal consecutive states mean the next ticks repeat them
+    struct TickState {
+        bool pumpOn;
+        int runTime;
+        int cooldownLeft;
+        int permits;
+        Decision decision;
+        bool wantsWater;
+        bool forecastRain;
+        bool sensorFailed;
+    };
+    Weather expectedWeather(int t) const;
+    static float evapotranspiration(const Weather& w);
+    float wateringThreshold() const;
+    bool wantsWater(float soilMoisture, float effective, int t) const;
+    void exactTick(int t, Logger& logger);
+    bool isSteady() const;
+    int nextEvent(int t, int end) const;
+    void skipTicks(int first, int count, Logger& logger);
+    float moistureDelta() const;
+    int findFailure(int from, int end) const;
+    int findHeavyRain(int from, int end) const; // First tick in [from, end) reading over 2 mm, end if none
+    float rainForecast(int hour);
+
+    SimulationParams params;
+    std::string zoneId;
+    std::string soilType;
+    int weatherResolution = 600;
+    bool skipping = true;
+    CounterRng weatherRng;  // WeatherSensor's stream: failures and heavy-rain readings fall on the same ticks
+    CounterRng forecastRng; // WeatherSensor's forecast stream: the same hourly forecast
+    int failureStart = -1;  // First tick of the current failure, -1 while the sensor works
+    int nextFailure = 0;
+    int failureEnd = 0;     // Failures are searched for up to the end of the run
+    Weather weather;        // Last good weather, as the controller sees it (fallback while failed)
+    float moisture = 0.0f;  // Soil
+    float stress = 0.0f;    // Plant
+    WaterPump pump;
+    int permits = 0;        // This zone's view of the GardenZone pump budget
+    int maxPermits;
+    // IrrigationController state and defaults
+    RollingWindow rainfallHistory{72};
+    RollingWindow moistureHistory{72};
+    int rainForecastHours = 6;
+    float rainForecastThreshold = 2.0f;
+    int forecastHour = -1;  // Hour `forecast` was issued for
+    float forecast = 0.0f;
+    float trendSlopeThreshold = 0.5f;
+    float trendAdjustment = 2.5f;
+    TickState state;
+    TickState previous;
+    bool havePrevious = false;
+};
+
+#endif // EVENTSIMULATION_H
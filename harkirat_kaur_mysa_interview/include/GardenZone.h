@@ -5,15 +5,40 @@
 #include "Soil.h"
 #include "WeatherSensor.h"
 #include "WaterPump.h"
+#include <atomic>
+
+// Limit on concurrently running pumps shared by a set of zones (lock-free so zones can update on several threads)
+class PumpBudget {
+public:
+    explicit PumpBudget(int maxActive = 2) : active(0), maxActive(maxActive) {}
+    void setMax(int max) { maxActive.store(max); }
+    int getMax() const { return maxActive.load(); }
+    int getActive() const { return active.load(); }
+    bool canActivate() const { return active.load() < maxActive.load(); }
+    bool tryAcquire(); // Atomically takes a permit if one is free
+    void increment() { active.fetch_add(1); }
+    void setActive(int count) { active.store(count); } // Restoring a checkpoint
+    void release();
+private:
+    std::atomic<int> active;
+    std::atomic<int> maxActive;
+};
 
 class GardenZone {
 public:
-    GardenZone(Plant* plant, Soil* soil, WeatherSensor* weather, WaterPump* pump);
+    // Zones without a budget of their own share the site-wide one
+    GardenZone(Plant* plant, Soil* soil, WeatherSensor* weather, WaterPump* pump, PumpBudget* budget = nullptr);
     void update(int secondsElapsed);
-    // Multi-zone coordination
+    // Call after the controller, with the pump state from before it: a pump that just started takes a permit
+    // (or is stopped again if none is free), and one that just stopped returns its permit. false: start refused
+    bool settlePumpPermit(bool wasOn);
+    // Multi-zone coordination (site-wide pump budget)
+    static PumpBudget& siteBudget();
     static void setMaxConcurrentPumps(int max);
     static int getActivePumpCount();
+    static int getMaxConcurrentPumps();
     static bool canActivatePump();
+    static bool tryAcquirePump(); // Atomically takes a permit if one is free
     static void incrementActivePumps();
     static void decrementActivePumps();
 private:
@@ -21,8 +46,7 @@ private:
     Soil* soil;
     WeatherSensor* weather;
     WaterPump* pump;
-    static int activePumpCount;
-    static int maxConcurrentPumps;
+    PumpBudget* budget;
 };
 
-#endif // GARDENZONE_H 
\ No newline at end of file
+#endif // GARDENZONE_H
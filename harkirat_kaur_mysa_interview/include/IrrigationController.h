@@ -4,19 +4,93 @@
 #include "Soil.h"
 #include "WeatherSensor.h"
 #include "WaterPump.h"
-#include <vector>
+#include "RollingWindow.h"
 #include "Logger.h"
+#include "CounterRng.h"
+#include "IrrigationPlanner.h"
+#include <vector>
+
+// Why the last update() left the pump on or off
+enum class PumpReason : uint8_t {
+    Forced,       // First 5 seconds
+    Dry,          // Effective moisture below the (predictive or conservation) threshold
+    RainForecast, // Forecast rain over the look-ahead exceeds the threshold
+    RainNow,      // setForecastRain(true)
+    PumpLimit,    // Max run time reached or cooling down
+    NightWindow,  // Conservation mode only waters at night
+    MoistureOk,   // Effective moisture at or above the threshold
+    ZoneBudget,   // GardenZone's pump budget overrode the controller, or the zone waits for a PumpArbiter permit
+    Planned       // Following the receding-horizon planner's schedule (setPlannerEnabled)
+};
+const char* pumpReasonName(PumpReason reason);
+
+/*
+ * Decision-pipeline policies. update() runs one instantiation of
+ * decide<Predictive, Forecast, Conservation>(), picked from the enabled features whenever a
+ * feature is switched, so a disabled feature has no per-step cost: no hourly history pushes
+ * or window statistics with FixedThreshold, no forecast lookup with NoForecastDelay and no
+ * drought/cost checks or night-window branching with NoConservation.
+ */
+struct FixedThreshold {
+    static void record(RollingWindow&, RollingWindow&, int, float, float) {}
+    static float threshold(float base, const RollingWindow&, const RollingWindow&, float, float) { return base; }
+};
+
+// Hourly rainfall/moisture history nudges the threshold for dry or wet spells and moisture trends
+struct PredictiveWatering {
+    static void record(RollingWindow& rainfall, RollingWindow& moisture, int secondsElapsed, float recentRain,
+                       float soilMoisture) {
+        if (secondsElapsed % 3600 == 0) {
+            rainfall.push(recentRain);
+            moisture.push(soilMoisture);
+        }
+    }
+    static float threshold(float base, const RollingWindow& rainfall, const RollingWindow& moisture,
+                           float trendSlopeThreshold, float trendAdjustment);
+};
+
+struct NoForecastDelay {
+    static bool delay(const WeatherSensor&, int, float) { return false; }
+};
+
+// Irrigation waits while the forecast rain over the look-ahead exceeds the threshold
+struct ForecastDelay {
+    static bool delay(const WeatherSensor& weather, int hours, float threshold) {
+        return weather.getRainForecast(hours) > threshold;
+    }
+};
+
+struct NoConservation {
+    static bool active(float, float, float, float) { return false; }
+    static bool allowWatering(int, int, int) { return true; }
+};
+
+// Active while water is expensive or the soil is in drought; then only waters inside the night window
+struct NightConservation {
+    static bool active(float soilMoisture, float droughtThreshold, float waterCost, float costThreshold) {
+        return waterCost > costThreshold || soilMoisture < droughtThreshold;
+    }
+    static bool allowWatering(int secondsElapsed, int startHour, int endHour) {
+        int hour = (secondsElapsed / 3600) % 24;
+        return startHour < endHour ? (hour >= startHour && hour < endHour)  // Window within one day
+                                   : (hour >= startHour || hour < endHour); // Window crosses midnight
+    }
+};
 
 class IrrigationController {
 public:
-    IrrigationController(Soil* soil, WeatherSensor* weather, WaterPump* pump, Logger* logger);
+    IrrigationController(Soil* soil, WeatherSensor* weather, WaterPump* pump, Logger* logger,
+                         const CounterRng& rng = CounterRng());
     void setMoistureThreshold(float threshold);
-    void update(int secondsElapsed);
+    void update(int secondsElapsed) { (this->*pipeline)(secondsElapsed); }
     void setForecastRain(bool rainLikely);
     // Set the number of hours to look ahead for rain forecast
     void setRainForecastHours(int hours);
     // Set the rain threshold (mm) above which irrigation is delayed
     void setRainForecastThreshold(float mm);
+    // Feature switches; each one re-picks the decide<> instantiation (all on by default except conservation)
+    void setForecastDelayEnabled(bool enabled);
+    void setPredictiveWateringEnabled(bool enabled);
     // Water conservation mode configuration
     void setConservationModeEnabled(bool enabled);
     void setConservationWaterCostThreshold(float threshold);
@@ -24,9 +98,24 @@ public:
     void setConservationMoistureThreshold(float threshold);
     void setConservationNightWindow(int startHour, int endHour);
     void setCurrentWaterCost(float cost);
+    // Receding-horizon planner instead of the threshold rule. The predictive, forecast-delay and conservation
+    // switches do not apply while it is enabled; the first 5 seconds are still forced.
+    void setPlannerEnabled(bool enabled);
+    // Model and horizon the planner optimises (pump limits included); a change re-plans at the next stage
+    void setPlannerModel(const PlannerModel& model);
+    const IrrigationPlanner& getPlanner() const { return planner; }
+    // Priority pump arbitration: without a permit the controller records its wish (ZoneBudget) instead of starting the pump
+    void setPumpPermit(bool permitted) { pumpPermit = permitted; }
     // Predictive watering configuration
     void setHistoryWindowDays(int days);
+    // Moisture trend (%/hour) beyond which the threshold is nudged; 0 disables the trend check
+    void setTrendSlopeThreshold(float percentPerHour);
     // Getters for last known sensor values (for fallback display)
+    PumpReason getLastReason() const { return lastReason; }
+    bool isConservationActive() const { return conservationActive; } // As of the last update()
+    // Checkpoint state: histories, last-known sensor values and the last decision
+    void save(SnapshotWriter& out) const;
+    void restore(SnapshotReader& in);
     float getLastKnownSoilMoisture() const { return lastKnownSoilMoisture; }
     float getLastKnownTemperature() const { return lastKnownTemperature; }
     float getLastKnownHumidity() const { return lastKnownHumidity; }
@@ -38,7 +127,18 @@ private:
     Logger* logger = nullptr; // For logging sensor failures
     float moistureThreshold;
     bool forecastRain;
+    bool pumpPermit = true;
     float getNoisyMoisture() const;
+    template <class Predictive, class Forecast, class Conservation>
+    void decide(int secondsElapsed);
+    void decidePlanned(int secondsElapsed);
+    void readSensors(float& soilMoisture, float& temp, float& humidity, float& recentRain); // With fallbacks
+    void selectPipeline();
+    void (IrrigationController::*pipeline)(int);
+    bool forecastDelayEnabled = true;
+    bool predictiveWateringEnabled = true;
+    CounterRng rng;   // Sensor noise, keyed by (seed, zone, tick)
+    int lastTick = 0; // secondsElapsed of the last update
     int rainForecastHours = 6; // Number of hours to look ahead for rain forecast
     float rainForecastThreshold = 2.0f; // Rainfall threshold (mm) to delay irrigation
     // Water conservation mode state/config
@@ -49,11 +149,26 @@ private:
     int conservationNightStartHour = 22;
     int conservationNightEndHour = 6;
     float currentWaterCost = 0.1f;
-    // Predictive watering: store recent rainfall and soil moisture history (per hour)
-    std::vector<float> rainfallHistory;
-    std::vector<float> moistureHistory;
+    bool conservationActive = false;
+    PumpReason lastReason = PumpReason::Forced;
+    // Predictive watering: hourly rainfall and soil moisture history with running sums
+    RollingWindow rainfallHistory{72};
+    RollingWindow moistureHistory{72};
     int historyWindowDays = 3;
     int historyWindowHours = 72; // 3 days * 24 hours
+    float trendSlopeThreshold = 0.5f; // %/hour
+    float trendAdjustment = 2.5f;     // Threshold change (%) for a falling/rising moisture trend
+    // Receding-horizon planner: re-plans in the first stage of every hour; a run is decided at each stage start
+    bool plannerEnabled = false;
+    PlannerModel plannerModel;
+    IrrigationPlanner planner;
+    std::vector<PlannerStageInput> plannerInputs;
+    int64_t planStage = -1; // First stage of the plan in force (-1: none)
+    int64_t runStage = -1;  // Stage of the current run decision
+    int64_t runStart = 0;   // Tick it was made at
+    int runTicks = 0;       // Updates to pump from runStart
+    int64_t firstPlanStage(int64_t stage) const;
+    void replan(int64_t first);
     // Last known sensor values for fallback
     float lastKnownSoilMoisture = 50.0f;
     float lastKnownTemperature = 20.0f;
@@ -0,0 +1,95 @@
+#ifndef IRRIGATIONPLANNER_H
+#define IRRIGATIONPLANNER_H
+
+#include <cstdint>
+#include <vector>
+
+// Zone constants the planner's moisture model is built from; ticks are controller updates (simulation_step each)
+struct PlannerModel {
+    float retentionRate = 0.8f;      // Soil
+    float drainageFactor = 0.2f;
+    float irrigationPerTick = 0.1f;  // Pump flow (L/min) / 60, as GardenZone adds it per update
+    int maxRunTicks = 600;           // WaterPump limits, in updates
+    int cooldownTicks = 300;
+    float tickSeconds = 1.0f;
+    float moistureThreshold = 40.0f; // Moisture below which the plant counts as under-watered
+    float waterCost = 0.1f;          // Per litre; the pump delivers irrigationPerTick * tickSeconds L per update
+    float stressPenalty = 1.0f;      // Per %·hour of moisture below the threshold
+    int horizonTicks = 43200;
+    bool operator==(const PlannerModel& o) const;
+    bool operator!=(const PlannerModel& o) const { return !(*this == o); }
+};
+
+// Expected weather of one stage, per update: rain (mm) and the evapotranspiration estimate GardenZone uses
+struct PlannerStageInput {
+    float rain = 0.0f;
+    float evapotranspiration = 0.0f;
+};
+
+struct PlannerStats {
+    uint64_t plans = 0;
+    uint64_t tablesBuilt = 0;  // Stage transition tables computed
+    uint64_t tablesReused = 0; // Stage tables kept from an earlier plan (unchanged inputs)
+};
+
+/*
+ * Receding-horizon pump schedule by dynamic programming over discretised soil moisture.
+ *
+ * Time is cut into stages of maxRunTicks + cooldownTicks updates (longer if the horizon would need more
+ * than kMaxStages), numbered from tick 0. In each stage the pump may run for 0, 1/4, 1/2, 3/4 or all of
+ * maxRunTicks from the start of the stage and then rests, so every schedule respects the pump's run and
+ * cooldown limits. Within a phase, Soil::update is linear in time (rain and irrigation retained, the
+ * evapotranspiration not drained lost) until moisture clamps at 0 or 100, so each transition is exact.
+ * A stage costs waterCost per litre pumped plus stressPenalty per %·hour spent below the threshold.
+ *
+ * plan() computes the cost-to-go of every moisture cell (0..100 % in 1 % steps, interpolated between
+ * cells) for each stage of the horizon. Transition tables are kept per absolute stage: a re-plan reuses
+ * the table of every stage whose inputs are bit-identical to the last plan's (the overlap of consecutive
+ * hourly plans), so it only builds the newly reached stages before the backward sweep. Results do not
+ * depend on what was reused. Memory is fixed by configure(); plan() and decide() do not allocate.
+ */
+class IrrigationPlanner {
+public:
+    static const int kCells = 101;
+    static const int kActions = 5;
+    static const int kMaxStages = 192;
+    // Sizes the stages and buffers for a model; a changed model drops every cached table
+    void configure(const PlannerModel& model);
+    const PlannerModel& getModel() const { return model; }
+    int getStageTicks() const { return stageTicks; }
+    int getStageCount() const { return stageCount; } // Stages in one plan
+    // Solves stages first .. first + getStageCount() - 1; inputs holds one entry per stage
+    void plan(int64_t first, const PlannerStageInput* inputs);
+    bool covers(int64_t stage) const { return planned && stage >= firstStage && stage < firstStage + stageCount; }
+    // Updates to run the pump from now, `elapsed` updates into a covered stage, at `moisture` (%). The
+    // rest of the stage must still fit the cooldown; canStart false allows only 0 (pump cooling down).
+    int decide(int64_t stage, int elapsed, float moisture, bool canStart) const;
+    // Expected cost of the plan from `moisture` at the start of the first stage
+    float expectedCost(float moisture) const;
+    const PlannerStats& getStats() const { return stats; }
+    // Moisture after `ticks` updates at `rate` %/update, clamped at 0 and 100; adds %·updates below threshold to deficit
+    static float advance(float moisture, float rate, int ticks, float threshold, float& deficit);
+private:
+    struct StageTable {
+        int64_t stage = -1;
+        PlannerStageInput input;
+        float next[kActions][kCells]; // Moisture at the end of the stage
+        float cost[kActions][kCells];
+    };
+    PlannerModel model;
+    bool configured = false;
+    bool planned = false;
+    int stageTicks = 0;
+    int stageCount = 0;
+    int runTicks[kActions] = {};
+    int64_t firstStage = 0;
+    std::vector<StageTable> tables; // Ring indexed by absolute stage
+    std::vector<float> value;       // (stageCount + 1) rows of kCells: cost-to-go at each stage start
+    PlannerStats stats;
+    float runCost(int ticks) const;
+    float stageCost(const PlannerStageInput& input, float moisture, int run, int length, float& next) const;
+    void buildTable(StageTable& table, int64_t stage, const PlannerStageInput& input);
+    static float interpolate(const float* row, float moisture);
+};
+
+#endif // IRRIGATIONPLANNER_H
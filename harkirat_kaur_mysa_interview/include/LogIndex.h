@@ -0,0 +1,145 @@
+#ifndef LOGINDEX_H
+#define LOGINDEX_H
+
+#include "LogSink.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <string>
+#include <vector>
+
+/*
+ * Sparse block index of a CSV log (output.csv.idx), little-endian:
+ *
+ *   header : "MYSAIDX\0" magic, uint32 version, uint32 blockRows, uint32 flags (bit0: block times ascend),
+ *            uint64 coveredBytes (log bytes the blocks describe), uint32 nameCount, uint32 blockCount
+ *   names  : uint16 length, bytes                 (dictionary IDs as in LogRecord)
+ *   blocks : uint64 offset, uint64 length, uint32 rows, int32 minTime, int32 maxTime,
+ *            float minMoisture, maxMoisture, minStress, maxStress,
+ *            uint64 zones, uint64 pumpZones       (bit per zone ID that has a row / a row with the pump on)
+ *
+ * A block covers blockRows consecutive rows. Zone IDs from 63 up share bit 63, so a mask test can give a
+ * false "maybe" but never a false "no". Summaries are of the values before they are rounded to one decimal.
+ */
+struct LogIndexBlock {
+    uint64_t offset = 0; // Byte offset of the block's first row in the log
+    uint64_t length = 0; // Bytes of rows, ending with a '\n'
+    uint32_t rows = 0;
+    int32_t minTime = 0;
+    int32_t maxTime = 0;
+    float minMoisture = 0.0f;
+    float maxMoisture = 0.0f;
+    float minStress = 0.0f;
+    float maxStress = 0.0f;
+    uint64_t zones = 0;
+    uint64_t pumpZones = 0;
+};
+
+inline uint64_t logIndexZoneBit(uint16_t zoneId) {
+    return uint64_t(1) << (zoneId < 63 ? zoneId : 63);
+}
+
+// Collects block summaries as CsvLogSink writes rows; flush() rewrites the index file, the open block included
+class LogIndexWriter {
+public:
+    LogIndexWriter(const std::string& filename, uint32_t blockRows = 4096);
+    bool isOpen() const { return open; } // The index file could be created
+    void defineName(uint16_t id, const std::string& name);
+    void add(const LogRecord& record, uint64_t offset, uint32_t length);
+    bool flush();
+    size_t getBlockCount() const { return blocks.size() + (current.rows > 0 ? 1 : 0); }
+private:
+    std::string filename;
+    uint32_t blockRows;
+    bool open = false;
+    bool ascending = true; // Every block starts no earlier than the previous block ends
+    std::vector<std::string> names;
+    std::vector<LogIndexBlock> blocks;
+    LogIndexBlock current;
+};
+
+class LogIndex {
+public:
+    bool load(const std::string& filename, std::string& error);
+    const std::vector<LogIndexBlock>& getBlocks() const { return blocks; }
+    const std::vector<std::string>& getNames() const { return names; }
+    uint64_t getCoveredBytes() const { return coveredBytes; }
+    bool isAscending() const { return ascending; }
+    // Mask bit of a zone name (0 if no row of the covered log has it)
+    uint64_t zoneMask(const std::string& zone) const;
+private:
+    std::vector<std::string> names;
+    std::vector<LogIndexBlock> blocks;
+    uint64_t coveredBytes = 0;
+    bool ascending = false;
+};
+
+// Read-only memory map of a whole file
+class MappedFile {
+public:
+    MappedFile() {}
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    bool open(const std::string& filename, std::string& error);
+    void close();
+    const char* data() const { return view; }
+    size_t size() const { return length; }
+private:
+    const char* view = nullptr;
+    size_t length = 0;
+#ifdef _WIN32
+    void* fileHandle = nullptr;
+    void* mappingHandle = nullptr;
+#endif
+};
+
+// The columns of one output.csv row a query can test
+struct LogRow {
+    int64_t time = 0; // Simulation second (Timestamp minus 2025-07-01 00:00:00)
+    float moisture = 0.0f;
+    float stress = 0.0f;
+    bool pumpOn = false;
+    const char* zone = nullptr; // Points into the line
+    size_t zoneLength = 0;
+};
+
+bool parseLogRow(const char* line, const char* end, LogRow& row);
+
+// Rows with from <= time < to whose values pass every bound; bounds are strict and compare the logged values
+struct LogQuery {
+    std::string zone; // Empty: every zone
+    int64_t from = std::numeric_limits<int64_t>::min();
+    int64_t to = std::numeric_limits<int64_t>::max();
+    int pump = -1; // 1: on, 0: off, -1: either
+    float moistureAbove = -std::numeric_limits<float>::infinity();
+    float moistureBelow = std::numeric_limits<float>::infinity();
+    float stressAbove = -std::numeric_limits<float>::infinity();
+    float stressBelow = std::numeric_limits<float>::infinity();
+};
+
+bool rowMatches(const LogRow& row, const LogQuery& query);
+// False only if no row of the block can match (zoneMask from LogIndex::zoneMask, ignored without a zone)
+bool blockMayMatch(const LogIndexBlock& block, const LogQuery& query, uint64_t zoneMask);
+
+struct LogQueryStats {
+    uint64_t blocks = 0;        // Blocks in the index
+    uint64_t blocksScanned = 0;
+    uint64_t bytesScanned = 0;  // Indexed blocks plus any tail the index does not cover
+    uint64_t rowsScanned = 0;
+    uint64_t rowsMatched = 0;
+    uint64_t malformedRows = 0;
+};
+
+/*
+ * Calls visit for every matching row of the CSV log data[0, size), in file order. With an index, only the
+ * blocks that may match are parsed (and, when block times ascend, the search starts at the first block that
+ * reaches query.from); rows appended after the index was written are scanned in full. Without one, every
+ * row is scanned. Fails if the index does not describe this log.
+ */
+bool queryLog(const char* data, size_t size, const LogIndex* index, const LogQuery& query,
+              const std::function<void(const LogRow& row, const char* line, size_t length)>& visit,
+              LogQueryStats& stats, std::string& error);
+
+#endif // LOGINDEX_H
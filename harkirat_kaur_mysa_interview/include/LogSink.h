@@ -0,0 +1,64 @@
+#ifndef LOGSINK_H
+#define LOGSINK_H
+
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+// One logged simulation step. Zone ID and soil type are dictionary-encoded:
+// the Logger assigns each distinct string a small ID and announces it to the
+// sink once via defineName() before the first record that uses it.
+struct LogRecord {
+    int32_t time_s;
+    float soil_moisture;
+    float effective_moisture;
+    float temp;
+    float humidity;
+    float rain;
+    float flow_rate;
+    float water_used;
+    float plant_stress;
+    float power_used;
+    uint16_t zone_id;
+    uint16_t soil_type;
+    bool pump_on;
+    bool sensor_error;
+};
+
+// Destination for per-step records (CSV text, binary columnar, ...)
+class LogSink {
+public:
+    virtual ~LogSink() {}
+    virtual void defineName(uint16_t id, const std::string& name) = 0;
+    virtual void write(const LogRecord& record) = 0;
+    virtual void flush() = 0;
+};
+
+class LogIndexWriter;
+
+// Writes the classic output.csv schema
+class CsvLogSink : public LogSink {
+public:
+    explicit CsvLogSink(const std::string& filename);
+    explicit CsvLogSink(std::ostream& out); // Does not take ownership
+    ~CsvLogSink();
+    // Also writes a sparse block index of the rows (see LogIndex.h), rewritten on every flush
+    bool enableIndex(const std::string& filename, uint32_t blockRows = 4096);
+    void defineName(uint16_t id, const std::string& name) override;
+    void write(const LogRecord& record) override;
+    void flush() override;
+    static const char* header();
+private:
+    int formatRow(const LogRecord& record, char* buf, size_t size); // snprintf result
+    std::ofstream file;
+    std::ostream* out;
+    std::vector<std::string> names;
+    std::unique_ptr<LogIndexWriter> index;
+    uint64_t bytesWritten = 0; // Offset of the next row
+    int64_t cachedDay = -1;  // Day number whose date prefix is in datePrefix
+    char datePrefix[12];     // "YYYY-MM-DD "
+};
+
+#endif // LOGSINK_H
@@ -4,10 +4,24 @@
 #include <vector>
 #include <iomanip>
 #include <ctime>
+#include <memory>
+#include "LogSink.h"
+#include "Rollup.h"
+#include "Snapshot.h"
+
+enum class LogFormat {
+    Csv,    // output.csv text schema
+    Binary, // Compact columnar .mlog (see BinaryLog.h), convert with mysa_log2csv
+    None    // No per-step output, summaries only
+};
+
+// Creates the file sink for the given format (nullptr for LogFormat::None)
+std::unique_ptr<LogSink> makeFileLogSink(const std::string& filename, LogFormat format);
 
 class Logger {
 public:
-    Logger(const std::string& filename);
+    Logger(const std::string& filename, LogFormat format = LogFormat::Csv);
+    explicit Logger(std::unique_ptr<LogSink> sink); // Custom sink; nullptr keeps summaries only
     ~Logger();
     void logSecond(
         int time_s,
@@ -25,6 +39,16 @@ public:
         const std::string& soil_type = "Loam",
         float power_used = 0.0f // New parameter for power consumption
     );
+    // Adds `ticks` steps to the summary without writing rows (event-driven runs skip them).
+    // The span starts at first_time with the given moisture and ends at moisture_last. Rollups also take
+    // the moisture summed over its ticks and the range its stress moved in.
+    void logSpan(int ticks, float water_used, float power_used, double plant_stress_sum,
+                 int healthy_ticks, int sensor_error_ticks, int first_time = 0, float moisture_first = 0.0f,
+                 float moisture_last = 0.0f, double moisture_sum = 0.0, float stress_min = 0.0f,
+                 float stress_max = 0.0f, bool pump_on = false, const std::string& zone_id = "Zone1");
+    // Also writes per-zone hourly and daily rollups (see Rollup.h), independently of the per-step sink
+    bool enableRollups(const std::string& filename);
+    int64_t getRollupRowsWritten() const { return rollups ? rollups->getRowsWritten() : 0; }
     void finalize();
     // For summary reporting
     float getTotalWaterUsed() const;
@@ -34,10 +58,18 @@ public:
     float getWaterEfficiency() const;
     int getSensorFailureEvents() const;
     int getHealthyTime() const;
+    // Checkpoint state: the summary accumulators (not the sink or open rollup periods)
+    void save(SnapshotWriter& out) const;
+    void restore(SnapshotReader& in);
     void setZoneID(const std::string& id);
     void setSoilType(const std::string& type);
 private:
-    std::ofstream file;
+    uint16_t internName(const std::string& name, std::string& lastName, uint16_t& lastId);
+    std::unique_ptr<LogSink> sink;
+    std::unique_ptr<RollupWriter> rollups;
+    std::vector<std::string> names; // Dictionary of zone IDs / soil types sent to the sink
+    std::string lastZone, lastSoil; // Cache of the previous row's strings to skip dictionary lookups
+    uint16_t lastZoneId = 0, lastSoilId = 0;
     float total_water_used = 0.0f;
     float total_power_used = 0.0f; // New field for total power used
     float total_plant_stress = 0.0f;
@@ -47,4 +79,4 @@ private:
     int healthy_time = 0;
     std::string zone_id = "Zone1";
     std::string soil_type = "Loam";
-}; 
\ No newline at end of file
+};
@@ -0,0 +1,64 @@
+#ifndef PARAMETERSWEEP_H
+#define PARAMETERSWEEP_H
+
+#include "ZoneSimulation.h"
+#include <ostream>
+#include <string>
+#include <vector>
+
+struct Checkpoint;
+
+/*
+ * Batch runs over config.yaml variants. A sweep file has one config key per line:
+ *   moisture_threshold=30,35,40           explicit values
+ *   pump_flow_rate=4:8:2                  inclusive grid start:stop:step
+ *   conservation_moisture_threshold=~25:40  uniform random range
+ *   samples=100                           random draws per grid point (for ~ ranges)
+ *   seeds=4                               seeds per variant: --seed, --seed + 1, ...
+ * Keys not listed keep their config.yaml value. Every grid point is combined with every
+ * random draw and every seed; each run is one zone and only its summary metrics are kept.
+ */
+struct SweepAxis {
+    std::string key;
+    std::vector<std::string> values; // Grid values, in file order
+    bool random = false;
+    float min = 0.0f;
+    float max = 0.0f;
+};
+
+struct SweepSpec {
+    std::vector<SweepAxis> axes;
+    int samples = 1;
+    int seeds = 1;
+};
+
+struct SweepRun {
+    SimulationParams params;
+    std::vector<std::string> values; // Value of each axis for this run
+};
+
+// Logger summary of one run
+struct SweepResult {
+    float waterUsed = 0.0f;
+    float powerUsed = 0.0f;
+    float dailyCost = 0.0f;
+    float averageStress = 0.0f;
+    float efficiency = 0.0f;
+    int sensorFailures = 0;
+};
+
+// Returns false and sets error (with the line number) if the file cannot be read or parsed
+bool loadSweepSpec(const std::string& path, SweepSpec& spec, std::string& error);
+bool parseSweepSpec(std::istream& in, SweepSpec& spec, std::string& error);
+// All runs of the sweep; random draws are keyed by base.seed, so a sweep is reproducible
+std::vector<SweepRun> expandSweep(const SweepSpec& spec, const SimulationParams& base);
+// One zone without per-step output. Each tick-mode run has its own pump budget of maxPumps.
+// With start (a single-zone checkpoint, tick engine only) the run forks from the checkpointed
+// zone state under params and its summary covers only the durationSeconds after the fork.
+SweepResult runSweepSimulation(const SimulationParams& params, int durationSeconds, bool eventEngine, int maxPumps,
+                               const Checkpoint* start = nullptr);
+// Results table as CSV: run, seed, one column per axis, then the summary metrics
+void writeSweepResults(std::ostream& out, const SweepSpec& spec, const std::vector<SweepRun>& runs,
+                       const std::vector<SweepResult>& results);
+
+#endif // PARAMETERSWEEP_H
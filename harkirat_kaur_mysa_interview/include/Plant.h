@@ -1,12 +1,16 @@
 #ifndef PLANT_H
 #define PLANT_H
 
+#include "Snapshot.h"
+
 class Plant {
 public:
     Plant(float waterNeedPerDay, float stressThreshold, float absorptionRate);
     void update(float availableWater);
     float getStress() const;
     float getWaterNeed() const;
+    void save(SnapshotWriter& out) const; // Checkpoint state: stress
+    void restore(SnapshotReader& in);
 private:
     float waterNeedPerDay;   // Liters
     float stressThreshold;   // Percentage (0-100)
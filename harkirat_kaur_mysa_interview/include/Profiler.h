@@ -0,0 +1,78 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Instrumented hot paths; a section's time includes any section nested inside it
+enum class ProfileSection : uint8_t {
+    ZoneStep,          // ZoneSimulation::step, EventSimulation exact ticks
+    ControllerUpdate,  // IrrigationController::update
+    ZoneUpdate,        // GardenZone::update (weather, soil, plant, pump)
+    WeatherUpdate,     // WeatherSensor::update
+    Forecast,          // WeatherSensor::issueForecast, once per simulated hour
+    LogFormat,         // Turning a LogRecord into CSV text or binary columns
+    LogWrite,          // Handing formatted bytes to the stream and flushing it
+    Count
+};
+
+const char* profileSectionName(ProfileSection section);
+
+// Per-section latency summary, merged over every thread that recorded the section
+struct ProfileStats {
+    ProfileSection section;
+    uint64_t count = 0;
+    double totalMs = 0.0;
+    double p50Us = 0.0; // Percentiles are accurate to 1/8 of a power of two
+    double p90Us = 0.0;
+    double p99Us = 0.0;
+    double maxUs = 0.0;
+};
+
+/*
+ * Scoped hot-path profiler. Each thread records into its own buffer (a log-bucket histogram
+ * per section, plus raw events for the Chrome trace when tracing), so recording takes no lock.
+ * Buffers belong to the profiler, not the thread, and stay readable after a worker exits.
+ * When disabled a ProfileScope costs one relaxed load and a branch: no clock read, no store.
+ * report() and writeChromeTrace() must run once the profiled threads are idle (after the last
+ * ZoneScheduler::runTick and logger.finalize()).
+ */
+class Profiler {
+public:
+    static const size_t kDefaultTraceEvents = 1 << 20; // Per thread; later events are counted as dropped
+    // Clears earlier recordings; trace keeps raw events for writeChromeTrace(). Call while nothing records
+    static void enable(bool trace, size_t maxTraceEventsPerThread = kDefaultTraceEvents);
+    static void disable();
+    static bool isEnabled() { return enabled.load(std::memory_order_relaxed); }
+    static void record(ProfileSection section, std::chrono::steady_clock::time_point start,
+                       std::chrono::steady_clock::time_point end);
+    static std::vector<ProfileStats> report(); // Sections that recorded at least one call
+    static uint64_t getDroppedTraceEvents();
+    static void printTable(std::ostream& out);
+    // Chrome trace_event JSON ("X" events, microseconds), for chrome://tracing or Perfetto
+    static bool writeChromeTrace(const std::string& path, std::string& error);
+private:
+    static std::atomic<bool> enabled;
+};
+
+class ProfileScope {
+public:
+    explicit ProfileScope(ProfileSection section) : section(section), active(Profiler::isEnabled()) {
+        if (active) start = std::chrono::steady_clock::now();
+    }
+    ~ProfileScope() {
+        if (active) Profiler::record(section, start, std::chrono::steady_clock::now());
+    }
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+private:
+    ProfileSection section;
+    bool active;
+    std::chrono::steady_clock::time_point start;
+};
+
+#endif // PROFILER_H
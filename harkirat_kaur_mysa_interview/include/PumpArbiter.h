@@ -0,0 +1,85 @@
+#ifndef PUMPARBITER_H
+#define PUMPARBITER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Fairness and starvation over a run (PumpArbiter::getStats)
+struct ArbiterStats {
+    uint64_t grants = 0;
+    uint64_t heapUpdates = 0;   // Inserts, re-keys and removals; each is O(log n)
+    double meanWaitSeconds = 0.0;
+    int maxWaitSeconds = 0;     // Longest wait, including zones still waiting
+    size_t waitingZones = 0;    // Zones waiting for a permit right now
+    size_t starvedZones = 0;    // Zones that waited longer than the starvation limit at least once
+    double fairness = 1.0;      // Jain's index over grants per served or still-waiting zone (1 = even)
+};
+
+/*
+ * Central pump-permit arbiter for the priority mode of multi-zone runs. Zones that want water
+ * and hold no permit wait in an indexed max-heap keyed by urgency:
+ *   urgency = moisture deficit (%) + plant stress (%) + aging * hours since the zone was last watered
+ * The aging term grows at the same rate for every zone, so the heap stores
+ * deficit + stress - aging * lastWateredHours and never needs a sweep to re-key waiting zones.
+ * A zone is re-keyed only when its wish changes or its urgency moves by kRekeyStep, so each tick
+ * costs O(log n) per changed zone, not O(n). Permits are not preempted: a zone keeps its permit
+ * while its pump runs, and the pump's own max run time and cooldown still apply.
+ *
+ * Threading: during a tick each zone calls isGranted() and post() for its own index only (zones
+ * may run on several threads); arbitrate() runs on one thread between ticks.
+ */
+class PumpArbiter {
+public:
+    static const float kRekeyStep; // Urgency change that moves a waiting zone in the heap
+    PumpArbiter(size_t zoneCount, int maxActive);
+    void setAgingPerHour(float points) { agingPerHour = points; } // Default 10 urgency points per hour
+    void setStarvationSeconds(int seconds) { starvationSeconds = seconds; } // Default 3600
+    bool isGranted(uint32_t zone) const { return granted[zone] != 0; }
+    // The zone wants its pump to run (or holds a permit while it runs), with its current urgency
+    void post(uint32_t zone, bool wantsPump, float urgency);
+    // Applies this tick's posts and grants free permits to the most urgent waiting zones
+    void arbitrate(int secondsElapsed);
+    int getActive() const { return active; }
+    int getMaxActive() const { return maxActive; }
+    ArbiterStats getStats(int secondsElapsed) const;
+    static float urgency(float moistureDeficit, float plantStress) {
+        return (moistureDeficit > 0.0f ? moistureDeficit : 0.0f) + plantStress;
+    }
+private:
+    // Indexed binary max-heap over waiting zones; position[zone] is -1 outside the heap
+    bool higher(uint32_t a, uint32_t b) const;
+    void siftUp(size_t i);
+    void siftDown(size_t i);
+    void place(size_t i, uint32_t zone);
+    void upsert(uint32_t zone, float key);
+    void remove(uint32_t zone);
+    uint32_t popTop();
+    void apply(uint32_t zone, int secondsElapsed);
+    std::vector<uint32_t> heap;
+    std::vector<int32_t> position;
+    std::vector<float> key;
+    // Per-zone posts: written by the zone's thread during a tick, read by arbitrate()
+    std::vector<uint8_t> wants;
+    std::vector<float> postedUrgency;
+    std::vector<uint8_t> dirty;
+    std::vector<uint32_t> dirtyZones;
+    std::atomic<size_t> dirtyCount{0};
+    // Permits and per-zone history (arbitrate() only)
+    std::vector<uint8_t> granted;
+    std::vector<int> waitingSince;  // -1 while not waiting
+    std::vector<int> lastWatered;
+    std::vector<uint32_t> zoneGrants;
+    std::vector<uint8_t> starved;
+    int maxActive;
+    int active = 0;
+    float agingPerHour = 10.0f;
+    int starvationSeconds = 3600;
+    uint64_t grants = 0;
+    uint64_t heapUpdates = 0;
+    double totalWaitSeconds = 0.0;
+    int maxWaitSeconds = 0;
+};
+
+#endif // PUMPARBITER_H
@@ -0,0 +1,88 @@
+#ifndef ROLLINGWINDOW_H
+#define ROLLINGWINDOW_H
+
+#include "Snapshot.h"
+#include <cstddef>
+#include <vector>
+
+/*
+ * Fixed-capacity circular buffer of the last N samples with running sums, so the mean
+ * and the least-squares slope (per sample) are O(1) no matter how long the window is.
+ * Sums are kept in double; samples are evicted by subtracting them back out.
+ */
+class RollingWindow {
+public:
+    explicit RollingWindow(size_t capacity = 1) { reset(capacity); }
+
+    void reset(size_t newCapacity) {
+        samples.assign(newCapacity > 0 ? newCapacity : 1, 0.0f);
+        clear();
+    }
+    void clear() {
+        head = 0;
+        count = 0;
+        sum = 0.0;
+        indexSum = 0.0;
+    }
+
+    void push(float value) {
+        if (count == samples.size()) {
+            // Drop the oldest sample; every remaining sample moves one index closer to 0
+            float oldest = samples[head];
+            sum -= oldest;
+            indexSum -= sum;
+            --count;
+        }
+        samples[head] = value;
+        head = (head + 1) % samples.size();
+        indexSum += static_cast<double>(count) * value;
+        sum += value;
+        ++count;
+    }
+
+    void save(SnapshotWriter& out) const {
+        out.writeVector(samples);
+        out.write(static_cast<uint64_t>(head));
+        out.write(static_cast<uint64_t>(count));
+        out.write(sum);
+        out.write(indexSum);
+    }
+    void restore(SnapshotReader& in) {
+        uint64_t h = 0, n = 0;
+        in.readVector(samples);
+        in.read(h);
+        in.read(n);
+        in.read(sum);
+        in.read(indexSum);
+        if (samples.empty() || h >= samples.size() || n > samples.size()) {
+            in.fail();
+            reset(samples.empty() ? 1 : samples.size());
+            return;
+        }
+        head = static_cast<size_t>(h);
+        count = static_cast<size_t>(n);
+    }
+
+    size_t size() const { return count; }
+    size_t capacity() const { return samples.size(); }
+    bool empty() const { return count == 0; }
+    float mean() const { return count ? static_cast<float>(sum / count) : 0.0f; }
+
+    // Least-squares slope of value against sample index (units per sample), 0 with fewer than 2 samples
+    float slope() const {
+        if (count < 2) return 0.0f;
+        double n = static_cast<double>(count);
+        double sumI = n * (n - 1.0) / 2.0;
+        double sumI2 = (n - 1.0) * n * (2.0 * n - 1.0) / 6.0;
+        return static_cast<float>((n * indexSum - sumI * sum) / (n * sumI2 - sumI * sumI));
+    }
+
+private:
+    std::vector<float> samples;
+    size_t head = 0;        // Next slot to write; the oldest sample when full
+    size_t count = 0;
+    double sum = 0.0;       // Sum of samples
+    double indexSum = 0.0;  // Sum of i * sample, i = 0 for the oldest
+};
+
+#endif // ROLLINGWINDOW_H
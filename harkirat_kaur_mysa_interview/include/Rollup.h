@@ -0,0 +1,83 @@
+#ifndef ROLLUP_H
+#define ROLLUP_H
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// Fixed-size histogram of plant stress (0-100%) in 0.5% bins; percentiles are exact to one bin and
+// never leave the range of the values added
+class StressSketch {
+public:
+    static const int kBins = 200;
+    StressSketch() { clear(); }
+    void add(float stress, uint32_t weight = 1);
+    // `weight` values spread evenly over the bins from lo to hi (a span whose stress moved between them)
+    void addRange(float lo, float hi, uint32_t weight);
+    float percentile(float p) const; // p in [0, 1]; 0 if empty
+    void clear();
+private:
+    static int binOf(float stress);
+    uint32_t bins[kBins];
+    uint64_t total;
+    float minValue;
+    float maxValue;
+};
+
+// One zone over one hour or one day
+struct RollupBucket {
+    int64_t period = -1; // Hour or day number (time_s / 3600 or / 86400); -1 while empty
+    int64_t ticks = 0;
+    float minMoisture = 0.0f;
+    float maxMoisture = 0.0f;
+    double moistureSum = 0.0;
+    int64_t pumpOnTicks = 0;
+    double water = 0.0;
+    double power = 0.0;
+    int64_t sensorErrorTicks = 0;
+    StressSketch stress;
+};
+
+/*
+ * Streaming per-zone hourly and daily rollups. Each zone keeps one open hour and one open day
+ * bucket; a bucket is written as one CSV row when the zone's first record of the next period
+ * arrives (or on flush), so memory stays bounded by the number of zones however long the run:
+ *   Period,StartTime (s),ZoneID,Ticks,MinMoisture (%),MaxMoisture (%),MeanMoisture (%),
+ *   PumpDuty (%),WaterUsed (L),PowerUsed (Wh),StressP50 (%),StressP90 (%),StressP99 (%),SensorErrorTicks
+ * Zones are identified by the Logger's dictionary IDs.
+ */
+class RollupWriter {
+public:
+    explicit RollupWriter(const std::string& filename);
+    ~RollupWriter();
+    void defineName(uint16_t id, const std::string& name);
+    void add(uint16_t zone, int time_s, float soil_moisture, bool pump_on, float water_used, float power_used,
+             float plant_stress, bool sensor_error);
+    // `ticks` consecutive steps starting at first_time with a steady pump. Moisture moves monotonically from
+    // moisture_first to moisture_last and sums to moisture_sum over the ticks. Stress stays within
+    // [stress_min, stress_max], and its ticks are spread evenly over that range, so an event-driven run's
+    // stress percentiles are exact only to the span. Must not cross an hour.
+    void addSpan(uint16_t zone, int first_time, int ticks, float moisture_first, float moisture_last,
+                 double moisture_sum, bool pump_on, float water_used, float power_used, float stress_min,
+                 float stress_max, int sensor_error_ticks);
+    void flush(); // Writes every open bucket
+    bool isOpen() const { return static_cast<bool>(file); }
+    int64_t getRowsWritten() const { return rowsWritten; }
+private:
+    struct ZoneRollup {
+        RollupBucket hour;
+        RollupBucket day;
+    };
+    ZoneRollup& zoneState(uint16_t zone);
+    void accumulate(RollupBucket& bucket, int64_t period, int64_t ticks, float minMoisture, float maxMoisture,
+                    double moistureSum, int64_t pumpOnTicks, float water, float power, float stressMin,
+                    float stressMax, int64_t sensorErrorTicks, uint16_t zone, const char* label, int64_t seconds);
+    void writeBucket(RollupBucket& bucket, uint16_t zone, const char* label, int64_t seconds);
+    std::ofstream file;
+    std::vector<std::string> names;
+    std::vector<ZoneRollup> zones;
+    int64_t rowsWritten = 0;
+};
+
+#endif // ROLLUP_H
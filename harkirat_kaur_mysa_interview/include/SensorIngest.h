@@ -0,0 +1,108 @@
+#ifndef SENSORINGEST_H
+#define SENSORINGEST_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "SensorSlots.h"
+
+/*
+ * Device packets. A datagram holds one or more readings, all in one of two encodings:
+ *
+ * Line protocol, one reading per line ('\n' separated):
+ *   weather,zone=<n> temperature=<C>,humidity=<%>,rainfall=<mm>
+ *   soil,zone=<n> moisture=<%>
+ *   weather,zone=<n> failed=1             (the device reports a failed sensor)
+ * Zones count from 0. Fields may come in any order; a missing value field is malformed.
+ *
+ * Binary, kBinaryRecordSize-byte little-endian records back to back:
+ *   uint8 magic (0xFE), uint8 kind (1 weather, 2 soil), uint8 flags (bit 0: failed), uint8 reserved,
+ *   uint32 zone, float32 values[3] (weather: temperature, humidity, rainfall; soil: moisture, 0, 0)
+ * A datagram whose first byte is the magic is binary.
+ */
+const size_t kBinaryRecordSize = 20;
+const size_t kMaxSensorDatagram = 2048;
+
+// Decodes up to `capacity` readings from one datagram without allocating; counts records it could not parse
+size_t decodeSensorDatagram(const char* data, size_t size, SensorReading* out, size_t capacity, size_t& malformed);
+// Append one reading to buffer[0, size); return the bytes written (0 if it does not fit)
+size_t encodeSensorLine(const SensorReading& reading, char* buffer, size_t size);
+size_t encodeSensorBinary(const SensorReading& reading, char* buffer, size_t size);
+
+struct IngestStats {
+    uint64_t datagrams = 0;
+    uint64_t readings = 0;    // Stored in a slot
+    uint64_t malformed = 0;   // Records that did not parse
+    uint64_t unknownZone = 0; // Readings for a zone the run does not have
+};
+
+/*
+ * Local ingestion front end: a thread waits on an epoll set holding the socket and a stop eventfd,
+ * drains the socket in batches of up to kBatch datagrams per recvmmsg() into buffers allocated once
+ * at start(), decodes them and stores every reading into the zone's latest-value slot.
+ * Endpoints: "udp:<host>:<port>" (port 0 picks a free one, see getPort) or "unix:<path>" (a datagram
+ * socket; an existing file at the path is replaced). Linux only: elsewhere start() reports an error.
+ */
+class SensorIngestService {
+public:
+    static const size_t kBatch = 32;
+    explicit SensorIngestService(SensorSlots& slots);
+    ~SensorIngestService();
+    SensorIngestService(const SensorIngestService&) = delete;
+    SensorIngestService& operator=(const SensorIngestService&) = delete;
+    bool start(const std::string& endpoint, std::string& error);
+    void stop();
+    int getPort() const { return port; } // Bound UDP port, 0 for a UNIX socket
+    IngestStats getStats() const;
+    // Decodes one datagram and stores its readings (the thread calls this; exposed for tests)
+    void ingest(const char* data, size_t size, int64_t receivedNs);
+private:
+    void run();
+    SensorSlots& slots;
+    std::thread thread;
+    int socketFd = -1;
+    int epollFd = -1;
+    int stopFd = -1;
+    int port = 0;
+    std::string unixPath;
+    std::vector<char> buffers;
+    std::atomic<uint64_t> datagrams{0};
+    std::atomic<uint64_t> readings{0};
+    std::atomic<uint64_t> malformed{0};
+    std::atomic<uint64_t> unknownZone{0};
+};
+
+// Device side: sends datagrams to an ingestion endpoint (the replay client and tests)
+class SensorClient {
+public:
+    SensorClient() {}
+    ~SensorClient();
+    SensorClient(const SensorClient&) = delete;
+    SensorClient& operator=(const SensorClient&) = delete;
+    bool open(const std::string& endpoint, std::string& error);
+    bool send(const char* data, size_t size);
+    void close();
+private:
+    int fd = -1;
+};
+
+enum class SensorEncoding { Line, Binary };
+
+struct ReplayStats {
+    uint64_t steps = 0;
+    uint64_t datagrams = 0;
+    uint64_t readings = 0;
+};
+
+// Replays a CSV log written by mysa_irrigation as device readings: each step's rows (same Timestamp)
+// become a weather and a soil reading per zone ("ZoneN" is zone N - 1), packed into as few datagrams as
+// fit, and steps are sent stepsPerSecond apart (0: as fast as possible). A row with SensorError TRUE is
+// sent as failed for both sensors, since the log does not say which one failed.
+bool replaySensorLog(std::istream& csv, SensorClient& client, SensorEncoding encoding, double stepsPerSecond,
+                     ReplayStats& stats, std::string& error);
+
+#endif // SENSORINGEST_H
@@ -0,0 +1,54 @@
+#ifndef SENSORSLOTS_H
+#define SENSORSLOTS_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+enum class SensorKind : uint8_t {
+    Weather = 1, // values: temperature (C), humidity (%), rainfall (mm)
+    Soil = 2     // values[0]: moisture (%)
+};
+
+// One device reading, as decoded from a packet (SensorIngest.h)
+struct SensorReading {
+    SensorKind kind = SensorKind::Weather;
+    uint32_t zone = 0;
+    bool failed = false; // The device reports its sensor as failed; values are not meaningful
+    float values[3] = {0.0f, 0.0f, 0.0f};
+};
+
+/*
+ * Latest live reading per zone and sensor kind: written by the ingestion thread, read by the zone
+ * threads through WeatherSensor and Soil (setLiveSource). Each slot is a seqlock: the writer makes
+ * the sequence odd, stores the fields and makes it even again; a reader retries if the sequence
+ * changed under it. Neither side takes a lock or allocates.
+ *
+ * A reading older than the maximum age counts as a failure, like a reading the device marked failed,
+ * so a silent device ends up on the same -999 / -1 fallback path as a simulated sensor failure.
+ */
+class SensorSlots {
+public:
+    explicit SensorSlots(size_t zoneCount, double maxAgeSeconds = 30.0);
+    size_t size() const { return zoneCount; }
+    double getMaxAgeSeconds() const { return maxAgeNs / 1e9; }
+    // Single writer. False (and nothing stored) for a zone outside [0, size())
+    bool store(const SensorReading& reading, int64_t receivedNs);
+    // Copies the latest values (3 floats) of a zone's sensor; false if there is none, it failed or it is stale
+    bool read(uint32_t zone, SensorKind kind, float* values) const;
+    static int64_t nowNs(); // Steady clock
+private:
+    struct Slot {
+        std::atomic<uint32_t> sequence{0};
+        std::atomic<float> values[3];
+        std::atomic<int64_t> receivedNs{0};
+        std::atomic<bool> valid{false}; // A reading arrived and was not marked failed
+    };
+    Slot& slot(uint32_t zone, SensorKind kind) const { return slots[zone * 2 + (kind == SensorKind::Soil ? 1 : 0)]; }
+    size_t zoneCount;
+    int64_t maxAgeNs;
+    std::unique_ptr<Slot[]> slots;
+};
+
+#endif // SENSORSLOTS_H
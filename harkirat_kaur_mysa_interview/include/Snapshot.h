@@ -0,0 +1,78 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+/*
+ * Raw little-endian field-by-field encoding used by checkpoints. Each class writes its own
+ * mutable state in a fixed order with save() and reads it back in the same order with
+ * restore(); configuration that comes from SimulationParams is not part of a snapshot.
+ * A short or failed read makes the reader fail for good, so callers check ok() once at the end.
+ */
+class SnapshotWriter {
+public:
+    explicit SnapshotWriter(std::ostream& out) : out(out) {}
+    template <typename T>
+    void write(const T& value) {
+        static_assert(std::is_trivially_copyable<T>::value, "snapshot fields must be plain values");
+        out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+    template <typename T>
+    void writeArray(const T* values, size_t n) {
+        out.write(reinterpret_cast<const char*>(values), n * sizeof(T));
+    }
+    void writeString(const std::string& s) {
+        write(static_cast<uint32_t>(s.size()));
+        out.write(s.data(), s.size());
+    }
+    template <typename T>
+    void writeVector(const std::vector<T>& v) {
+        write(static_cast<uint32_t>(v.size()));
+        writeArray(v.data(), v.size());
+    }
+    bool ok() const { return static_cast<bool>(out); }
+private:
+    std::ostream& out;
+};
+
+class SnapshotReader {
+public:
+    explicit SnapshotReader(std::istream& in) : in(in) {}
+    template <typename T>
+    void read(T& value) {
+        static_assert(std::is_trivially_copyable<T>::value, "snapshot fields must be plain values");
+        if (good) good = static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(T)));
+    }
+    template <typename T>
+    void readArray(T* values, size_t n) {
+        if (good) good = static_cast<bool>(in.read(reinterpret_cast<char*>(values), n * sizeof(T)));
+    }
+    void readString(std::string& s) {
+        uint32_t n = 0;
+        read(n);
+        if (!good || n > kMaxLength) return fail();
+        s.resize(n);
+        readArray(&s[0], n);
+    }
+    template <typename T>
+    void readVector(std::vector<T>& v) {
+        uint32_t n = 0;
+        read(n);
+        if (!good || n > kMaxLength) return fail();
+        v.resize(n);
+        readArray(v.data(), n);
+    }
+    void fail() { good = false; }
+    bool ok() const { return good; }
+private:
+    static const uint32_t kMaxLength = 1u << 24; // Guards resize() against corrupt lengths
+    std::istream& in;
+    bool good = true;
+};
+
+#endif // SNAPSHOT_H
@@ -1,6 +1,11 @@
 #ifndef SOIL_H
 #define SOIL_H
 
+#include "Snapshot.h"
+#include <cstdint>
+
+class SensorSlots;
+
 class Soil {
 public:
     Soil(float retentionRate, float drainageFactor);
@@ -9,11 +14,20 @@ public:
     // Sensor failure simulation
     void simulateFailure();
     void resetFailure();
+    // Live moisture readings (SensorIngestService) instead of the soil model; nullptr restores it. The
+    // slots must outlive the soil. A missing, stale or failed reading is a sensor failure (-1).
+    void setLiveSource(const SensorSlots* slots, uint32_t zone);
+    // Checkpoint state: moisture and the failure flag
+    void save(SnapshotWriter& out) const;
+    void restore(SnapshotReader& in);
 private:
     float moisture;         // Percentage (0-100)
     float retentionRate;    // Fraction (0-1)
     float drainageFactor;   // Fraction (0-1)
     bool failed = false;
+    const SensorSlots* live = nullptr;
+    uint32_t liveZone = 0;
+    void sampleLive(); // Latest live reading, taken once per update
 };
 
 #endif // SOIL_H 
\ No newline at end of file
@@ -0,0 +1,64 @@
+#ifndef SPSCRING_H
+#define SPSCRING_H
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+// Lock-free single-producer/single-consumer ring buffer for trivially copyable records.
+// push() may only be called from one thread and popBatch() from one other thread.
+template <typename T>
+class SpscRing {
+public:
+    explicit SpscRing(size_t minCapacity) {
+        size_t cap = 2;
+        while (cap < minCapacity) cap <<= 1;
+        slots.resize(cap);
+        mask = cap - 1;
+    }
+
+    // Producer side. Returns false if the ring is full.
+    bool push(const T& item) {
+        size_t h = head.load(std::memory_order_relaxed);
+        if (h - cachedTail > mask) {
+            cachedTail = tail.load(std::memory_order_acquire);
+            if (h - cachedTail > mask) return false;
+        }
+        slots[h & mask] = item;
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side. Copies up to maxItems records into out, returns how many.
+    size_t popBatch(T* out, size_t maxItems) {
+        size_t t = tail.load(std::memory_order_relaxed);
+        if (cachedHead == t) {
+            cachedHead = head.load(std::memory_order_acquire);
+            if (cachedHead == t) return 0;
+        }
+        size_t n = cachedHead - t;
+        if (n > maxItems) n = maxItems;
+        for (size_t i = 0; i < n; ++i) out[i] = slots[(t + i) & mask];
+        tail.store(t + n, std::memory_order_release);
+        return n;
+    }
+
+    // Approximate number of queued records (exact when called from the producer after its own pushes)
+    size_t size() const {
+        return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire);
+    }
+    size_t capacity() const { return mask + 1; }
+
+private:
+    std::vector<T> slots;
+    size_t mask;
+    // Producer and consumer indices live on separate cache lines to avoid false sharing
+    std::atomic<size_t> head{0};   // Next slot to write (producer)
+    size_t cachedTail = 0;         // Producer's last view of tail
+    char pad0[64];
+    std::atomic<size_t> tail{0};   // Next slot to read (consumer)
+    size_t cachedHead = 0;         // Consumer's last view of head
+    char pad1[64];
+};
+
+#endif // SPSCRING_H
@@ -1,6 +1,8 @@
 #ifndef WATERPUMP_H
 #define WATERPUMP_H
 
+#include "Snapshot.h"
+
 class WaterPump {
 public:
     WaterPump(float flowRateLpm, float powerWatts); // Updated constructor
@@ -13,6 +15,13 @@ public:
     bool canRun() const;            // Returns true if not in cooldown and under max run time
     void setMaxRunTime(int seconds);    // Set max run time
     void setCooldownTime(int seconds);  // Set cooldown period
+    void advance(int ticks);            // Same as calling update() `ticks` times
+    int getRunTime() const { return runTime; }
+    int getMaxRunTime() const { return maxRunTime; }
+    int getCooldownTime() const { return cooldownTime; }
+    int getCooldownLeft() const { return cooldownLeft; }
+    void save(SnapshotWriter& out) const; // Checkpoint state: on, runTime, cooldownLeft
+    void restore(SnapshotReader& in);
 private:
     float flowRate; // Liters per minute
     float powerWatts; // Power consumption in Watts
@@ -0,0 +1,35 @@
+#ifndef WEATHERBATCH_H
+#define WEATHERBATCH_H
+
+#include <cstddef>
+#include <cstdint>
+#include "CounterRng.h"
+
+/*
+ * Batch generator for the synthetic weather model of WeatherSensor::simulateWeather: fills
+ * temperature/humidity/rainfall arrays for a block of ticks of one zone, or for one tick of many
+ * zones (the layout ZoneBatch::step consumes), in one call.
+ *
+ * The daily curve 15 + 10 * sin(2 * pi * dayFraction) comes from a table with one entry per second
+ * of the day, built once. The noise and rain draws are the same CounterRng draws as the per-tick
+ * model; their SplitMix64 hashes run as four SIMD lanes when built with -mavx2 (scalar otherwise
+ * and for the tail). Results are bit-identical to the per-tick model (see test/test_WeatherBatch.cpp).
+ * `rng` is the zone's weather stream, as held by WeatherSensor. Sensor failures and traces are not modelled here.
+ */
+class WeatherBatch {
+public:
+    static const int kDaySeconds = 86400;
+    // 15 + 10 * sin(2 * pi * dayFraction) for second `daySecond` in [0, kDaySeconds), in double like the original expression
+    static double diurnal(int daySecond) { return diurnalTable()[daySecond]; }
+    static const double* diurnalTable();
+    // One zone, ticks first .. first + count - 1 (first >= 0)
+    static void generateTicks(const CounterRng& rng, int first, size_t count, float* temperature, float* humidity,
+                              float* rainfall);
+    // One tick, zones 0 .. count - 1; rngs[z] is zone z's weather stream
+    static void generateZones(const CounterRng* rngs, size_t count, int tick, float* temperature, float* humidity,
+                              float* rainfall);
+    // Name of the instruction set the hash lanes were compiled for
+    static const char* simdLevel();
+};
+
+#endif // WEATHERBATCH_H
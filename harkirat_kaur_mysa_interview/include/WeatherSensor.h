@@ -1,16 +1,45 @@
 #ifndef WEATHERSENSOR_H
 #define WEATHERSENSOR_H
 
-#include <cstdlib>
+#include "CounterRng.h"
+#include "WeatherTrace.h"
+#include "Snapshot.h"
+
+class SensorSlots;
 
 class WeatherSensor {
 public:
     WeatherSensor();
+    explicit WeatherSensor(const CounterRng& rng); // Noise and failures keyed by (seed, zone, tick)
     void update(int secondsElapsed);
     float getTemperature() const; // Returns -999.0f if failed
     float getHumidity() const;    // Returns -999.0f if failed
     float getRainfall() const;    // Returns -999.0f if failed
     float getRainForecast(int hours = 6) const; // Returns forecasted rainfall (mm) for the next X hours
+    float getRainProbability(int hours = 6) const; // Share of ensemble members with rain in the next X hours
+    // Forecast rain (mm) for the absolute hour `hour` from the current timeline, 0 outside it. This is the
+    // forecast feed rather than a reading, so it stays available while the sensor has failed.
+    float getForecastRainAt(int64_t hour) const;
+    // Ensemble-mean rain (mm) the synthetic forecast issues for the absolute hour `hour`, bit for bit. The draws
+    // are keyed by hour, so any issue of the timeline gives the same value. forecastRng is the ForecastStream.
+    static float syntheticForecastRain(const CounterRng& forecastRng, int members, int64_t hour);
+    // Noise-free conditions expected at second t: the trace sample, otherwise the synthetic daily cycle
+    // (also with live sensors). Rain is left to the forecast and reported as 0.
+    WeatherSample expectedWeather(int64_t t) const;
+    void setForecastEnsembleMembers(int members); // 1 (default) to kMaxEnsembleMembers
+    int getForecastEnsembleMembers() const { return ensembleMembers; }
+    // Replays recorded weather instead of the synthetic model (nullptr restores it). The trace
+    // is shared, not copied, and must outlive the sensor. Its rain also becomes the forecast.
+    void setTrace(const WeatherTrace* trace);
+    // Live device readings (SensorIngestService) instead of the synthetic model; nullptr restores it. The
+    // slots must outlive the sensor. A missing, stale or failed reading is a sensor failure (-999).
+    // The forecast stays synthetic.
+    void setLiveSource(const SensorSlots* slots, uint32_t zone);
+    // Checkpoint state: last reading, failure flag and forecast hour (the timeline is re-issued on restore)
+    void save(SnapshotWriter& out) const;
+    void restore(SnapshotReader& in);
+    static const int kForecastHours = 72;       // Longest forecast the timeline answers
+    static const int kMaxEnsembleMembers = 64;
     bool hasFailed() const;       // True if sensor is in failure state
     void resetFailure(); // Reset sensor failure state
 private:
@@ -18,7 +47,31 @@ private:
     float humidity;    // Percentage
     float rainfall;    // mm
     bool failed;       // Sensor failure flag
+    CounterRng rng;
+    CounterRng forecastRng;
+    const WeatherTrace* trace = nullptr;
+    const SensorSlots* live = nullptr;
+    uint32_t liveZone = 0;
+    // Hourly forecast timeline, issued once per hour. Each member's rain for an hour is keyed by
+    // the absolute hour, so consecutive issues agree on the hours they share.
+    int forecastHour = -1;      // Hour the timeline was issued for
+    int ensembleMembers = 1;
+    float rainHourly[kForecastHours];          // Ensemble-mean rain (mm) in hour h
+    float rainPrefix[kForecastHours + 1];      // Ensemble-mean rain (mm) over the first h hours
+    float rainProbability[kForecastHours + 1]; // Share of members with rain in the first h hours
+    // Synthetic readings for ticks blockStart .. blockStart + blockLength - 1, filled by WeatherBatch.
+    // Readings are a pure function of (rng, tick), so the block never needs saving or invalidating.
+    static const int kBlockTicks = 64;
+    float blockTemperature[kBlockTicks];
+    float blockHumidity[kBlockTicks];
+    float blockRainfall[kBlockTicks];
+    int blockStart = 0;
+    int blockLength = 0;
+    int lastTick = -2;
     void simulateWeather(int secondsElapsed);
+    void sampleLive(); // Latest live reading, taken once per update
+    void issueForecast(int hour);
+    static float memberRain(const CounterRng& forecastRng, int member, uint64_t hour);
 };
 
 #endif // WEATHERSENSOR_H 
\ No newline at end of file
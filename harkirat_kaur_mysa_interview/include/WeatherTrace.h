@@ -0,0 +1,65 @@
+#ifndef WEATHERTRACE_H
+#define WEATHERTRACE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <string>
+#include <vector>
+
+/*
+ * Recorded weather trace (.mwx), little-endian, evenly spaced samples:
+ *
+ *   header  : "MYSAWX\0\0" magic, uint32 version, uint32 intervalSeconds, uint32 sampleCount, uint32 reserved
+ *   columns : float temperature[sampleCount]   (Celsius at the sample time)
+ *             float humidity[sampleCount]      (percent at the sample time)
+ *             float rainfall[sampleCount]      (mm fallen during the interval starting at the sample)
+ *
+ * The file is memory-mapped read-only and the columns are read in place, so any number of
+ * zones, threads and sweep runs can share one open trace without copying it. Sample i is at
+ * second i * intervalSeconds of the simulation; the trace repeats after its last interval.
+ */
+struct WeatherSample {
+    float temperature;
+    float humidity;
+    float rainfall; // mm per second
+};
+
+class WeatherTrace {
+public:
+    WeatherTrace();
+    ~WeatherTrace();
+    WeatherTrace(const WeatherTrace&) = delete;
+    WeatherTrace& operator=(const WeatherTrace&) = delete;
+    // Returns false and sets error if the file cannot be mapped or is not a valid trace
+    bool open(const std::string& filename, std::string& error);
+    void close();
+    bool isOpen() const { return count > 0; }
+    uint32_t getInterval() const { return interval; }
+    uint32_t getSampleCount() const { return count; }
+    int64_t getDuration() const { return static_cast<int64_t>(interval) * count; }
+    // Temperature and humidity interpolated linearly between samples; the interval's rain spread evenly over it
+    WeatherSample sample(int64_t t) const;
+    // Rain (mm) that falls during seconds [from, to)
+    float rainBetween(int64_t from, int64_t to) const;
+private:
+    const char* data = nullptr;
+    size_t size = 0;
+    uint32_t interval = 0;
+    uint32_t count = 0;
+    const float* temperature = nullptr;
+    const float* humidity = nullptr;
+    const float* rainfall = nullptr;
+#ifdef _WIN32
+    void* fileHandle = nullptr;
+    void* mappingHandle = nullptr;
+#endif
+};
+
+bool writeWeatherTrace(const std::string& filename, uint32_t intervalSeconds, const std::vector<float>& temperature,
+                       const std::vector<float>& humidity, const std::vector<float>& rainfall);
+// Converts CSV rows "time_s,temperature,humidity,rain_mm" (header line optional, times evenly spaced)
+// into a .mwx trace. Returns false and sets error (with the line number) on bad input.
+bool convertWeatherCsv(std::istream& csv, const std::string& filename, std::string& error);
+
+#endif // WEATHERTRACE_H
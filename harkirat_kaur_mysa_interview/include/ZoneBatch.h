@@ -0,0 +1,80 @@
+#ifndef ZONEBATCH_H
+#define ZONEBATCH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Per-zone parameters, mirroring the Soil/Plant/WaterPump constructor arguments
+struct ZoneParams {
+    float retentionRate = 0.8f;
+    float drainageFactor = 0.2f;
+    float waterNeedPerDay = 10.0f;
+    float absorptionRate = 0.05f;
+    float flowRateLpm = 6.0f;
+    float powerWatts = 60.0f;
+    int maxRunTime = 600;
+    int cooldownTime = 300;
+};
+
+/*
+ * Struct-of-arrays engine for many zones. Each field of Soil, Plant and WaterPump is a
+ * contiguous array indexed by zone, and the update math runs as SIMD loops across zones
+ * (AVX when compiled with -mavx/-mavx2, otherwise SSE2, with a scalar tail).
+ *
+ * The kernels reproduce Soil::update, Plant::update and WaterPump::update bit for bit;
+ * those classes stay the single-zone reference (see test/test_ZoneBatch.cpp).
+ * Soil sensor failures are a reading concern and are not modelled here.
+ */
+class ZoneBatch {
+public:
+    size_t addZone(const ZoneParams& params);
+    size_t size() const { return moisture.size(); }
+
+    // WaterPump::update for every zone
+    void updatePumps();
+    // Soil::update for every zone; irrigation comes from each zone's pump state
+    void updateSoil(const float* evapotranspiration, const float* rainfall);
+    // Plant::update(soil moisture) for every zone
+    void updatePlants();
+    // GardenZone::update physics: evapotranspiration from weather, then soil, then plants
+    void step(const float* temperature, const float* humidity, const float* rainfall);
+
+    // Pump control, same semantics as WaterPump
+    void turnOn(size_t zone);
+    void turnOff(size_t zone);
+    bool isOn(size_t zone) const { return pumpOn[zone] != 0; }
+    bool canRun(size_t zone) const { return pumpOn[zone] == 0 && cooldownLeft[zone] == 0; }
+
+    float getMoisture(size_t zone) const { return moisture[zone]; }
+    float getStress(size_t zone) const { return stress[zone]; }
+    float getFlowRate(size_t zone) const { return flowRateLpm[zone]; }
+    float getPowerWatts(size_t zone) const { return powerWatts[zone]; }
+    const float* moistureData() const { return moisture.data(); }
+    const float* stressData() const { return stress.data(); }
+
+    // Name of the instruction set the kernels were compiled for
+    static const char* simdLevel();
+private:
+    // Soil
+    std::vector<float> moisture;
+    std::vector<float> retentionRate;
+    std::vector<float> evapScale;      // 1 - drainageFactor
+    // Plant
+    std::vector<float> stress;
+    std::vector<float> absorptionRate;
+    std::vector<float> needPerSecond;  // waterNeedPerDay / 86400
+    // WaterPump
+    std::vector<float> flowRateLpm;
+    std::vector<float> flowPerSecond;  // flowRateLpm / 60
+    std::vector<float> powerWatts;
+    std::vector<int32_t> pumpOn;       // 0 or 1
+    std::vector<int32_t> runTime;
+    std::vector<int32_t> maxRunTime;
+    std::vector<int32_t> cooldownTime;
+    std::vector<int32_t> cooldownLeft;
+    // Scratch
+    std::vector<float> evapBuffer;
+};
+
+#endif // ZONEBATCH_H
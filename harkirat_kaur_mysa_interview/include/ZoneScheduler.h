@@ -0,0 +1,57 @@
+#ifndef ZONESCHEDULER_H
+#define ZONESCHEDULER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*
+ * Work-stealing thread pool that updates zones in parallel, one tick at a time.
+ * runTick() splits the zones into chunks of `grain` zones, gives each worker a
+ * contiguous share in its own deque, and idle workers steal chunks from the front
+ * of other workers' deques. The calling thread acts as worker 0, so a scheduler
+ * with one thread runs everything inline.
+ */
+class ZoneScheduler {
+public:
+    explicit ZoneScheduler(size_t threadCount, size_t grain = 8);
+    ~ZoneScheduler();
+    ZoneScheduler(const ZoneScheduler&) = delete;
+    ZoneScheduler& operator=(const ZoneScheduler&) = delete;
+    // Calls work(zone) once for every zone in [0, zoneCount); returns when all calls have finished
+    void runTick(size_t zoneCount, const std::function<void(size_t)>& work);
+    size_t getThreadCount() const { return queues.size(); }
+    unsigned long long getStealCount() const { return steals.load(); }
+private:
+    struct Range {
+        size_t begin;
+        size_t end;
+    };
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<Range> ranges;
+    };
+    void workerLoop(size_t worker);
+    void drain(size_t worker);
+    bool popLocal(size_t worker, Range& range);
+    bool steal(size_t thief, Range& range);
+    size_t grain;
+    std::vector<std::unique_ptr<WorkerQueue>> queues;
+    std::vector<std::thread> threads;
+    const std::function<void(size_t)>* work = nullptr;
+    std::atomic<size_t> pendingRanges{0};
+    std::atomic<unsigned long long> steals{0};
+    // Tick hand-off to the background workers
+    std::mutex tickMutex;
+    std::condition_variable tickStart;
+    std::atomic<unsigned long long> generation{0};
+    bool stopping = false;
+};
+
+#endif // ZONESCHEDULER_H
@@ -0,0 +1,115 @@
+#ifndef ZONESIMULATION_H
+#define ZONESIMULATION_H
+
+#include "WeatherSensor.h"
+#include "Soil.h"
+#include "Plant.h"
+#include "WaterPump.h"
+#include "GardenZone.h"
+#include "IrrigationController.h"
+#include "CounterRng.h"
+#include <cstdint>
+#include <string>
+
+class ConfigChannel;
+class PumpArbiter;
+class SensorSlots;
+
+// Parsed config.yaml values needed to build one zone
+struct SimulationParams {
+    float plantWaterNeedPerDay = 10.0f;
+    float plantStressThreshold = 10.0f;
+    float plantAbsorptionRate = 0.05f;
+    float soilRetentionRate = 0.8f;
+    float soilDrainageFactor = 0.2f;
+    float moistureThreshold = 40.0f;
+    float pumpFlowRate = 6.0f;
+    float pumpPowerWatts = 60.0f;
+    float waterCost = 0.1f;
+    float simulationStep = 1.0f;
+    uint64_t seed = 0;          // Same seed => bit-identical run
+    // Water conservation mode (IrrigationController); waterCost is compared with the cost threshold
+    bool conservationModeEnabled = false;
+    float conservationWaterCostThreshold = 0.5f;
+    float conservationDroughtMoistureThreshold = 20.0f;
+    float conservationMoistureThreshold = 35.0f;
+    int conservationNightStartHour = 22;
+    int conservationNightEndHour = 6;
+    int forecastEnsembleMembers = 1; // WeatherSensor forecast ensemble size
+    // IrrigationController features; disabled ones are compiled out of its decision pipeline
+    bool predictiveWateringEnabled = true;
+    bool forecastDelayEnabled = true;
+    // Receding-horizon planner (IrrigationPlanner) instead of the threshold rule
+    bool plannerEnabled = false;
+    int plannerHorizonHours = 12;
+    float plannerStressPenalty = 1.0f; // Cost per %·hour below moisture_threshold, against water_cost per litre
+    const WeatherTrace* weatherTrace = nullptr; // Recorded weather shared by every zone (not owned)
+};
+
+// Everything main.cpp reports or logs for one zone after one step
+struct ZoneStepResult {
+    int time_s;
+    float soilMoisture;      // Fallback value if the soil sensor failed
+    float effectiveMoisture;
+    float temperature;       // Fallback values if the weather sensor failed
+    float humidity;
+    float rainfall;
+    bool pumpOn;
+    PumpReason pumpReason;   // Why the pump is on or off after this step
+    bool conservationActive;
+    float waterUsed;         // L this step
+    float powerUsed;         // Wh this step
+    float plantStress;
+    bool rainLikely;
+    bool weatherFailed;
+    bool soilFailed;
+    // Transitions detected this step (for console messages)
+    bool weatherFailureDetected;
+    bool weatherFailureReset;
+    bool soilFailureDetected;
+    bool soilFailureReset;
+};
+
+// One zone's sensors, models, pump and controller, stepped the way main.cpp's loop does
+class ZoneSimulation {
+public:
+    ZoneSimulation(const SimulationParams& params, uint32_t zoneIndex, const std::string& zoneId,
+                   const std::string& soilType = "Loam", PumpBudget* budget = nullptr); // nullptr: site-wide budget
+    ZoneSimulation(const ZoneSimulation&) = delete;
+    ZoneSimulation& operator=(const ZoneSimulation&) = delete;
+    ZoneStepResult step(float secondsElapsed);
+    const std::string& getZoneId() const { return zoneId; }
+    const std::string& getSoilType() const { return soilType; }
+    float getFlowRate() const { return params.pumpFlowRate; }
+    bool isPumpOn() const { return pump.isOn(); }
+    // Live config (--watch-config): each step() picks up a newly published version before deciding
+    void setConfigChannel(const ConfigChannel* channel) { live = channel; }
+    const SimulationParams& getParams() const { return params; }
+    // Priority pump arbitration: permits come from the arbiter instead of the first-come budget (not checkpointed)
+    void setPumpArbiter(PumpArbiter* arbiter);
+    // Live sensors (--sensor-listen): weather and soil read this zone's slots instead of their models (not checkpointed)
+    void setSensorSlots(const SensorSlots* slots);
+    // Checkpoint state of every component; restore() into a zone built from the same or what-if params
+    void save(SnapshotWriter& out) const;
+    void restore(SnapshotReader& in);
+private:
+    SimulationParams params;
+    std::string zoneId;
+    std::string soilType;
+    uint32_t zoneIndex;
+    CounterRng rng;
+    WeatherSensor weather;
+    Soil soil;
+    Plant plant;
+    WaterPump pump;
+    GardenZone zone;
+    IrrigationController controller;
+    int weatherFailureStart = -1;
+    int soilFailureStart = -1;
+    const ConfigChannel* live = nullptr;
+    uint64_t configVersion = 0;
+    PumpArbiter* arbiter = nullptr;
+    void configureController();
+};
+
+#endif // ZONESIMULATION_H
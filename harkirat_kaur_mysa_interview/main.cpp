@@ -10,16 +10,60 @@
 #include <fstream>
 #include <sstream>
 #include <string>
-#include <map>
 #include "include/Logger.h"
+#include "include/AsyncLogSink.h"
+#include "include/ZoneSimulation.h"
+#include "include/ZoneScheduler.h"
+#include "include/EventSimulation.h"
+#include "include/ParameterSweep.h"
+#include "include/WeatherTrace.h"
+#include "include/EventLog.h"
+#include "include/Checkpoint.h"
+#include "include/Config.h"
+#include "include/Profiler.h"
+#include "include/DeadlineScheduler.h"
+#include "include/PumpArbiter.h"
+#include "include/SensorIngest.h"
+#include <functional>
+#include <memory>
+#include <vector>
 #include <regex>
-#include <cstdlib> // For std::rand
 #include <iomanip> // For std::fixed and std::setprecision
 
 int main(int argc, char* argv[]) {
     try {
         std::string configPath = "config/config.yaml";
         int simulation_duration = -1; // -1 means not set by CLI
+        LogFormat logFormat = LogFormat::Csv;
+        bool asyncLog = false;
+        Backpressure logBackpressure = Backpressure::Block;
+        size_t logQueueCapacity = 65536;
+        bool realtime = true; // false = headless fast-forward (no sleeping, no per-step console output)
+        OverrunPolicy overrunPolicy = OverrunPolicy::CatchUp; // --overrun: real-time steps that miss their deadline
+        int zones = 1;
+        int threads = 1;
+        uint64_t seed = CounterRng::timeSeed();
+        bool priorityPumps = false; // --pump-arbiter priority: permits by urgency instead of first-come-first-served
+        int maxPumps = 0; // 0 keeps GardenZone's default budget
+        bool eventEngine = false; // --engine event: next-event core instead of the tick loop
+        int weatherResolution = 600;
+        std::string sweepPath;                      // --sweep: batch of config variants instead of one run
+        std::string sweepOutput = "output/sweep.csv";
+        bool eventLog = false;                      // --log-format events: change-only log instead of per-step rows
+        int keyframeInterval = 300;
+        bool rollups = false;                       // --rollups: per-zone hourly/daily rollup file
+        std::string rollupPath = "output/rollup.csv";
+        bool logIndex = false;                      // --log-index: sparse block index next to output.csv for mysa_log_query
+        std::string tracePath;                      // --weather-trace: recorded weather (.mwx) instead of the synthetic model
+        std::string checkpointPath;                 // --checkpoint: save the full simulation state at the end of the run
+        std::string resumePath;                     // --resume: continue (or fork a sweep) from a saved checkpoint
+        bool watchConfig = false;                   // --watch-config: apply config.yaml edits to the running zones
+        bool profile = false;                       // --profile: per-section timings, printed after the summary
+        std::string profileTracePath;               // --profile-trace: also write a Chrome trace_event JSON file
+        std::string sensorEndpoint;                 // --sensor-listen: live device readings instead of the weather/soil models
+        double sensorMaxAge = 30.0;                 // --sensor-max-age: older readings count as sensor failures
+        bool seedSet = false;
+        bool zonesSet = false;
         // --- CLI ARG PARSING ---
         for (int i = 1; i < argc; ++i) {
             std::string arg = argv[i];
@@ -45,184 +89,547 @@ int main(int argc, char* argv[]) {
                     std::cerr << "Usage: --duration <number>[s|m|h|d]" << std::endl;
                     return 11;
                 }
+            } else if (arg == "--step" && i + 1 < argc) {
+                ++i; // Parsed below, after the config file is loaded
+            } else if (arg == "--fast" || arg == "--realtime=off") {
+                realtime = false;
+            } else if (arg == "--realtime=on") {
+                realtime = true;
+            } else if (arg == "--overrun" && i + 1 < argc) {
+                std::string policy = argv[++i];
+                if (policy == "catchup") {
+                    overrunPolicy = OverrunPolicy::CatchUp;
+                } else if (policy == "realign") {
+                    overrunPolicy = OverrunPolicy::Realign;
+                } else {
+                    std::cerr << "Invalid overrun policy: " << policy << " (expected catchup or realign)" << std::endl;
+                    return 25;
+                }
+            } else if (arg == "--log-format" && i + 1 < argc) {
+                std::string fmt = argv[++i];
+                if (fmt == "csv") {
+                    logFormat = LogFormat::Csv;
+                } else if (fmt == "binary") {
+                    logFormat = LogFormat::Binary;
+                } else if (fmt == "none") {
+                    logFormat = LogFormat::None;
+                } else if (fmt == "events") {
+                    logFormat = LogFormat::None; // Written by EventLogWriter below
+                    eventLog = true;
+                } else if (fmt == "rollup") {
+                    logFormat = LogFormat::None; // Rollups only
+                    rollups = true;
+                } else {
+                    std::cerr << "Invalid log format: " << fmt << " (expected csv, binary, events, rollup or none)" << std::endl;
+                    return 13;
+                }
+            } else if (arg == "--async-log" && i + 1 < argc) {
+                std::string mode = argv[++i];
+                asyncLog = true;
+                if (mode == "block") {
+                    logBackpressure = Backpressure::Block;
+                } else if (mode == "drop") {
+                    logBackpressure = Backpressure::Drop;
+                } else {
+                    std::cerr << "Invalid async log mode: " << mode << " (expected block or drop)" << std::endl;
+                    return 14;
+                }
+            } else if (arg == "--log-queue" && i + 1 < argc) {
+                logQueueCapacity = static_cast<size_t>(std::stoul(argv[++i]));
+            } else if (arg == "--zones" && i + 1 < argc) {
+                zones = std::stoi(argv[++i]);
+                zonesSet = true;
+            } else if (arg == "--threads" && i + 1 < argc) {
+                std::string t = argv[++i];
+                threads = t == "auto" ? static_cast<int>(std::thread::hardware_concurrency()) : std::stoi(t);
+            } else if (arg == "--max-pumps" && i + 1 < argc) {
+                maxPumps = std::stoi(argv[++i]);
+            } else if (arg == "--pump-arbiter" && i + 1 < argc) {
+                std::string mode = argv[++i];
+                if (mode == "fcfs") {
+                    priorityPumps = false;
+                } else if (mode == "priority") {
+                    priorityPumps = true;
+                } else {
+                    std::cerr << "Invalid pump arbiter: " << mode << " (expected fcfs or priority)" << std::endl;
+                    return 26;
+                }
+            } else if (arg == "--seed" && i + 1 < argc) {
+                seed = std::stoull(argv[++i]);
+                seedSet = true;
+            } else if (arg == "--engine" && i + 1 < argc) {
+                std::string engine = argv[++i];
+                if (engine == "tick") {
+                    eventEngine = false;
+                } else if (engine == "event") {
+                    eventEngine = true;
+                } else {
+                    std::cerr << "Invalid engine: " << engine << " (expected tick or event)" << std::endl;
+                    return 16;
+                }
+            } else if (arg == "--weather-resolution" && i + 1 < argc) {
+                weatherResolution = std::stoi(argv[++i]);
+            } else if (arg == "--sweep" && i + 1 < argc) {
+                sweepPath = argv[++i];
+            } else if (arg == "--sweep-output" && i + 1 < argc) {
+                sweepOutput = argv[++i];
+            } else if (arg == "--keyframe-interval" && i + 1 < argc) {
+                keyframeInterval = std::stoi(argv[++i]);
+            } else if (arg == "--rollups") {
+                rollups = true;
+            } else if (arg == "--rollup-output" && i + 1 < argc) {
+                rollupPath = argv[++i];
+                rollups = true;
+            } else if (arg == "--log-index") {
+                logIndex = true;
+            } else if (arg == "--weather-trace" && i + 1 < argc) {
+                tracePath = argv[++i];
+            } else if (arg == "--checkpoint" && i + 1 < argc) {
+                checkpointPath = argv[++i];
+            } else if (arg == "--resume" && i + 1 < argc) {
+                resumePath = argv[++i];
+            } else if (arg == "--watch-config") {
+                watchConfig = true;
+            } else if (arg == "--profile") {
+                profile = true;
+            } else if (arg == "--profile-trace" && i + 1 < argc) {
+                profileTracePath = argv[++i];
+                profile = true;
+            } else if (arg == "--sensor-listen" && i + 1 < argc) {
+                sensorEndpoint = argv[++i];
+            } else if (arg == "--sensor-max-age" && i + 1 < argc) {
+                sensorMaxAge = std::stod(argv[++i]);
             } else if (arg == "--help" || arg == "-h") {
-                std::cout << "Usage: " << argv[0] << " [--configuration <file>] [--duration <number>[s|m|h|d]]" << std::endl;
+                std::cout << "Usage: " << argv[0] << " [--configuration <file>] [--duration <number>[s|m|h|d]] [--step <seconds>] [--fast|--realtime=off] [--overrun catchup|realign] [--log-format csv|binary|events|rollup|none] [--keyframe-interval <steps>] [--rollups] [--rollup-output <file>] [--log-index] [--async-log block|drop] [--log-queue <records>] [--zones <n>] [--threads <n>|auto] [--max-pumps <n>] [--pump-arbiter fcfs|priority] [--seed <n>] [--engine tick|event] [--weather-resolution <seconds>] [--sweep <file>] [--sweep-output <file>] [--weather-trace <file.mwx>] [--checkpoint <file>] [--resume <file>] [--watch-config] [--profile] [--profile-trace <file.json>] [--sensor-listen udp:<host>:<port>|unix:<path>] [--sensor-max-age <seconds>]" << std::endl;
                 return 0;
             } else {
                 std::cerr << "Unknown argument: " << arg << std::endl;
-                std::cerr << "Usage: " << argv[0] << " [--configuration <file>] [--duration <number>[s|m|h|d]]" << std::endl;
+                std::cerr << "Usage: " << argv[0] << " [--configuration <file>] [--duration <number>[s|m|h|d]] [--step <seconds>] [--fast|--realtime=off] [--overrun catchup|realign] [--log-format csv|binary|events|rollup|none] [--keyframe-interval <steps>] [--rollups] [--rollup-output <file>] [--log-index] [--async-log block|drop] [--log-queue <records>] [--zones <n>] [--threads <n>|auto] [--max-pumps <n>] [--pump-arbiter fcfs|priority] [--seed <n>] [--engine tick|event] [--weather-resolution <seconds>] [--sweep <file>] [--sweep-output <file>] [--weather-trace <file.mwx>] [--checkpoint <file>] [--resume <file>] [--watch-config] [--profile] [--profile-trace <file.json>] [--sensor-listen udp:<host>:<port>|unix:<path>] [--sensor-max-age <seconds>]" << std::endl;
                 return 12;
             }
         }
+        if (zones < 1 || threads < 1) {
+            std::cerr << "--zones and --threads must be at least 1" << std::endl;
+            return 15;
+        }
         std::cout << "Mysa Irrigation System starting..." << std::endl;
-
-        // --- CONFIG PARSING ---
-        std::map<std::string, std::string> config;
-        std::ifstream configFile(configPath);
-        if (!configFile) {
-            std::cerr << "Failed to open " << configPath << std::endl;
-            return 1;
-        }
-        std::string line;
-        while (std::getline(configFile, line)) {
-            if (line.empty() || line[0] == '#') continue;
-            auto eq = line.find('=');
-            if (eq == std::string::npos) continue;
-            std::string key = line.substr(0, eq);
-            std::string value = line.substr(eq + 1);
-            config[key] = value;
-        }
-        // --- VALIDATE YAML FIELDS ---
-        const char* requiredFields[] = {
-            "plant_water_need_per_day", "plant_stress_threshold", "plant_absorption_rate",
-            "soil_retention_rate", "soil_drainage_factor", "moisture_threshold",
-            "pump_flow_rate", "water_cost", "simulation_duration"
+        if (profile) Profiler::enable(!profileTracePath.empty());
+        // Prints the percentile table and writes the trace once every profiled thread is idle
+        auto finishProfile = [&]() -> bool {
+            if (!profile) return true;
+            Profiler::disable();
+            std::cout << "\n--- Profile (per call, inclusive of nested sections) ---\n";
+            Profiler::printTable(std::cout);
+            if (profileTracePath.empty()) return true;
+            std::string error;
+            if (!Profiler::writeChromeTrace(profileTracePath, error)) {
+                std::cerr << "Failed to write profile trace: " << error << std::endl;
+                return false;
+            }
+            std::cout << "Profile trace saved to: " << profileTracePath;
+            if (Profiler::getDroppedTraceEvents() > 0) {
+                std::cout << " (" << Profiler::getDroppedTraceEvents() << " events over the per-thread limit dropped)";
+            }
+            std::cout << std::endl;
+            return true;
         };
-        for (const char* field : requiredFields) {
-            if (config.find(field) == config.end()) {
-                std::cerr << "Missing required config field: " << field << std::endl;
-                return 2;
-            }
-        }
-        // --- PARSE VALUES ---
-        float plant_water_need_per_day = std::stof(config["plant_water_need_per_day"]);
-        float plant_stress_threshold = std::stof(config["plant_stress_threshold"]);
-        float plant_absorption_rate = std::stof(config["plant_absorption_rate"]);
-        float soil_retention_rate = std::stof(config["soil_retention_rate"]);
-        float soil_drainage_factor = std::stof(config["soil_drainage_factor"]);
-        float moisture_threshold = std::stof(config["moisture_threshold"]);
-        float pump_flow_rate = std::stof(config["pump_flow_rate"]);
-        float water_cost = std::stof(config["water_cost"]);
-        int config_duration = std::stoi(config["simulation_duration"]);
-        float pump_power_watts = 60.0f; // Default value
-        if (config.find("pump_power_watts") != config.end()) {
-            pump_power_watts = std::stof(config["pump_power_watts"]);
+
+        // --- CONFIG PARSING (typed and validated, see include/Config.h) ---
+        Config config;
+        std::string configError;
+        ConfigStatus configStatus = loadConfig(configPath, config, configError);
+        if (configStatus != ConfigStatus::Ok) {
+            std::cerr << configError << std::endl;
+            return configStatus == ConfigStatus::CannotOpen ? 1 : configStatus == ConfigStatus::MissingField ? 2 : 3;
         }
+        SimulationParams params = config.params;
         if (simulation_duration < 0) {
-            simulation_duration = config_duration > 0 ? config_duration : 86400; // Default 1 day
+            simulation_duration = config.simulationDuration > 0 ? config.simulationDuration : 86400; // Default 1 day
         }
-        float simulation_step = 1.0f; // Default step size in seconds
-        // Check for CLI --step argument
+        // CLI --step applies unless config.yaml sets simulation_step
         for (int i = 1; i < argc; ++i) {
             std::string arg = argv[i];
-            if (arg == "--step" && i + 1 < argc) {
-                simulation_step = std::stof(argv[++i]);
+            if (arg == "--step" && i + 1 < argc && !config.has("simulation_step")) {
+                params.simulationStep = std::stof(argv[++i]);
             }
         }
-        if (config.find("simulation_step") != config.end()) {
-            simulation_step = std::stof(config["simulation_step"]);
+        float simulation_step = params.simulationStep;
+        float pump_flow_rate = params.pumpFlowRate;
+        float pump_power_watts = params.pumpPowerWatts;
+        float water_cost = params.waterCost;
+        if (eventEngine && (zones != 1 || simulation_step != 1.0f)) {
+            std::cerr << "--engine event simulates one zone with a 1 s step (--zones 1, simulation_step=1.0)" << std::endl;
+            return 17;
+        }
+        if (priorityPumps && (eventEngine || !sweepPath.empty() || !checkpointPath.empty() || !resumePath.empty())) {
+            // The arbiter's grants and wait queue are not part of a checkpoint, so a resume could exceed --max-pumps
+            std::cerr << "--pump-arbiter priority needs a multi-zone tick-engine run (no --engine event, --sweep, --checkpoint or --resume)" << std::endl;
+            return 26;
+        }
+        if (!sensorEndpoint.empty() && (eventEngine || !sweepPath.empty() || !tracePath.empty() || sensorMaxAge <= 0.0)) {
+            std::cerr << "--sensor-listen needs a tick-engine run without --sweep or --weather-trace, and --sensor-max-age above 0" << std::endl;
+            return 27;
+        }
+        if (logIndex && (logFormat != LogFormat::Csv || !sweepPath.empty())) {
+            std::cerr << "--log-index needs the CSV log of a single run (--log-format csv, no --sweep)" << std::endl;
+            return 28;
+        }
+        if (watchConfig && (eventEngine || !sweepPath.empty())) {
+            std::cerr << "--watch-config needs a single tick-engine run (no --engine event, no --sweep)" << std::endl;
+            return 23;
         }
         // --- INITIALIZE OBJECTS ---
-        WeatherSensor weather;
-        Soil soil(soil_retention_rate, soil_drainage_factor);
-        Plant plant(plant_water_need_per_day, plant_stress_threshold, plant_absorption_rate);
-        WaterPump pump(pump_flow_rate, pump_power_watts);
-        GardenZone zone(&plant, &soil, &weather, &pump);
-        Logger logger("output/output.csv");
-        IrrigationController controller(&soil, &weather, &pump, &logger);
-        controller.setMoistureThreshold(moisture_threshold);
+        params.seed = seed;
+        // Mapped once; every zone and sweep run reads the same pages
+        WeatherTrace weatherTrace;
+        if (!tracePath.empty()) {
+            std::string error;
+            if (!weatherTrace.open(tracePath, error)) {
+                std::cerr << "Invalid weather trace: " << error << std::endl;
+                return 19;
+            }
+            params.weatherTrace = &weatherTrace;
+        }
+        Checkpoint checkpoint;
+        if (!resumePath.empty()) {
+            // The checkpoint's params replace config.yaml's (a sweep varies them from there); --seed and --max-pumps still apply
+            std::string error;
+            if (!loadCheckpoint(resumePath, checkpoint, error)) {
+                std::cerr << "Invalid checkpoint: " << error << std::endl;
+                return 22;
+            }
+            if (eventEngine || (zonesSet && zones != static_cast<int>(checkpoint.zoneStates.size())) ||
+                (!sweepPath.empty() && checkpoint.zoneStates.size() != 1)) {
+                std::cerr << "--resume needs the tick engine and the checkpoint's zone count (" << checkpoint.zoneStates.size()
+                          << "; one zone for --sweep)" << std::endl;
+                return 22;
+            }
+            const WeatherTrace* trace = params.weatherTrace;
+            params = checkpoint.params;
+            params.weatherTrace = trace;
+            if (seedSet) params.seed = seed;
+            seed = params.seed;
+            simulation_step = params.simulationStep;
+            water_cost = params.waterCost;
+            pump_flow_rate = params.pumpFlowRate;
+            pump_power_watts = params.pumpPowerWatts;
+            zones = static_cast<int>(checkpoint.zoneStates.size());
+            if (maxPumps <= 0) maxPumps = checkpoint.maxPumps;
+        }
+        if (eventEngine && !checkpointPath.empty()) {
+            std::cerr << "--checkpoint needs the tick engine (--engine tick)" << std::endl;
+            return 22;
+        }
+        if (eventEngine && params.plannerEnabled) {
+            std::cerr << "planner_enabled needs the tick engine (--engine tick)" << std::endl;
+            return 29;
+        }
+        if (maxPumps > 0) GardenZone::setMaxConcurrentPumps(maxPumps);
+        if (!sweepPath.empty()) {
+            // --- PARAMETER SWEEP: one zone per run, summaries only, runs spread over the worker threads ---
+            SweepSpec spec;
+            std::string error;
+            if (!loadSweepSpec(sweepPath, spec, error)) {
+                std::cerr << "Invalid sweep file: " << error << std::endl;
+                return 18;
+            }
+            std::vector<SweepRun> runs = expandSweep(spec, params);
+            std::vector<SweepResult> sweepResults(runs.size());
+            int pumpBudget = GardenZone::getMaxConcurrentPumps();
+            ZoneScheduler sweepScheduler(static_cast<size_t>(threads), 1);
+            if (!resumePath.empty()) {
+                std::cout << "Forking from: " << resumePath << " at " << checkpoint.secondsElapsed << " s" << std::endl;
+            }
+            std::cout << "Sweep: " << runs.size() << " runs of " << simulation_duration << " s on "
+                      << sweepScheduler.getThreadCount() << " threads (" << (eventEngine ? "event" : "tick") << " engine)" << std::endl;
+            auto sweepStart = std::chrono::steady_clock::now();
+            sweepScheduler.runTick(runs.size(), [&](size_t r) {
+                sweepResults[r] = runSweepSimulation(runs[r].params, simulation_duration, eventEngine, pumpBudget,
+                                                     resumePath.empty() ? nullptr : &checkpoint);
+            });
+            double sweepSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - sweepStart).count();
+            std::ofstream sweepFile(sweepOutput);
+            if (!sweepFile) {
+                std::cerr << "Failed to open " << sweepOutput << std::endl;
+                return 1;
+            }
+            writeSweepResults(sweepFile, spec, runs, sweepResults);
+            std::cout << "Wall time: " << std::fixed << std::setprecision(3) << sweepSeconds << " s" << std::endl;
+            std::cout << "Sweep results saved to: " << sweepOutput << std::endl;
+            return finishProfile() ? 0 : 24;
+        }
+        std::string soil_type = resumePath.empty() ? "Loam" : checkpoint.soilTypes[0];
+        std::vector<std::unique_ptr<ZoneSimulation>> sims;
+        for (int z = 0; z < zones; ++z) {
+            std::string zoneId = resumePath.empty() ? "Zone" + std::to_string(z + 1) : checkpoint.zoneIds[z];
+            sims.emplace_back(new ZoneSimulation(params, static_cast<uint32_t>(z), zoneId, soil_type));
+            if (!resumePath.empty() && !restoreZone(checkpoint, static_cast<size_t>(z), *sims.back())) {
+                std::cerr << "Invalid checkpoint: corrupt state for " << zoneId << std::endl;
+                return 22;
+            }
+        }
+        if (!resumePath.empty()) GardenZone::siteBudget().setActive(checkpoint.activePumps);
+        // Priority arbitration: zones post their wishes during a tick, permits are granted between ticks
+        std::unique_ptr<PumpArbiter> arbiter;
+        if (priorityPumps) {
+            arbiter.reset(new PumpArbiter(sims.size(), GardenZone::getMaxConcurrentPumps()));
+            for (const auto& sim : sims) sim->setPumpArbiter(arbiter.get());
+        }
+        // Live sensors: the ingestion thread keeps each zone's latest readings; zones sample them once per step
+        SensorSlots sensorSlots(sensorEndpoint.empty() ? 0 : sims.size(), sensorMaxAge);
+        SensorIngestService sensorIngest(sensorSlots);
+        if (!sensorEndpoint.empty()) {
+            std::string error;
+            if (!sensorIngest.start(sensorEndpoint, error)) {
+                std::cerr << "Cannot listen for sensors: " << error << std::endl;
+                return 27;
+            }
+            for (const auto& sim : sims) sim->setSensorSlots(&sensorSlots);
+            std::cout << "Listening for sensor readings on " << sensorEndpoint;
+            if (sensorIngest.getPort() > 0) std::cout << " (port " << sensorIngest.getPort() << ")";
+            std::cout << std::endl;
+        }
+        // Live config: every zone reads the published version once per step; the watcher thread swaps in edits
+        ConfigChannel liveConfig(params);
+        ConfigWatcher configWatcher(configPath, liveConfig);
+        uint64_t configVersion = 0;
+        if (watchConfig) {
+            std::string error;
+            if (!configWatcher.start(error)) {
+                std::cerr << "Cannot watch config: " << error << std::endl;
+                return 23;
+            }
+            for (const auto& sim : sims) sim->setConfigChannel(&liveConfig);
+        }
+        ZoneScheduler scheduler(static_cast<size_t>(threads));
+        std::string logPath = logFormat == LogFormat::Binary ? "output/output.mlog" : "output/output.csv";
+        AsyncLogSink* asyncSink = nullptr; // Owned by logger; kept for queue statistics
+        std::string indexPath = logPath + ".idx";
+        std::unique_ptr<LogSink> sink = makeFileLogSink(logPath, logFormat);
+        if (logIndex && !static_cast<CsvLogSink*>(sink.get())->enableIndex(indexPath)) {
+            std::cerr << "Failed to open log index file: " << indexPath << std::endl;
+            return 28;
+        }
+        if (asyncLog && sink) {
+            asyncSink = new AsyncLogSink(std::move(sink), logQueueCapacity, logBackpressure);
+            sink.reset(asyncSink);
+        }
+        Logger logger(std::move(sink));
+        if (!resumePath.empty() && !restoreLogger(checkpoint, logger)) {
+            std::cerr << "Invalid checkpoint: corrupt logger state" << std::endl;
+            return 22;
+        }
+        if (rollups && !logger.enableRollups(rollupPath)) {
+            std::cerr << "Failed to open rollup file: " << rollupPath << std::endl;
+            return 20;
+        }
+        std::string eventLogPath = "output/events.mevt";
+        std::unique_ptr<EventLogWriter> events;
+        if (eventLog) {
+            if (eventEngine) {
+                std::cerr << "--log-format events needs the tick engine (--engine tick)" << std::endl;
+                return 21;
+            }
+            events.reset(new EventLogWriter(eventLogPath, keyframeInterval));
+            for (const auto& sim : sims) {
+                events->declareZone(sim->getZoneId(), soil_type, sim->getFlowRate(), pump_power_watts, simulation_step);
+            }
+        }
 
         int steps = static_cast<int>(simulation_duration / simulation_step);
-        float secondsElapsed = 0.0f;
-        int weatherFailureStart = -1;
-        int soilFailureStart = -1;
-        int zones = 1;
-        std::string zone_id = "Zone1";
-        std::string soil_type = "Loam";
+        int64_t firstStep = resumePath.empty() ? 0 : checkpoint.nextStep;
+        float secondsElapsed = resumePath.empty() ? 0.0f : checkpoint.secondsElapsed;
+        int startSeconds = static_cast<int>(secondsElapsed);
         float flow_rate = pump_flow_rate;
-        for (int i = 0; i < steps; ++i) { // Simulate for configured duration
-            // Simulate a simple forecast: if rain is likely in the next 10s, set forecastRain
-            bool rainLikely = (weather.getRainfall() > 2.0f);
-            controller.setForecastRain(rainLikely);
-            controller.update(secondsElapsed);
-            zone.update(secondsElapsed);
-            // Detect and handle weather sensor failure
-            bool weatherFailed = weather.hasFailed();
-            if (weatherFailed && weatherFailureStart == -1) {
-                weatherFailureStart = secondsElapsed;
-                std::cout << "[WARN] Weather sensor failure detected. Using fallback values." << std::endl;
-            }
-            if (weatherFailed && weatherFailureStart != -1 && secondsElapsed - weatherFailureStart > 10) {
-                weather.resetFailure();
-                weatherFailureStart = -1;
-                std::cout << "[INFO] Weather sensor automatically reset after 10s of failure." << std::endl;
-            }
-            // Detect and handle soil sensor failure
-            bool soilFailed = (soil.getMoisture() < 0);
-            if (soilFailed && soilFailureStart == -1) {
-                soilFailureStart = secondsElapsed;
-                std::cout << "[WARN] Soil sensor failure detected. Using fallback values." << std::endl;
-            }
-            if (soilFailed && soilFailureStart != -1 && secondsElapsed - soilFailureStart > 10) {
-                soil.resetFailure();
-                soilFailureStart = -1;
-                std::cout << "[INFO] Soil sensor automatically reset after 10s of failure." << std::endl;
-            }
-            // Use fallback values for display if failed
-            float displayTemp = weatherFailed ? controller.getLastKnownTemperature() : weather.getTemperature();
-            float displayHumidity = weatherFailed ? controller.getLastKnownHumidity() : weather.getHumidity();
-            float displayRain = weatherFailed ? controller.getLastKnownRainfall() : weather.getRainfall();
-            float displaySoil = soilFailed ? controller.getLastKnownSoilMoisture() : soil.getMoisture();
-            // Effective moisture calculation (match controller logic)
-            float noise = (std::rand() % 100 - 50) / 100.0f;
-            float noisyMoisture = displaySoil + noise;
-            float evap = (displayTemp / 30.0f) * (1.0f - displayHumidity / 100.0f) * 0.05f;
-            float effectiveMoisture = noisyMoisture + displayRain - evap;
-            bool sensorError = weatherFailed || soilFailed;
-            // All per-second calculations now scale by simulation_step
-            float waterUsed = pump.isOn() ? pump_flow_rate * (simulation_step / 60.0f) : 0.0f; // L per step
-            float powerUsed = pump.isOn() ? pump.getPowerWatts() * (simulation_step / 3600.0f) : 0.0f; // Wh per step
-            // Log per-step data in new CSV format
-            logger.logSecond(
-                static_cast<int>(secondsElapsed),
-                displaySoil,
-                effectiveMoisture,
-                displayTemp,
-                displayHumidity,
-                displayRain,
-                pump.isOn(),
-                flow_rate,
-                waterUsed,
-                plant.getStress(),
-                sensorError,
-                zone_id,
-                soil_type,
-                powerUsed // New field for power consumption
-            );
-            // Print per-second output (optional, can be commented for long runs)
-            std::cout << "Time: " << secondsElapsed << "s | Temp: " << displayTemp
-                      << "C | Humidity: " << displayHumidity << "% | Rain: " << displayRain
-                      << "mm | Soil Moisture: " << displaySoil << "% | Effective Moisture: " << effectiveMoisture
-                      << "% | Plant Stress: " << plant.getStress()
-                      << "% | Pump: " << (pump.isOn() ? "ON" : "OFF")
-                      << " | Forecast Rain: " << (rainLikely ? "YES" : "NO");
-            if (weatherFailed) std::cout << " [FALLBACK:Weather]";
-            if (soilFailed) std::cout << " [FALLBACK:Soil]";
-            std::cout << std::endl;
-            if (simulation_step >= 0.01f) {
-                std::this_thread::sleep_for(std::chrono::milliseconds(static_cast<int>(simulation_step * 1000)));
+        std::vector<ZoneStepResult> results(zones);
+        std::function<void(size_t)> stepZone = [&sims, &results, &secondsElapsed](size_t z) {
+            results[z] = sims[z]->step(secondsElapsed);
+        };
+        // Fast-forward mode: progress line is redrawn at most every 500 ms of wall time
+        auto wallStart = std::chrono::steady_clock::now();
+        auto lastProgress = wallStart;
+        // Real-time mode: step k starts at wall start + k * step, however long the steps take
+        DeadlineScheduler pacer(simulation_step, overrunPolicy);
+        pacer.start();
+        EventRunStats eventStats;
+        if (eventEngine) {
+            // Exact ticks only at events, closed-form spans in between; the tick loop below is skipped
+            EventSimulation eventSim(params, 0, sims[0]->getZoneId(), soil_type);
+            eventSim.setWeatherResolution(weatherResolution);
+            eventStats = eventSim.run(simulation_duration, logger);
+        }
+        int tickSteps = eventEngine ? 0 : steps;
+        for (int i = 0; i < tickSteps; ++i) { // Simulate for configured duration
+            // Zones update in parallel; logging and console output stay on this thread, in zone order
+            scheduler.runTick(sims.size(), stepZone);
+            if (arbiter) arbiter->arbitrate(static_cast<int>(secondsElapsed));
+            if (watchConfig && liveConfig.current()->version != configVersion) {
+                configVersion = liveConfig.current()->version;
+                if (!realtime) std::cout << std::endl;
+                std::cout << "[INFO] Config reloaded (version " << configVersion << ") at " << secondsElapsed << "s" << std::endl;
+            }
+            for (int z = 0; z < zones; ++z) {
+                const ZoneStepResult& r = results[z];
+                const std::string& zone_id = sims[z]->getZoneId();
+                std::string prefix = zones > 1 ? "[" + zone_id + "] " : "";
+                if (realtime) {
+                    if (r.weatherFailureDetected) std::cout << prefix << "[WARN] Weather sensor failure detected. Using fallback values." << std::endl;
+                    if (r.weatherFailureReset) std::cout << prefix << "[INFO] Weather sensor automatically reset after 10s of failure." << std::endl;
+                    if (r.soilFailureDetected) std::cout << prefix << "[WARN] Soil sensor failure detected. Using fallback values." << std::endl;
+                    if (r.soilFailureReset) std::cout << prefix << "[INFO] Soil sensor automatically reset after 10s of failure." << std::endl;
+                }
+                // Log per-step data in new CSV format
+                logger.logSecond(
+                    r.time_s,
+                    r.soilMoisture,
+                    r.effectiveMoisture,
+                    r.temperature,
+                    r.humidity,
+                    r.rainfall,
+                    r.pumpOn,
+                    flow_rate,
+                    r.waterUsed,
+                    r.plantStress,
+                    r.weatherFailed || r.soilFailed,
+                    zone_id,
+                    soil_type,
+                    r.powerUsed // New field for power consumption
+                );
+                if (events) events->record(z, firstStep + i, r);
+                if (realtime) {
+                    // Print per-second output (optional, can be commented for long runs)
+                    std::cout << prefix << "Time: " << secondsElapsed << "s | Temp: " << r.temperature
+                              << "C | Humidity: " << r.humidity << "% | Rain: " << r.rainfall
+                              << "mm | Soil Moisture: " << r.soilMoisture << "% | Effective Moisture: " << r.effectiveMoisture
+                              << "% | Plant Stress: " << r.plantStress
+                              << "% | Pump: " << (r.pumpOn ? "ON" : "OFF")
+                              << " | Forecast Rain: " << (r.rainLikely ? "YES" : "NO");
+                    if (r.weatherFailed) std::cout << " [FALLBACK:Weather]";
+                    if (r.soilFailed) std::cout << " [FALLBACK:Soil]";
+                    std::cout << std::endl;
+                }
+            }
+            if (realtime) {
+                pacer.waitForNextPeriod();
+            } else if ((i & 1023) == 0 || i + 1 == steps) {
+                // Only look at the clock every 1024 steps; redraw the status line in place
+                auto now = std::chrono::steady_clock::now();
+                if (now - lastProgress >= std::chrono::milliseconds(500) || i + 1 == steps) {
+                    lastProgress = now;
+                    const ZoneStepResult& r = results[0];
+                    std::cout << "\r[" << std::fixed << std::setprecision(1)
+                              << (100.0f * (i + 1) / steps) << "%] Day " << static_cast<int>(secondsElapsed / 86400)
+                              << " | Soil Moisture: " << r.soilMoisture << "% | Plant Stress: " << r.plantStress
+                              << "% | Pump: " << (r.pumpOn ? "ON " : "OFF");
+                    if (zones > 1) std::cout << " (Zone1 of " << zones << ", " << (arbiter ? arbiter->getActive() : GardenZone::getActivePumpCount()) << " pumps active)";
+                    std::cout << std::flush;
+                }
             }
             secondsElapsed += simulation_step;
         }
         logger.finalize();
+        configWatcher.stop();
+        sensorIngest.stop();
+        water_cost = liveConfig.current()->params.waterCost;
+        if (events) events->finish(firstStep + tickSteps);
+        if (!checkpointPath.empty()) {
+            Checkpoint end = captureCheckpoint(liveConfig.current()->params, firstStep + tickSteps, secondsElapsed, sims, GardenZone::siteBudget(), logger);
+            if (!saveCheckpoint(checkpointPath, end)) {
+                std::cerr << "Failed to write checkpoint: " << checkpointPath << std::endl;
+                return 1;
+            }
+        }
+        double wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+        if (!realtime) std::cout << std::endl;
         // --- END SUMMARY ---
         std::cout << std::fixed << std::setprecision(1);
         std::cout << "\n--- Simulation Summary ---\n";
-        int daysSimulated = simulation_duration / 86400;
-        std::cout << "Duration simulated: " << daysSimulated << " days (" << simulation_duration << " seconds)\n";
+        // After --resume the totals include the checkpointed run, so they are reported over the whole span
+        int totalDuration = startSeconds + simulation_duration;
+        int daysSimulated = totalDuration / 86400;
+        std::cout << "Duration simulated: " << daysSimulated << " days (" << totalDuration << " seconds)\n";
+        if (!resumePath.empty()) {
+            std::cout << "Resumed from: " << resumePath << " at " << startSeconds << " s" << std::endl;
+        }
         std::cout << "Simulation step size: " << simulation_step << " seconds" << std::endl;
+        std::cout << "Seed: " << seed << " (rerun with --seed " << seed << " to reproduce)" << std::endl;
+        std::cout << "Mode: " << (realtime ? "real-time" : "fast-forward") << std::endl;
+        if (realtime && pacer.getPeriods() > 0) {
+            std::cout << "Real-time pacing: " << pacer.getPeriods() << " periods, " << pacer.getOverruns()
+                      << " overruns (--overrun " << (overrunPolicy == OverrunPolicy::CatchUp ? "catchup" : "realign")
+                      << "), lateness p50 " << std::setprecision(3) << pacer.latenessPercentileMs(0.50) << " ms, p99 "
+                      << pacer.latenessPercentileMs(0.99) << " ms, max " << pacer.getMaxLatenessMs() << " ms"
+                      << std::setprecision(1) << std::endl;
+            std::cout << "Lateness histogram: ";
+            pacer.printJitter(std::cout);
+            std::cout << std::endl;
+        }
+        if (weatherTrace.isOpen()) {
+            std::cout << "Weather: " << tracePath << " (" << weatherTrace.getSampleCount() << " samples every "
+                      << weatherTrace.getInterval() << " s)" << std::endl;
+        }
+        if (!sensorEndpoint.empty()) {
+            IngestStats ingest = sensorIngest.getStats();
+            std::cout << "Sensors: live from " << sensorEndpoint << ", " << ingest.datagrams << " datagrams, "
+                      << ingest.readings << " readings, " << ingest.malformed << " malformed, " << ingest.unknownZone
+                      << " for unknown zones (stale after " << sensorMaxAge << " s)" << std::endl;
+        }
+        if (watchConfig) {
+            std::cout << "Config: " << configVersion << " live reloads of " << configPath << " ("
+                      << configWatcher.getRejectedCount() << " rejected edits)" << std::endl;
+        }
+        if (eventEngine) {
+            std::cout << "Engine: event-driven (" << eventStats.exactTicks << " exact ticks, " << eventStats.skippedTicks
+                      << " ticks in " << eventStats.spans << " closed-form spans, weather resolution "
+                      << weatherResolution << " s)" << std::endl;
+        }
+        std::cout << "Wall time: " << std::setprecision(3) << wallSeconds << " s";
+        if (wallSeconds > 0.0) {
+            std::cout << " (" << std::setprecision(0) << (steps * simulation_step) / wallSeconds << " simulated s per wall s)";
+        }
+        std::cout << std::setprecision(1) << std::endl;
         std::cout << "\n💧 Total water used: " << logger.getTotalWaterUsed() << " liters" << std::endl;
         std::cout << "🔌 Total power used: " << logger.getTotalPowerUsed() << " Wh" << std::endl;
-        std::cout << "💰 Average daily water cost: $" << logger.getAverageDailyCost(water_cost, simulation_duration) << std::endl;
+        std::cout << "💰 Average daily water cost: $" << logger.getAverageDailyCost(water_cost, totalDuration) << std::endl;
         std::cout << "📊 Average plant stress level: " << logger.getAveragePlantStress() << "%" << std::endl;
         std::cout << "🌿 Watering efficiency: " << logger.getWaterEfficiency() << "%" << std::endl;
         std::cout << "🛠️ Sensor failure events: " << logger.getSensorFailureEvents() << std::endl;
-        std::cout << "\nZones: " << zones << std::endl;
+        std::cout << "\nZones: " << zones << " (" << scheduler.getThreadCount() << " threads, "
+                  << scheduler.getStealCount() << " chunks stolen)" << std::endl;
+        if (arbiter) {
+            ArbiterStats pumps = arbiter->getStats(static_cast<int>(secondsElapsed));
+            std::cout << "Pump arbiter: priority, " << arbiter->getMaxActive() << " permits, " << pumps.grants
+                      << " grants, wait mean " << std::setprecision(1) << pumps.meanWaitSeconds << " s / max "
+                      << pumps.maxWaitSeconds << " s, " << pumps.waitingZones << " zones waiting, "
+                      << pumps.starvedZones << " starved (> 1 h), fairness " << std::setprecision(3)
+                      << pumps.fairness << ", " << pumps.heapUpdates << " heap updates" << std::setprecision(1) << std::endl;
+        }
         std::cout << "Soil Type: " << soil_type << std::endl;
         std::cout << "Pump Flow Rate: " << flow_rate << " L/min" << std::endl;
-        std::cout << "\nCSV log saved to: output/simulation_log.csv" << std::endl;
+        if (asyncSink) {
+            std::cout << "\nAsync log queue: " << asyncSink->getWrittenRecords() << " records written, "
+                      << asyncSink->getDroppedRecords() << " dropped, high-water mark "
+                      << asyncSink->getHighWaterMark() << "/" << asyncSink->getQueueCapacity() << std::endl;
+        }
+        if (logFormat != LogFormat::None) {
+            std::cout << "\n" << (logFormat == LogFormat::Binary ? "Binary" : "CSV") << " log saved to: " << logPath << std::endl;
+        }
+        if (logIndex) {
+            std::cout << "Block index saved to: " << indexPath << " (query with mysa_log_query)" << std::endl;
+        }
+        if (events) {
+            std::cout << "\nEvent log saved to: " << eventLogPath << " (" << events->getEventCount() << " events, "
+                      << events->getKeyframeCount() << " keyframes for " << tickSteps * zones << " steps)" << std::endl;
+        }
+        if (!checkpointPath.empty()) {
+            std::cout << "Checkpoint saved to: " << checkpointPath << " (step " << firstStep + tickSteps << ", "
+                      << static_cast<int>(secondsElapsed) << " s)" << std::endl;
+        }
+        if (rollups) {
+            std::cout << "Rollups saved to: " << rollupPath << " (" << logger.getRollupRowsWritten() << " rows)" << std::endl;
+        }
         std::cout << "-------------------------" << std::endl;
-        return 0;
+        return finishProfile() ? 0 : 24;
     } catch (const std::invalid_argument& e) {
         std::cerr << "Invalid value in config: " << e.what() << std::endl;
         return 3;
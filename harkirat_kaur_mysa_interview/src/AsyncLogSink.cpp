@@ -0,0 +1,66 @@
+#include "../include/AsyncLogSink.h"
+#include <chrono>
+
+namespace {
+const size_t kBatchSize = 4096;
+}
+
+AsyncLogSink::AsyncLogSink(std::unique_ptr<LogSink> innerSink, size_t queueCapacity, Backpressure policy)
+    : inner(std::move(innerSink)), ring(queueCapacity), policy(policy), batch(new LogRecord[kBatchSize]) {
+    writer = std::thread(&AsyncLogSink::writerLoop, this);
+}
+
+AsyncLogSink::~AsyncLogSink() {
+    stopping.store(true, std::memory_order_release);
+    if (writer.joinable()) writer.join();
+    while (drainBatch() > 0) {}
+    inner->flush();
+}
+
+void AsyncLogSink::defineName(uint16_t id, const std::string& name) {
+    // Names are defined before any record using them is pushed, so no draining is needed
+    std::lock_guard<std::mutex> lock(innerMutex);
+    inner->defineName(id, name);
+}
+
+void AsyncLogSink::write(const LogRecord& record) {
+    while (!ring.push(record)) {
+        if (policy == Backpressure::Drop) {
+            ++dropped;
+            return;
+        }
+        std::this_thread::yield();
+    }
+    ++pushed;
+    size_t depth = ring.size();
+    if (depth > highWaterMark) highWaterMark = depth;
+}
+
+size_t AsyncLogSink::drainBatch() {
+    std::lock_guard<std::mutex> lock(innerMutex);
+    size_t n = ring.popBatch(batch.get(), kBatchSize);
+    for (size_t i = 0; i < n; ++i) inner->write(batch[i]);
+    written.fetch_add(n, std::memory_order_release);
+    return n;
+}
+
+void AsyncLogSink::writerLoop() {
+    int idleSpins = 0;
+    while (!stopping.load(std::memory_order_acquire)) {
+        if (drainBatch() > 0) {
+            idleSpins = 0;
+        } else if (++idleSpins < 64) {
+            std::this_thread::yield();
+        } else {
+            std::this_thread::sleep_for(std::chrono::microseconds(500));
+        }
+    }
+}
+
+void AsyncLogSink::flush() {
+    while (written.load(std::memory_order_acquire) < pushed) {
+        std::this_thread::yield();
+    }
+    std::lock_guard<std::mutex> lock(innerMutex);
+    inner->flush();
+}
@@ -0,0 +1,158 @@
+#include "../include/BinaryLog.h"
+#include "../include/Profiler.h"
+#include <cstring>
+
+namespace {
+const char kMagic[8] = {'M', 'Y', 'S', 'A', 'L', 'O', 'G', '\0'};
+const uint32_t kVersion = 1;
+
+template <typename T>
+void writeRaw(std::ofstream& out, const T& value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+template <typename T>
+void writeColumn(std::ofstream& out, const std::vector<T>& column, size_t rows) {
+    out.write(reinterpret_cast<const char*>(column.data()), rows * sizeof(T));
+}
+template <typename T>
+bool readRaw(std::ifstream& in, T& value) {
+    return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+template <typename T>
+bool readColumn(std::ifstream& in, std::vector<T>& column, size_t rows) {
+    column.resize(rows);
+    return static_cast<bool>(in.read(reinterpret_cast<char*>(column.data()), rows * sizeof(T)));
+}
+} // namespace
+
+BinaryLogSink::BinaryLogSink(const std::string& filename, size_t blockRows)
+    : file(filename, std::ios::binary), blockRows(blockRows > 0 ? blockRows : 1) {
+    file.write(kMagic, sizeof(kMagic));
+    writeRaw(file, kVersion);
+    timeDelta.resize(this->blockRows);
+    for (auto& column : floatColumns) column.resize(this->blockRows);
+    zoneColumn.resize(this->blockRows);
+    soilColumn.resize(this->blockRows);
+    flagColumn.resize(this->blockRows);
+}
+
+BinaryLogSink::~BinaryLogSink() {
+    flush();
+}
+
+void BinaryLogSink::defineName(uint16_t id, const std::string& name) {
+    // Written immediately: the reader applies it before the next block, which is
+    // the first one that can reference the new ID.
+    uint16_t len = static_cast<uint16_t>(name.size() > 0xFFFF ? 0xFFFF : name.size());
+    file.put('N');
+    writeRaw(file, id);
+    writeRaw(file, len);
+    file.write(name.data(), len);
+}
+
+void BinaryLogSink::write(const LogRecord& r) {
+    if (rows > 0) {
+        int64_t delta = static_cast<int64_t>(r.time_s) - lastTime;
+        if (delta < 0 || delta > 0xFFFF) writeBlock();
+    }
+    {
+        ProfileScope profile(ProfileSection::LogFormat);
+        if (rows == 0) {
+            baseTime = r.time_s;
+            timeDelta[0] = 0;
+        } else {
+            timeDelta[rows] = static_cast<uint16_t>(r.time_s - lastTime);
+        }
+        lastTime = r.time_s;
+        floatColumns[0][rows] = r.soil_moisture;
+        floatColumns[1][rows] = r.effective_moisture;
+        floatColumns[2][rows] = r.temp;
+        floatColumns[3][rows] = r.humidity;
+        floatColumns[4][rows] = r.rain;
+        floatColumns[5][rows] = r.flow_rate;
+        floatColumns[6][rows] = r.water_used;
+        floatColumns[7][rows] = r.plant_stress;
+        floatColumns[8][rows] = r.power_used;
+        zoneColumn[rows] = r.zone_id;
+        soilColumn[rows] = r.soil_type;
+        flagColumn[rows] = static_cast<uint8_t>((r.pump_on ? 1 : 0) | (r.sensor_error ? 2 : 0));
+    }
+    if (++rows == blockRows) writeBlock();
+}
+
+void BinaryLogSink::writeBlock() {
+    if (rows == 0) return;
+    ProfileScope profile(ProfileSection::LogWrite);
+    file.put('B');
+    writeRaw(file, static_cast<uint32_t>(rows));
+    writeRaw(file, baseTime);
+    writeColumn(file, timeDelta, rows);
+    for (const auto& column : floatColumns) writeColumn(file, column, rows);
+    writeColumn(file, zoneColumn, rows);
+    writeColumn(file, soilColumn, rows);
+    writeColumn(file, flagColumn, rows);
+    rows = 0;
+}
+
+void BinaryLogSink::flush() {
+    writeBlock();
+    ProfileScope profile(ProfileSection::LogWrite);
+    file.flush();
+}
+
+bool BinaryLogReader::open(const std::string& filename) {
+    file.open(filename, std::ios::binary);
+    char magic[sizeof(kMagic)];
+    uint32_t version = 0;
+    if (!file.read(magic, sizeof(magic)) || std::memcmp(magic, kMagic, sizeof(kMagic)) != 0 ||
+        !readRaw(file, version) || version != kVersion) {
+        error = true;
+        return false;
+    }
+    return true;
+}
+
+bool BinaryLogReader::readBlock(std::vector<LogRecord>& rows) {
+    int tag;
+    while ((tag = file.get()) == 'N') {
+        uint16_t id = 0, len = 0;
+        if (!readRaw(file, id) || !readRaw(file, len)) { error = true; return false; }
+        std::string name(len, '\0');
+        if (len > 0 && !file.read(&name[0], len)) { error = true; return false; }
+        if (dictionary.size() <= id) dictionary.resize(id + 1);
+        dictionary[id] = name;
+    }
+    if (tag == std::char_traits<char>::eof()) return false;
+    uint32_t count = 0;
+    int32_t base = 0;
+    if (tag != 'B' || !readRaw(file, count) || !readRaw(file, base)) { error = true; return false; }
+    std::vector<uint16_t> deltas, zones, soils;
+    std::vector<uint8_t> flags;
+    rows.resize(count);
+    if (!readColumn(file, deltas, count)) { error = true; return false; }
+    int32_t t = base;
+    for (uint32_t i = 0; i < count; ++i) {
+        t += deltas[i];
+        rows[i].time_s = t;
+    }
+    float LogRecord::* fields[9] = {
+        &LogRecord::soil_moisture, &LogRecord::effective_moisture, &LogRecord::temp,
+        &LogRecord::humidity, &LogRecord::rain, &LogRecord::flow_rate,
+        &LogRecord::water_used, &LogRecord::plant_stress, &LogRecord::power_used
+    };
+    for (auto field : fields) {
+        if (!readColumn(file, scratch, count)) { error = true; return false; }
+        for (uint32_t i = 0; i < count; ++i) rows[i].*field = scratch[i];
+    }
+    if (!readColumn(file, zones, count) || !readColumn(file, soils, count) || !readColumn(file, flags, count)) {
+        error = true;
+        return false;
+    }
+    for (uint32_t i = 0; i < count; ++i) {
+        rows[i].zone_id = zones[i];
+        rows[i].soil_type = soils[i];
+        rows[i].pump_on = (flags[i] & 1) != 0;
+        rows[i].sensor_error = (flags[i] & 2) != 0;
+    }
+    return true;
+}
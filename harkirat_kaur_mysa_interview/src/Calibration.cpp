@@ -0,0 +1,419 @@
+#include "../include/Calibration.h"
+#include "../include/ZoneScheduler.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+void ObservedSeries::add(float evap, float w, float m, float s) {
+    evapotranspiration.push_back(evap);
+    water.push_back(w);
+    moisture.push_back(m);
+    stress.push_back(s);
+    if (s > 0.0f) ++stressedRows;
+}
+
+void ObservedSeries::anchor(float m, float s) {
+    Anchor a = {size(), m, s};
+    if (!anchors.empty() && anchors.back().index == a.index) {
+        anchors.back() = a; // Nothing was replayed from the previous one
+    } else {
+        anchors.push_back(a);
+    }
+}
+
+bool loadObservedSeries(std::istream& csv, const std::string& zone, ObservedSeries& series, std::string& error) {
+    series = ObservedSeries();
+    std::string line;
+    if (!std::getline(csv, line)) {
+        error = "empty log";
+        return false;
+    }
+    // Columns by header name (the units after each name vary)
+    enum { Moisture, Temperature, Humidity, Rainfall, Pump, Flow, Stress, SensorError, Zone, kColumns };
+    const char* const kNames[kColumns] = {"SoilMoisture", "Temperature", "Humidity", "Rainfall", "PumpState",
+                                          "FlowRate", "PlantStress", "SensorError", "ZoneID"};
+    int column[kColumns];
+    std::fill(column, column + kColumns, -1);
+    size_t start = 0;
+    for (int c = 0; start <= line.size(); ++c) {
+        size_t end = line.find(',', start);
+        if (end == std::string::npos) end = line.size();
+        for (int k = 0; k < kColumns; ++k) {
+            size_t length = std::strlen(kNames[k]);
+            if (column[k] < 0 && line.compare(start, length, kNames[k]) == 0) column[k] = c;
+        }
+        start = end + 1;
+    }
+    for (int k = Moisture; k <= Rainfall; ++k) {
+        if (column[k] < 0) {
+            error = std::string("no ") + kNames[k] + " column (expected a CSV log in output.csv's layout)";
+            return false;
+        }
+    }
+    int lastColumn = *std::max_element(column, column + kColumns);
+    std::string selected = zone;
+    std::vector<std::string> field;
+    bool continuous = false;
+    int lineNumber = 1;
+    while (std::getline(csv, line)) {
+        ++lineNumber;
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line.find_first_not_of(" \t") == std::string::npos) continue;
+        field.clear();
+        size_t from = 0;
+        while (true) {
+            size_t comma = line.find(',', from);
+            field.push_back(line.substr(from, comma == std::string::npos ? std::string::npos : comma - from));
+            if (comma == std::string::npos) break;
+            from = comma + 1;
+        }
+        if (field.size() <= static_cast<size_t>(lastColumn)) {
+            error = "line " + std::to_string(lineNumber) + ": too few columns";
+            return false;
+        }
+        if (column[Zone] >= 0) {
+            if (selected.empty()) selected = field[column[Zone]];
+            if (field[column[Zone]] != selected) continue;
+        }
+        float values[kColumns] = {};
+        for (int k = 0; k < kColumns; ++k) {
+            if (column[k] < 0 || k == Pump || k == SensorError || k == Zone) continue;
+            char* end = nullptr;
+            values[k] = std::strtof(field[column[k]].c_str(), &end);
+            if (end == field[column[k]].c_str()) {
+                error = "line " + std::to_string(lineNumber) + ": " + kNames[k] + " is not a number";
+                return false;
+            }
+        }
+        bool pumpOn = column[Pump] >= 0 && field[column[Pump]] == "ON";
+        if (column[SensorError] >= 0 && field[column[SensorError]] == "TRUE") {
+            continuous = false;
+            continue;
+        }
+        if (!continuous) { // Start, or restart after flagged rows, from this measurement
+            series.anchor(values[Moisture], values[Stress]);
+            continuous = true;
+            continue;
+        }
+        // GardenZone's forcing for the step, from the logged weather and pump state
+        float evapotranspiration = (values[Temperature] / 30.0f) * (1.0f - values[Humidity] / 100.0f) * 0.05f;
+        float irrigation = pumpOn ? values[Flow] / 60.0f : 0.0f;
+        series.add(evapotranspiration, values[Rainfall] + irrigation, values[Moisture], values[Stress]);
+    }
+    if (series.size() == 0) {
+        error = selected.empty() ? "fewer than two rows" : "fewer than two rows for zone " + selected;
+        return false;
+    }
+    return true;
+}
+
+FitError evaluateFit(const ObservedSeries& series, const SoilPlantParams& params, float waterNeedPerDay,
+                     size_t segmentSteps) {
+    const float* evapotranspiration = series.evapotranspiration.data();
+    const float* water = series.water.data();
+    const float* observedMoisture = series.moisture.data();
+    const float* observedStress = series.stress.data();
+    const size_t n = series.size();
+    const float retention = params.soilRetentionRate;
+    const float kept = 1.0f - params.soilDrainageFactor;
+    const float absorption = params.plantAbsorptionRate;
+    const float need = waterNeedPerDay / 86400.0f;
+    const size_t segment = segmentSteps > 0 ? segmentSteps : n;
+    float moisture = 0.0f, stress = 0.0f;
+    double moistureSquared = 0.0, stressSquared = 0.0;
+    size_t next = 0; // Next anchor
+    for (size_t begin = 0; begin < n;) {
+        if (next < series.anchors.size() && series.anchors[next].index == begin) {
+            moisture = series.anchors[next].moisture;
+            stress = series.anchors[next].stress;
+            ++next;
+        } else if (begin > 0) {
+            moisture = observedMoisture[begin - 1];
+            stress = observedStress[begin - 1];
+        }
+        size_t end = std::min(n, begin + segment);
+        if (next < series.anchors.size()) end = std::min(end, series.anchors[next].index);
+        for (size_t i = begin; i < end; ++i) {
+            // Soil::update
+            moisture += water[i] * retention;
+            moisture -= evapotranspiration[i] * kept;
+            moisture = std::min(100.0f, std::max(0.0f, moisture));
+            // Plant::update
+            float absorbed = moisture * absorption;
+            stress += absorbed < need ? (need - absorbed) * 10.0f : -0.1f;
+            stress = std::min(100.0f, std::max(0.0f, stress));
+            float dm = moisture - observedMoisture[i];
+            float ds = stress - observedStress[i];
+            moistureSquared += dm * dm;
+            stressSquared += ds * ds;
+        }
+        begin = end;
+    }
+    FitError e;
+    e.moistureSquared = moistureSquared;
+    e.stressSquared = stressSquared;
+    e.rows = static_cast<uint32_t>(n);
+    return e;
+}
+
+void evaluateFitBatch(const ObservedSeries& series, const SoilPlantParams* params, size_t count,
+                      float waterNeedPerDay, size_t segmentSteps, FitError* out) {
+    size_t c = 0;
+#if defined(__SSE2__)
+    const float* evapotranspiration = series.evapotranspiration.data();
+    const float* water = series.water.data();
+    const float* observedMoisture = series.moisture.data();
+    const float* observedStress = series.stress.data();
+    const size_t n = series.size();
+    const size_t segment = segmentSteps > 0 ? segmentSteps : n;
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 hundred = _mm_set1_ps(100.0f);
+    const __m128 ten = _mm_set1_ps(10.0f);
+    const __m128 recovery = _mm_set1_ps(-0.1f);
+    const __m128 need = _mm_set1_ps(waterNeedPerDay / 86400.0f);
+    for (; c + 4 <= count; c += 4) {
+        const SoilPlantParams* p = params + c;
+        const __m128 retention = _mm_setr_ps(p[0].soilRetentionRate, p[1].soilRetentionRate,
+                                             p[2].soilRetentionRate, p[3].soilRetentionRate);
+        const __m128 kept = _mm_setr_ps(1.0f - p[0].soilDrainageFactor, 1.0f - p[1].soilDrainageFactor,
+                                        1.0f - p[2].soilDrainageFactor, 1.0f - p[3].soilDrainageFactor);
+        const __m128 absorption = _mm_setr_ps(p[0].plantAbsorptionRate, p[1].plantAbsorptionRate,
+                                              p[2].plantAbsorptionRate, p[3].plantAbsorptionRate);
+        __m128 moisture = zero, stress = zero;
+        // Squared errors are summed in double like the scalar kernel: lanes 0-1 and 2-3
+        __m128d moistureLo = _mm_setzero_pd(), moistureHi = _mm_setzero_pd();
+        __m128d stressLo = _mm_setzero_pd(), stressHi = _mm_setzero_pd();
+        size_t next = 0;
+        for (size_t begin = 0; begin < n;) {
+            if (next < series.anchors.size() && series.anchors[next].index == begin) {
+                moisture = _mm_set1_ps(series.anchors[next].moisture);
+                stress = _mm_set1_ps(series.anchors[next].stress);
+                ++next;
+            } else if (begin > 0) {
+                moisture = _mm_set1_ps(observedMoisture[begin - 1]);
+                stress = _mm_set1_ps(observedStress[begin - 1]);
+            }
+            size_t end = std::min(n, begin + segment);
+            if (next < series.anchors.size()) end = std::min(end, series.anchors[next].index);
+            for (size_t i = begin; i < end; ++i) {
+                moisture = _mm_add_ps(moisture, _mm_mul_ps(_mm_set1_ps(water[i]), retention));
+                moisture = _mm_sub_ps(moisture, _mm_mul_ps(_mm_set1_ps(evapotranspiration[i]), kept));
+                moisture = _mm_min_ps(hundred, _mm_max_ps(zero, moisture));
+                __m128 absorbed = _mm_mul_ps(moisture, absorption);
+                __m128 stressed = _mm_cmplt_ps(absorbed, need);
+                __m128 deficit = _mm_mul_ps(_mm_sub_ps(need, absorbed), ten);
+                stress = _mm_add_ps(stress, _mm_or_ps(_mm_and_ps(stressed, deficit), _mm_andnot_ps(stressed, recovery)));
+                stress = _mm_min_ps(hundred, _mm_max_ps(zero, stress));
+                __m128 dm = _mm_sub_ps(moisture, _mm_set1_ps(observedMoisture[i]));
+                __m128 ds = _mm_sub_ps(stress, _mm_set1_ps(observedStress[i]));
+                dm = _mm_mul_ps(dm, dm);
+                ds = _mm_mul_ps(ds, ds);
+                moistureLo = _mm_add_pd(moistureLo, _mm_cvtps_pd(dm));
+                moistureHi = _mm_add_pd(moistureHi, _mm_cvtps_pd(_mm_movehl_ps(dm, dm)));
+                stressLo = _mm_add_pd(stressLo, _mm_cvtps_pd(ds));
+                stressHi = _mm_add_pd(stressHi, _mm_cvtps_pd(_mm_movehl_ps(ds, ds)));
+            }
+            begin = end;
+        }
+        double m[4], st[4];
+        _mm_storeu_pd(m, moistureLo);
+        _mm_storeu_pd(m + 2, moistureHi);
+        _mm_storeu_pd(st, stressLo);
+        _mm_storeu_pd(st + 2, stressHi);
+        for (int lane = 0; lane < 4; ++lane) {
+            out[c + lane].moistureSquared = m[lane];
+            out[c + lane].stressSquared = st[lane];
+            out[c + lane].rows = static_cast<uint32_t>(n);
+        }
+    }
+#endif
+    for (; c < count; ++c) out[c] = evaluateFit(series, params[c], waterNeedPerDay, segmentSteps);
+}
+
+namespace {
+const int kMaxDims = 3;
+
+struct Candidate {
+    float x[kMaxDims] = {};
+    double loss = 0.0;
+    uint64_t evaluations = 0;
+};
+
+// x holds retention, drainage and (when fitted) absorption
+SoilPlantParams toParams(const float* x, int dims, const SoilPlantParams& fixed) {
+    SoilPlantParams p = fixed;
+    p.soilRetentionRate = x[0];
+    p.soilDrainageFactor = x[1];
+    if (dims > 2) p.plantAbsorptionRate = x[2];
+    return p;
+}
+
+double lossOf(const FitError& e, float stressWeight) {
+    return e.rows > 0 ? (e.moistureSquared + stressWeight * e.stressSquared) / e.rows : 0.0;
+}
+
+double evaluate(const ObservedSeries& series, const CalibrationOptions& options, int dims, float* x) {
+    for (int d = 0; d < dims; ++d) x[d] = std::min(1.0f, std::max(0.0f, x[d]));
+    SoilPlantParams params = toParams(x, dims, options.initial);
+    return lossOf(evaluateFit(series, params, options.waterNeedPerDay, options.segmentSteps), options.stressWeight);
+}
+
+// Nelder-Mead from start with an initial simplex of size step, kept inside [0, 1]
+Candidate polish(const ObservedSeries& series, const CalibrationOptions& options, int dims, const float* start, float step) {
+    float v[kMaxDims + 1][kMaxDims];
+    double f[kMaxDims + 1];
+    int order[kMaxDims + 1];
+    uint64_t evaluations = 0;
+    for (int i = 0; i <= dims; ++i) {
+        std::copy(start, start + dims, v[i]);
+        if (i > 0) v[i][i - 1] += v[i][i - 1] + step <= 1.0f ? step : -step;
+        f[i] = evaluate(series, options, dims, v[i]);
+        ++evaluations;
+        order[i] = i;
+    }
+    for (int it = 0; it < options.polishIterations; ++it) {
+        auto before = [&f](int a, int b) { return f[a] != f[b] ? f[a] < f[b] : a < b; };
+        for (int i = 1; i <= dims; ++i) { // Insertion sort, at most four vertices
+            for (int j = i; j > 0 && before(order[j], order[j - 1]); --j) std::swap(order[j], order[j - 1]);
+        }
+        int best = order[0], worst = order[dims], second = order[dims - 1];
+        float spread = 0.0f;
+        for (int i = 1; i <= dims; ++i) {
+            for (int d = 0; d < dims; ++d) spread = std::max(spread, std::abs(v[order[i]][d] - v[best][d]));
+        }
+        if (spread < 1e-6f) break;
+        float centroid[kMaxDims] = {};
+        for (int i = 0; i < dims; ++i) {
+            for (int d = 0; d < dims; ++d) centroid[d] += v[order[i]][d] / dims;
+        }
+        float reflected[kMaxDims], trial[kMaxDims];
+        for (int d = 0; d < dims; ++d) reflected[d] = centroid[d] + (centroid[d] - v[worst][d]);
+        double fr = evaluate(series, options, dims, reflected);
+        ++evaluations;
+        if (fr < f[best]) {
+            for (int d = 0; d < dims; ++d) trial[d] = centroid[d] + 2.0f * (centroid[d] - v[worst][d]);
+            double fe = evaluate(series, options, dims, trial);
+            ++evaluations;
+            bool expand = fe < fr;
+            std::copy(expand ? trial : reflected, (expand ? trial : reflected) + dims, v[worst]);
+            f[worst] = expand ? fe : fr;
+        } else if (fr < f[second]) {
+            std::copy(reflected, reflected + dims, v[worst]);
+            f[worst] = fr;
+        } else {
+            // Contract towards the better of the reflected and the worst point, or shrink towards the best
+            const float* toward = fr < f[worst] ? reflected : v[worst];
+            for (int d = 0; d < dims; ++d) trial[d] = centroid[d] + 0.5f * (toward[d] - centroid[d]);
+            double fc = evaluate(series, options, dims, trial);
+            ++evaluations;
+            if (fc < std::min(fr, f[worst])) {
+                std::copy(trial, trial + dims, v[worst]);
+                f[worst] = fc;
+            } else {
+                for (int i = 0; i <= dims; ++i) {
+                    if (i == best) continue;
+                    for (int d = 0; d < dims; ++d) v[i][d] = v[best][d] + 0.5f * (v[i][d] - v[best][d]);
+                    f[i] = evaluate(series, options, dims, v[i]);
+                    ++evaluations;
+                }
+            }
+        }
+    }
+    int best = 0;
+    for (int i = 1; i <= dims; ++i) {
+        if (f[i] < f[best]) best = i;
+    }
+    Candidate c;
+    std::copy(v[best], v[best] + dims, c.x);
+    c.loss = f[best];
+    c.evaluations = evaluations;
+    return c;
+}
+} // namespace
+
+CalibrationResult calibrate(const ObservedSeries& series, const CalibrationOptions& options, ZoneScheduler& scheduler) {
+    CalibrationResult result;
+    // A handful of stressed rows barely moves the loss, so absorption would be fitted to noise
+    result.fittedAbsorption = series.size() > 0 && series.stressedRows >= options.minStressedShare * series.size();
+    const int dims = result.fittedAbsorption ? 3 : 2;
+    const int g = std::max(2, options.gridPoints);
+    size_t count = 1;
+    for (int d = 0; d < dims; ++d) count *= static_cast<size_t>(g);
+    std::vector<double> losses(count);
+    float lo[kMaxDims] = {0.0f, 0.0f, 0.0f};
+    float hi[kMaxDims] = {1.0f, 1.0f, 1.0f};
+    float lastLo[kMaxDims], lastHi[kMaxDims];
+    float cell = 1.0f / (g - 1);
+    Candidate best;
+    best.loss = -1.0;
+    std::vector<size_t> ranked(count);
+    for (int round = 0; round < std::max(1, options.rounds); ++round) {
+        auto point = [&](size_t i, float* x) {
+            for (int d = 0; d < dims; ++d, i /= g) x[d] = lo[d] + (hi[d] - lo[d]) * static_cast<float>(i % g) / (g - 1);
+        };
+        // One task per batch of four grid points, so each replay fills the SIMD lanes
+        scheduler.runTick((count + 3) / 4, [&](size_t task) {
+            SoilPlantParams batch[4];
+            FitError errors[4];
+            size_t first = task * 4, size = std::min<size_t>(4, count - first);
+            for (size_t k = 0; k < size; ++k) {
+                float x[kMaxDims];
+                point(first + k, x);
+                batch[k] = toParams(x, dims, options.initial);
+            }
+            evaluateFitBatch(series, batch, size, options.waterNeedPerDay, options.segmentSteps, errors);
+            for (size_t k = 0; k < size; ++k) losses[first + k] = lossOf(errors[k], options.stressWeight);
+        });
+        result.evaluations += count;
+        for (size_t i = 0; i < count; ++i) ranked[i] = i;
+        size_t keep = std::min(count, static_cast<size_t>(std::max(1, options.polishStarts)));
+        std::partial_sort(ranked.begin(), ranked.begin() + keep, ranked.end(), [&losses](size_t a, size_t b) {
+            return losses[a] != losses[b] ? losses[a] < losses[b] : a < b;
+        });
+        if (best.loss < 0.0 || losses[ranked[0]] < best.loss) {
+            point(ranked[0], best.x);
+            best.loss = losses[ranked[0]];
+        }
+        std::copy(lo, lo + kMaxDims, lastLo);
+        std::copy(hi, hi + kMaxDims, lastHi);
+        // Next round: two cells either side of the best point so far
+        for (int d = 0; d < dims; ++d) {
+            cell = (hi[d] - lo[d]) / (g - 1);
+            lo[d] = std::max(0.0f, best.x[d] - 2.0f * cell);
+            hi[d] = std::min(1.0f, best.x[d] + 2.0f * cell);
+        }
+    }
+    // Polish the best point and the runners-up of the last round, one Nelder-Mead run per worker
+    std::vector<Candidate> starts(1, best);
+    size_t keep = std::min(count, static_cast<size_t>(std::max(1, options.polishStarts)));
+    for (size_t r = 0; r < keep && starts.size() < keep; ++r) {
+        if (losses[ranked[r]] == best.loss) continue;
+        Candidate c;
+        size_t i = ranked[r];
+        for (int d = 0; d < dims; ++d, i /= g) c.x[d] = lastLo[d] + (lastHi[d] - lastLo[d]) * static_cast<float>(i % g) / (g - 1);
+        c.loss = losses[ranked[r]];
+        starts.push_back(c);
+    }
+    std::vector<Candidate> polished(starts);
+    if (options.polishIterations > 0) {
+        float step = std::max(cell, 1e-3f);
+        scheduler.runTick(starts.size(), [&](size_t s) {
+            polished[s] = polish(series, options, dims, starts[s].x, step);
+        });
+    }
+    for (const Candidate& c : polished) {
+        result.evaluations += c.evaluations;
+        if (c.loss < best.loss) best = c;
+    }
+    result.params = toParams(best.x, dims, options.initial);
+    FitError e = evaluateFit(series, result.params, options.waterNeedPerDay, options.segmentSteps);
+    result.loss = lossOf(e, options.stressWeight);
+    result.moistureRmse = e.rows > 0 ? std::sqrt(e.moistureSquared / e.rows) : 0.0;
+    result.stressRmse = e.rows > 0 ? std::sqrt(e.stressSquared / e.rows) : 0.0;
+    return result;
+}
@@ -0,0 +1,169 @@
+#include "../include/Checkpoint.h"
+#include "../include/Snapshot.h"
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+namespace {
+const char kMagic[8] = {'M', 'Y', 'S', 'A', 'C', 'K', 'P', '\0'};
+const uint32_t kVersion = 3;
+const uint32_t kMaxZones = 1u << 20; // Far above any real bed; a larger count is a corrupt header
+
+void saveParams(SnapshotWriter& out, const SimulationParams& p) {
+    out.write(p.plantWaterNeedPerDay);
+    out.write(p.plantStressThreshold);
+    out.write(p.plantAbsorptionRate);
+    out.write(p.soilRetentionRate);
+    out.write(p.soilDrainageFactor);
+    out.write(p.moistureThreshold);
+    out.write(p.pumpFlowRate);
+    out.write(p.pumpPowerWatts);
+    out.write(p.waterCost);
+    out.write(p.simulationStep);
+    out.write(p.seed);
+    out.write(p.conservationModeEnabled);
+    out.write(p.conservationWaterCostThreshold);
+    out.write(p.conservationDroughtMoistureThreshold);
+    out.write(p.conservationMoistureThreshold);
+    out.write(p.conservationNightStartHour);
+    out.write(p.conservationNightEndHour);
+    out.write(p.forecastEnsembleMembers);
+    out.write(p.predictiveWateringEnabled);
+    out.write(p.forecastDelayEnabled);
+    out.write(p.plannerEnabled);
+    out.write(p.plannerHorizonHours);
+    out.write(p.plannerStressPenalty);
+}
+
+void loadParams(SnapshotReader& in, SimulationParams& p) {
+    in.read(p.plantWaterNeedPerDay);
+    in.read(p.plantStressThreshold);
+    in.read(p.plantAbsorptionRate);
+    in.read(p.soilRetentionRate);
+    in.read(p.soilDrainageFactor);
+    in.read(p.moistureThreshold);
+    in.read(p.pumpFlowRate);
+    in.read(p.pumpPowerWatts);
+    in.read(p.waterCost);
+    in.read(p.simulationStep);
+    in.read(p.seed);
+    in.read(p.conservationModeEnabled);
+    in.read(p.conservationWaterCostThreshold);
+    in.read(p.conservationDroughtMoistureThreshold);
+    in.read(p.conservationMoistureThreshold);
+    in.read(p.conservationNightStartHour);
+    in.read(p.conservationNightEndHour);
+    in.read(p.forecastEnsembleMembers);
+    in.read(p.predictiveWateringEnabled);
+    in.read(p.forecastDelayEnabled);
+    in.read(p.plannerEnabled);
+    in.read(p.plannerHorizonHours);
+    in.read(p.plannerStressPenalty);
+    p.weatherTrace = nullptr;
+}
+} // namespace
+
+Checkpoint captureCheckpoint(const SimulationParams& params, int64_t nextStep, float secondsElapsed,
+                             const std::vector<std::unique_ptr<ZoneSimulation>>& zones, const PumpBudget& budget,
+                             const Logger& logger) {
+    Checkpoint c;
+    c.params = params;
+    c.nextStep = nextStep;
+    c.secondsElapsed = secondsElapsed;
+    c.activePumps = budget.getActive();
+    c.maxPumps = budget.getMax();
+    std::ostringstream loggerState;
+    SnapshotWriter loggerOut(loggerState);
+    logger.save(loggerOut);
+    c.loggerState = loggerState.str();
+    for (const auto& zone : zones) {
+        std::ostringstream state;
+        SnapshotWriter out(state);
+        zone->save(out);
+        c.zoneIds.push_back(zone->getZoneId());
+        c.soilTypes.push_back(zone->getSoilType());
+        c.zoneStates.push_back(state.str());
+    }
+    return c;
+}
+
+bool saveCheckpoint(const std::string& path, const Checkpoint& c) {
+    std::ofstream file(path, std::ios::binary);
+    if (!file) return false;
+    SnapshotWriter out(file);
+    out.writeArray(kMagic, sizeof(kMagic));
+    out.write(kVersion);
+    saveParams(out, c.params);
+    out.write(c.nextStep);
+    out.write(c.secondsElapsed);
+    out.write(c.activePumps);
+    out.write(c.maxPumps);
+    out.writeString(c.loggerState);
+    out.write(static_cast<uint32_t>(c.zoneStates.size()));
+    for (size_t z = 0; z < c.zoneStates.size(); ++z) {
+        out.writeString(c.zoneIds[z]);
+        out.writeString(c.soilTypes[z]);
+        out.writeString(c.zoneStates[z]);
+    }
+    file.flush();
+    return out.ok();
+}
+
+bool loadCheckpoint(const std::string& path, Checkpoint& c, std::string& error) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        error = "cannot open " + path;
+        return false;
+    }
+    SnapshotReader in(file);
+    char magic[8] = {};
+    uint32_t version = 0;
+    in.readArray(magic, sizeof(magic));
+    in.read(version);
+    if (!in.ok() || std::memcmp(magic, kMagic, sizeof(kMagic)) != 0 || version != kVersion) {
+        error = path + " is not a checkpoint (.mckp)";
+        return false;
+    }
+    c = Checkpoint();
+    loadParams(in, c.params);
+    in.read(c.nextStep);
+    in.read(c.secondsElapsed);
+    in.read(c.activePumps);
+    in.read(c.maxPumps);
+    in.readString(c.loggerState);
+    uint32_t zones = 0;
+    in.read(zones);
+    if (in.ok() && (zones == 0 || zones > kMaxZones)) {
+        error = path + " is corrupt (" + std::to_string(zones) + " zones)";
+        return false;
+    }
+    for (uint32_t z = 0; z < zones && in.ok(); ++z) {
+        std::string id, soil, state;
+        in.readString(id);
+        in.readString(soil);
+        in.readString(state);
+        c.zoneIds.push_back(id);
+        c.soilTypes.push_back(soil);
+        c.zoneStates.push_back(state);
+    }
+    if (!in.ok()) {
+        error = path + " is truncated";
+        return false;
+    }
+    return true;
+}
+
+bool restoreZone(const Checkpoint& c, size_t zone, ZoneSimulation& sim) {
+    if (zone >= c.zoneStates.size()) return false;
+    std::istringstream state(c.zoneStates[zone]);
+    SnapshotReader in(state);
+    sim.restore(in);
+    return in.ok() && state.peek() == std::char_traits<char>::eof();
+}
+
+bool restoreLogger(const Checkpoint& c, Logger& logger) {
+    std::istringstream state(c.loggerState);
+    SnapshotReader in(state);
+    logger.restore(in);
+    return in.ok();
+}
@@ -0,0 +1,293 @@
+#include "../include/Config.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <sys/stat.h>
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace {
+typedef SimulationParams P;
+const float kNoLimit = 1e9f;
+
+// key, float / int / bool field, min, max, required, reloadable
+const ConfigField kFields[] = {
+    {"plant_water_need_per_day", &P::plantWaterNeedPerDay, nullptr, nullptr, 0.0f, kNoLimit, true, false},
+    {"plant_stress_threshold", &P::plantStressThreshold, nullptr, nullptr, 0.0f, 100.0f, true, false},
+    {"plant_absorption_rate", &P::plantAbsorptionRate, nullptr, nullptr, 0.0f, 1.0f, true, false},
+    {"soil_retention_rate", &P::soilRetentionRate, nullptr, nullptr, 0.0f, 1.0f, true, false},
+    {"soil_drainage_factor", &P::soilDrainageFactor, nullptr, nullptr, 0.0f, 1.0f, true, false},
+    {"moisture_threshold", &P::moistureThreshold, nullptr, nullptr, 0.0f, 100.0f, true, true},
+    {"pump_flow_rate", &P::pumpFlowRate, nullptr, nullptr, 0.0f, kNoLimit, true, false},
+    {"pump_power_watts", &P::pumpPowerWatts, nullptr, nullptr, 0.0f, kNoLimit, false, false},
+    {"water_cost", &P::waterCost, nullptr, nullptr, 0.0f, kNoLimit, true, true},
+    {"simulation_step", &P::simulationStep, nullptr, nullptr, 0.001f, 86400.0f, false, false},
+    {"conservation_mode_enabled", nullptr, nullptr, &P::conservationModeEnabled, 0.0f, 0.0f, false, true},
+    {"conservation_water_cost_threshold", &P::conservationWaterCostThreshold, nullptr, nullptr, 0.0f, kNoLimit, false, true},
+    {"conservation_drought_moisture_threshold", &P::conservationDroughtMoistureThreshold, nullptr, nullptr, 0.0f, 100.0f, false, true},
+    {"conservation_moisture_threshold", &P::conservationMoistureThreshold, nullptr, nullptr, 0.0f, 100.0f, false, true},
+    {"conservation_night_start_hour", nullptr, &P::conservationNightStartHour, nullptr, 0.0f, 23.0f, false, true},
+    {"conservation_night_end_hour", nullptr, &P::conservationNightEndHour, nullptr, 0.0f, 23.0f, false, true},
+    {"forecast_ensemble_members", nullptr, &P::forecastEnsembleMembers, nullptr, 1.0f, 64.0f, false, false},
+    {"forecast_delay_enabled", nullptr, nullptr, &P::forecastDelayEnabled, 0.0f, 0.0f, false, true},
+    {"predictive_watering_enabled", nullptr, nullptr, &P::predictiveWateringEnabled, 0.0f, 0.0f, false, true},
+    {"planner_enabled", nullptr, nullptr, &P::plannerEnabled, 0.0f, 0.0f, false, true},
+    {"planner_horizon_hours", nullptr, &P::plannerHorizonHours, nullptr, 1.0f, 48.0f, false, true},
+    {"planner_stress_penalty", &P::plannerStressPenalty, nullptr, nullptr, 0.0f, kNoLimit, false, true},
+};
+const char kDurationKey[] = "simulation_duration";
+
+std::string trim(const std::string& s) {
+    size_t start = s.find_first_not_of(" \t\r");
+    if (start == std::string::npos) return "";
+    return s.substr(start, s.find_last_not_of(" \t\r") - start + 1);
+}
+
+// Strict parse of the whole value text; false if it is not a number/flag in range
+bool parseValue(const ConfigField& field, const std::string& text, SimulationParams& params) {
+    if (text.empty()) return false;
+    const char* begin = text.c_str();
+    char* end = nullptr;
+    errno = 0;
+    if (field.boolField) {
+        if (text == "true" || text == "1") params.*field.boolField = true;
+        else if (text == "false" || text == "0") params.*field.boolField = false;
+        else return false;
+        return true;
+    }
+    if (field.intField) {
+        long value = std::strtol(begin, &end, 10);
+        if (*end != '\0' || errno != 0 || value < field.min || value > field.max) return false;
+        params.*field.intField = static_cast<int>(value);
+        return true;
+    }
+    float value = std::strtof(begin, &end);
+    if (*end != '\0' || errno != 0 || !std::isfinite(value) || value < field.min || value > field.max) return false;
+    params.*field.floatField = value;
+    return true;
+}
+
+std::string describe(const ConfigField& field) {
+    if (field.boolField) return "true or false";
+    std::ostringstream range;
+    range << (field.intField ? "an integer" : "a number") << " >= " << field.min;
+    if (field.max < kNoLimit) range << " and <= " << field.max;
+    return range.str();
+}
+
+bool sameField(const ConfigField& field, const SimulationParams& a, const SimulationParams& b) {
+    if (field.floatField) return a.*field.floatField == b.*field.floatField;
+    if (field.intField) return a.*field.intField == b.*field.intField;
+    return a.*field.boolField == b.*field.boolField;
+}
+} // namespace
+
+const ConfigField* findConfigField(const std::string& key) {
+    for (const ConfigField& field : kFields) {
+        if (key == field.key) return &field;
+    }
+    return nullptr;
+}
+
+bool Config::has(const std::string& key) const {
+    return std::find(keys.begin(), keys.end(), key) != keys.end();
+}
+
+ConfigStatus loadConfig(const std::string& path, Config& config, std::string& error) {
+    std::ifstream file(path);
+    if (!file) {
+        error = "Failed to open " + path;
+        return ConfigStatus::CannotOpen;
+    }
+    return parseConfig(file, config, error);
+}
+
+ConfigStatus parseConfig(std::istream& in, Config& config, std::string& error) {
+    config = Config();
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(in, line)) {
+        ++lineNumber;
+        std::string text = trim(line);
+        if (text.empty() || text[0] == '#') continue;
+        size_t eq = text.find('=');
+        if (eq == std::string::npos) {
+            error = "Invalid config line " + std::to_string(lineNumber) + ": expected key=value";
+            return ConfigStatus::InvalidValue;
+        }
+        std::string key = trim(text.substr(0, eq));
+        std::string value = trim(text.substr(eq + 1, text.find('#', eq) - eq - 1));
+        config.keys.push_back(key);
+        if (key == kDurationKey) {
+            char* end = nullptr;
+            errno = 0;
+            long seconds = std::strtol(value.c_str(), &end, 10);
+            if (value.empty() || *end != '\0' || errno != 0 || seconds > 0x7fffffffL) {
+                error = "Invalid value '" + value + "' for " + key + " on line " + std::to_string(lineNumber) +
+                        " (expected whole seconds)";
+                return ConfigStatus::InvalidValue;
+            }
+            config.simulationDuration = static_cast<int>(seconds);
+            continue;
+        }
+        const ConfigField* field = findConfigField(key);
+        if (!field) continue; // Not a simulation parameter
+        if (!parseValue(*field, value, config.params)) {
+            error = "Invalid value '" + value + "' for " + key + " on line " + std::to_string(lineNumber) +
+                    " (expected " + describe(*field) + ")";
+            return ConfigStatus::InvalidValue;
+        }
+    }
+    if (!config.has(kDurationKey)) {
+        error = std::string("Missing required config field: ") + kDurationKey;
+        return ConfigStatus::MissingField;
+    }
+    for (const ConfigField& field : kFields) {
+        if (field.required && !config.has(field.key)) {
+            error = std::string("Missing required config field: ") + field.key;
+            return ConfigStatus::MissingField;
+        }
+    }
+    return ConfigStatus::Ok;
+}
+
+bool setSimulationParam(SimulationParams& params, const std::string& key, const std::string& value, std::string& error) {
+    const ConfigField* field = findConfigField(key);
+    if (!field) {
+        error = "unknown config key '" + key + "'";
+        return false;
+    }
+    if (!parseValue(*field, value, params)) {
+        error = "invalid value '" + value + "' for " + key + " (expected " + describe(*field) + ")";
+        return false;
+    }
+    return true;
+}
+
+bool applyReloadable(const SimulationParams& from, SimulationParams& to) {
+    bool changed = false;
+    for (const ConfigField& field : kFields) {
+        if (!field.reloadable || sameField(field, from, to)) continue;
+        changed = true;
+        if (field.floatField) to.*field.floatField = from.*field.floatField;
+        else if (field.intField) to.*field.intField = from.*field.intField;
+        else to.*field.boolField = from.*field.boolField;
+    }
+    return changed;
+}
+
+ConfigChannel::ConfigChannel(const SimulationParams& initial) {
+    versions.emplace_back(new ConfigVersion{0, initial});
+    head.store(versions.back().get(), std::memory_order_release);
+}
+
+uint64_t ConfigChannel::publish(const SimulationParams& params) {
+    uint64_t version = versions.back()->version + 1;
+    versions.emplace_back(new ConfigVersion{version, params});
+    head.store(versions.back().get(), std::memory_order_release);
+    return version;
+}
+
+ConfigWatcher::ConfigWatcher(const std::string& path, ConfigChannel& channel) : path(path), channel(channel) {
+    std::string error;
+    loadConfig(path, lastFile, error);
+}
+
+ConfigWatcher::~ConfigWatcher() {
+    stop();
+}
+
+bool ConfigWatcher::start(std::string& error) {
+    if (loadConfig(path, lastFile, error) != ConfigStatus::Ok) return false;
+#ifdef __linux__
+    // Watch the directory: editors often save by writing a temporary file and renaming it over the original
+    size_t slash = path.find_last_of('/');
+    std::string dir = slash == std::string::npos ? "." : path.substr(0, slash + 1);
+    watchFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (watchFd < 0 || inotify_add_watch(watchFd, dir.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0) {
+        error = "cannot watch " + dir + ": " + std::strerror(errno);
+        if (watchFd >= 0) close(watchFd);
+        watchFd = -1;
+        return false;
+    }
+#else
+    struct stat info;
+    if (stat(path.c_str(), &info) != 0) {
+        error = "cannot watch " + path + ": " + std::strerror(errno);
+        return false;
+    }
+#endif
+    stopping.store(false);
+    thread = std::thread(&ConfigWatcher::run, this);
+    return true;
+}
+
+void ConfigWatcher::stop() {
+    stopping.store(true);
+    if (thread.joinable()) thread.join();
+#ifdef __linux__
+    if (watchFd >= 0) close(watchFd);
+    watchFd = -1;
+#endif
+}
+
+void ConfigWatcher::run() {
+#ifdef __linux__
+    size_t slash = path.find_last_of('/');
+    std::string name = slash == std::string::npos ? path : path.substr(slash + 1);
+    alignas(inotify_event) char buffer[4096];
+    while (!stopping.load()) {
+        pollfd pfd = {watchFd, POLLIN, 0};
+        if (poll(&pfd, 1, 200) <= 0) continue; // Wakes up regularly to notice stop()
+        bool changed = false;
+        ssize_t n;
+        while ((n = read(watchFd, buffer, sizeof(buffer))) > 0) {
+            for (char* p = buffer; p < buffer + n;) {
+                const inotify_event* event = reinterpret_cast<const inotify_event*>(p);
+                if (event->len > 0 && name == event->name) changed = true;
+                p += sizeof(inotify_event) + event->len;
+            }
+        }
+        if (changed) reload();
+    }
+#else
+    struct stat info;
+    time_t lastModified = stat(path.c_str(), &info) == 0 ? info.st_mtime : 0;
+    while (!stopping.load()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(500));
+        if (stat(path.c_str(), &info) == 0 && info.st_mtime != lastModified) {
+            lastModified = info.st_mtime;
+            reload();
+        }
+    }
+#endif
+}
+
+bool ConfigWatcher::reload() {
+    Config edited;
+    std::string error;
+    if (loadConfig(path, edited, error) != ConfigStatus::Ok) {
+        ++rejected;
+        std::cerr << "[WARN] Ignoring edit of " << path << ": " << error << std::endl;
+        return false;
+    }
+    for (const ConfigField& field : kFields) {
+        if (!field.reloadable && !sameField(field, edited.params, lastFile.params)) {
+            std::cerr << "[WARN] " << field.key << " changed in " << path << "; restart to apply it" << std::endl;
+        }
+    }
+    lastFile = edited;
+    SimulationParams next = channel.current()->params;
+    if (!applyReloadable(edited.params, next)) return false;
+    channel.publish(next);
+    return true;
+}
@@ -0,0 +1,12 @@
+#include "../include/CounterRng.h"
+#include <chrono>
+
+CounterRng::CounterRng() : CounterRng(timeSeed()) {}
+
+CounterRng::CounterRng(uint64_t seed, uint32_t zone, uint32_t stream)
+    : seed(seed), zone(zone), stream(stream),
+      key(mix(seed ^ mix((static_cast<uint64_t>(zone) << 32) | stream))) {}
+
+uint64_t CounterRng::timeSeed() {
+    return static_cast<uint64_t>(std::chrono::system_clock::now().time_since_epoch().count());
+}
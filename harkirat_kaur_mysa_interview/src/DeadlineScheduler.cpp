@@ -0,0 +1,101 @@
+#include "../include/DeadlineScheduler.h"
+#include <ios>
+#ifdef __linux__
+#include <cerrno>
+#include <time.h>
+#else
+#include <chrono>
+#include <thread>
+#endif
+
+namespace {
+const double kBucketLimitsMs[DeadlineScheduler::kJitterBuckets - 1] = {0.05, 0.1, 0.5, 1.0, 5.0, 10.0, 100.0};
+}
+
+DeadlineScheduler::DeadlineScheduler(double periodSeconds, OverrunPolicy policy)
+    : periodNs(static_cast<int64_t>(periodSeconds * 1e9)), policy(policy) {
+    if (periodNs < 1) periodNs = 1;
+}
+
+int64_t DeadlineScheduler::nowNs() const {
+#ifdef __linux__
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+void DeadlineScheduler::sleepUntil(int64_t deadlineNs) {
+#ifdef __linux__
+    timespec ts;
+    ts.tv_sec = static_cast<time_t>(deadlineNs / 1000000000LL);
+    ts.tv_nsec = static_cast<long>(deadlineNs % 1000000000LL);
+    // An absolute deadline survives signals: resume the same sleep until it returns 0
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) == EINTR) {}
+#else
+    std::this_thread::sleep_until(std::chrono::steady_clock::time_point(std::chrono::nanoseconds(deadlineNs)));
+#endif
+}
+
+void DeadlineScheduler::start() {
+    nextDeadlineNs = nowNs() + periodNs;
+}
+
+bool DeadlineScheduler::waitForNextPeriod() {
+    ++periods;
+    int64_t now = nowNs();
+    if (now >= nextDeadlineNs) {
+        ++overruns;
+        recordLateness(now - nextDeadlineNs);
+        if (policy == OverrunPolicy::Realign) {
+            ++realignments;
+            nextDeadlineNs = now + periodNs;
+        } else {
+            nextDeadlineNs += periodNs;
+        }
+        return false;
+    }
+    sleepUntil(nextDeadlineNs);
+    recordLateness(nowNs() - nextDeadlineNs);
+    nextDeadlineNs += periodNs;
+    return true;
+}
+
+void DeadlineScheduler::recordLateness(int64_t ns) {
+    if (ns < 0) ns = 0;
+    if (ns > maxLatenessNs) maxLatenessNs = ns;
+    double ms = ns / 1e6;
+    int bucket = 0;
+    while (bucket < kJitterBuckets - 1 && ms >= kBucketLimitsMs[bucket]) ++bucket;
+    ++histogram[bucket];
+}
+
+double DeadlineScheduler::latenessPercentileMs(double p) const {
+    uint64_t total = 0;
+    for (uint64_t count : histogram) total += count;
+    if (total == 0) return 0.0;
+    uint64_t rank = static_cast<uint64_t>(p * total + 0.999999);
+    if (rank < 1) rank = 1;
+    uint64_t seen = 0;
+    for (int b = 0; b < kJitterBuckets - 1; ++b) {
+        seen += histogram[b];
+        if (seen >= rank) return kBucketLimitsMs[b] < getMaxLatenessMs() ? kBucketLimitsMs[b] : getMaxLatenessMs();
+    }
+    return getMaxLatenessMs();
+}
+
+void DeadlineScheduler::printJitter(std::ostream& out) const {
+    std::ios::fmtflags flags = out.flags();
+    std::streamsize precision = out.precision(6);
+    out.unsetf(std::ios::floatfield); // Bucket edges as written, whatever the summary's format
+    for (int b = 0; b < kJitterBuckets; ++b) {
+        if (b > 0) out << " | ";
+        if (b < kJitterBuckets - 1) out << "<" << kBucketLimitsMs[b] << "ms ";
+        else out << ">=" << kBucketLimitsMs[b - 1] << "ms ";
+        out << histogram[b];
+    }
+    out.flags(flags);
+    out.precision(precision);
+}
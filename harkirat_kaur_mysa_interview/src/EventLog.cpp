@@ -0,0 +1,188 @@
+#include "../include/EventLog.h"
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+const char kHeader[] = "# mysa-events v1";
+
+struct Keyframe {
+    int64_t step;
+    bool pumpOn;
+    bool weatherFailed;
+    bool soilFailed;
+    float values[6]; // soilMoisture, effectiveMoisture, temperature, humidity, rainfall, plantStress
+};
+
+struct ZoneLog {
+    uint16_t zoneName;
+    uint16_t soilName;
+    float flowRate;
+    float powerWatts;
+    float step;
+    std::vector<Keyframe> keys;
+    size_t cursor = 0;
+};
+
+uint16_t nameId(std::vector<std::string>& names, const std::string& name, LogSink& sink) {
+    size_t id = 0;
+    while (id < names.size() && names[id] != name) ++id;
+    if (id == names.size()) {
+        names.push_back(name);
+        sink.defineName(static_cast<uint16_t>(id), name);
+    }
+    return static_cast<uint16_t>(id);
+}
+} // namespace
+
+EventLogWriter::EventLogWriter(const std::string& filename, int keyframeInterval)
+    : file(filename), keyframeInterval(keyframeInterval > 0 ? keyframeInterval : 1) {
+    file << kHeader << "\n";
+}
+
+EventLogWriter::~EventLogWriter() {
+    file.flush();
+}
+
+void EventLogWriter::declareZone(const std::string& zoneId, const std::string& soilType, float flowRate,
+                                 float powerWatts, float simulationStep) {
+    file << "Z," << zones.size() << "," << zoneId << "," << soilType << "," << flowRate << "," << powerWatts << ","
+         << simulationStep << "\n";
+    zones.push_back(ZoneState());
+}
+
+void EventLogWriter::writeKeyframe(size_t zone, int64_t step, const ZoneStepResult& r) {
+    file << "K," << step << "," << zone << "," << r.pumpOn << "," << r.weatherFailed << "," << r.soilFailed << ","
+         << r.conservationActive << "," << r.soilMoisture << "," << r.effectiveMoisture << "," << r.temperature << ","
+         << r.humidity << "," << r.rainfall << "," << r.plantStress << "\n";
+    zones[zone].lastKeyframe = step;
+    ++keyframes;
+}
+
+void EventLogWriter::record(size_t zone, int64_t step, const ZoneStepResult& r) {
+    ZoneState& z = zones[zone];
+    bool pump = z.started && r.pumpOn != z.last.pumpOn;
+    bool weather = z.started && r.weatherFailed != z.last.weatherFailed;
+    bool soil = z.started && r.soilFailed != z.last.soilFailed;
+    bool conservation = z.started && r.conservationActive != z.last.conservationActive;
+    if (!z.started || pump || weather || soil || conservation || step - z.lastKeyframe >= keyframeInterval) {
+        writeKeyframe(zone, step, r);
+    }
+    if (pump) file << "P," << step << "," << zone << "," << r.pumpOn << "," << pumpReasonName(r.pumpReason) << "\n";
+    if (weather) file << "S," << step << "," << zone << ",weather," << r.weatherFailed << "\n";
+    if (soil) file << "S," << step << "," << zone << ",soil," << r.soilFailed << "\n";
+    if (conservation) file << "C," << step << "," << zone << "," << r.conservationActive << "\n";
+    events += pump + weather + soil + conservation;
+    z.started = true;
+    z.lastStep = step;
+    z.last = r;
+}
+
+void EventLogWriter::finish(int64_t steps) {
+    if (finished) return;
+    finished = true;
+    // A closing keyframe per zone so the last stretch interpolates towards real values
+    for (size_t zone = 0; zone < zones.size(); ++zone) {
+        const ZoneState& z = zones[zone];
+        if (z.started && z.lastStep > z.lastKeyframe) writeKeyframe(zone, z.lastStep, z.last);
+    }
+    file << "E," << steps << "\n";
+    file.flush();
+}
+
+bool expandEventLog(std::istream& in, LogSink& sink, std::string& error) {
+    std::vector<ZoneLog> zones;
+    std::vector<std::string> names;
+    int64_t steps = -1;
+    std::string line;
+    int lineNumber = 0;
+    try {
+        while (std::getline(in, line)) {
+            ++lineNumber;
+            if (!line.empty() && line.back() == '\r') line.pop_back();
+            if (lineNumber == 1) {
+                if (line != kHeader) {
+                    error = "not an event log (missing '" + std::string(kHeader) + "')";
+                    return false;
+                }
+                continue;
+            }
+            if (line.empty() || line[0] == '#') continue;
+            std::vector<std::string> f;
+            std::stringstream fields(line);
+            std::string field;
+            while (std::getline(fields, field, ',')) f.push_back(field);
+            char tag = f[0].size() == 1 ? f[0][0] : '?';
+            size_t expected = tag == 'Z' ? 7 : tag == 'K' ? 13 : tag == 'P' || tag == 'S' ? 5 : tag == 'C' ? 4 : 2;
+            if (f.size() != expected || (tag != 'Z' && tag != 'K' && tag != 'P' && tag != 'S' && tag != 'C' && tag != 'E')) {
+                error = "line " + std::to_string(lineNumber) + ": malformed entry";
+                return false;
+            }
+            if (tag == 'Z') {
+                ZoneLog z;
+                z.zoneName = nameId(names, f[2], sink);
+                z.soilName = nameId(names, f[3], sink);
+                z.flowRate = std::stof(f[4]);
+                z.powerWatts = std::stof(f[5]);
+                z.step = std::stof(f[6]);
+                zones.push_back(z);
+            } else if (tag == 'E') {
+                steps = std::stoll(f[1]);
+            } else {
+                size_t zone = std::stoul(f[2]);
+                if (zone >= zones.size()) {
+                    error = "line " + std::to_string(lineNumber) + ": undeclared zone " + f[2];
+                    return false;
+                }
+                if (tag != 'K') continue; // Transitions are also in the keyframe written on the same step
+                Keyframe k;
+                k.step = std::stoll(f[1]);
+                k.pumpOn = f[3] == "1";
+                k.weatherFailed = f[4] == "1";
+                k.soilFailed = f[5] == "1";
+                for (int v = 0; v < 6; ++v) k.values[v] = std::stof(f[7 + v]);
+                std::vector<Keyframe>& keys = zones[zone].keys;
+                if (!keys.empty() && k.step < keys.back().step) {
+                    error = "line " + std::to_string(lineNumber) + ": keyframes out of order";
+                    return false;
+                }
+                keys.push_back(k);
+            }
+        }
+    } catch (const std::logic_error&) {
+        error = "line " + std::to_string(lineNumber) + ": invalid number";
+        return false;
+    }
+    if (steps < 0) {
+        error = "truncated event log (no end marker)";
+        return false;
+    }
+    for (int64_t step = 0; step < steps; ++step) {
+        for (ZoneLog& z : zones) {
+            if (z.keys.empty() || z.keys[0].step > step) continue;
+            while (z.cursor + 1 < z.keys.size() && z.keys[z.cursor + 1].step <= step) ++z.cursor;
+            const Keyframe& a = z.keys[z.cursor];
+            const Keyframe* b = z.cursor + 1 < z.keys.size() ? &z.keys[z.cursor + 1] : nullptr;
+            float t = b ? static_cast<float>(step - a.step) / (b->step - a.step) : 0.0f;
+            float v[6];
+            for (int i = 0; i < 6; ++i) v[i] = b ? a.values[i] + (b->values[i] - a.values[i]) * t : a.values[i];
+            LogRecord r;
+            r.time_s = static_cast<int32_t>(step * z.step);
+            r.soil_moisture = v[0];
+            r.effective_moisture = v[1];
+            r.temp = v[2];
+            r.humidity = v[3];
+            r.rain = v[4];
+            r.plant_stress = v[5];
+            r.flow_rate = z.flowRate;
+            r.pump_on = a.pumpOn;
+            r.water_used = a.pumpOn ? z.flowRate * (z.step / 60.0f) : 0.0f;
+            r.power_used = a.pumpOn ? z.powerWatts * (z.step / 3600.0f) : 0.0f;
+            r.sensor_error = a.weatherFailed || a.soilFailed;
+            r.zone_id = z.zoneName;
+            r.soil_type = z.soilName;
+            sink.write(r);
+        }
+    }
+    sink.flush();
+    return true;
+}
@@ -0,0 +1,373 @@
+#include "../include/EventSimulation.h"
+#include "../include/GardenZone.h"
+#include "../include/Profiler.h"
+#include "../include/WeatherBatch.h"
+#include "../include/WeatherSensor.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// WeatherSensor: rain on 10% of ticks, (0..9 + 1) * 0.5 mm when it does
+const float kExpectedRainfall = 0.1f * 2.75f;
+// ZoneSimulation resets a failed weather sensor after it has been down for more than 10 s
+const int kFailureTicks = 12;
+// ZoneSimulation holds the pump off for a tick after a reading with more rain than this
+const float kHeavyRain = 2.0f;
+
+// First i in [0, count) with pred(i) true, for a predicate that is false then true; count if none
+template <typename Pred>
+int firstIndex(int count, Pred pred) {
+    int lo = 0, hi = count;
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (pred(mid)) hi = mid;
+        else lo = mid + 1;
+    }
+    return lo;
+}
+
+// Plant::update over `count` ticks that all take the same branch, with moisture m0 + i * dm on
+// tick i. Adds each tick's stress to stressSum and counts ticks below 10% in healthy.
+double advancePlant(double s, int count, double m0, double dm, double absorption, double needPerSecond,
+                    double& stressSum, int& healthy) {
+    if (count <= 0) return s;
+    bool stressed = m0 * absorption < needPerSecond;
+    // Unclamped stress after tick i, and the sum of ticks [0, k)
+    double c1 = 10.0 * (needPerSecond - absorption * m0);
+    double c2 = 10.0 * absorption * dm;
+    auto raw = [&](int i) {
+        double n = i + 1.0;
+        return stressed ? s + n * c1 - c2 * i * n / 2.0 : s - 0.1 * n;
+    };
+    auto prefix = [&](int k) {
+        double n = k;
+        return stressed ? n * s + c1 * n * (n + 1.0) / 2.0 - c2 * (n - 1.0) * n * (n + 1.0) / 6.0
+                        : n * s - 0.1 * n * (n + 1.0) / 2.0;
+    };
+    double bound = stressed ? 100.0 : 0.0;
+    int clampAt = stressed ? firstIndex(count, [&](int i) { return raw(i) >= 100.0; })
+                           : firstIndex(count, [&](int i) { return raw(i) <= 0.0; });
+    stressSum += prefix(clampAt) + (count - clampAt) * bound;
+    if (stressed) {
+        healthy += firstIndex(count, [&](int i) { return raw(i) >= 10.0; });
+    } else {
+        healthy += count - firstIndex(count, [&](int i) { return raw(i) < 10.0; });
+    }
+    return clampAt < count ? bound : raw(count - 1);
+}
+
+} // namespace
+
+EventSimulation::EventSimulation(const SimulationParams& p, uint32_t zoneIndex, const std::string& zoneId,
+                                 const std::string& soilType)
+    : params(p), zoneId(zoneId), soilType(soilType), weatherRng(p.seed, zoneIndex, CounterRng::WeatherStream),
+      forecastRng(p.seed, zoneIndex, CounterRng::ForecastStream),
+      weather{20.0f, 50.0f, 0.0f}, pump(p.pumpFlowRate, p.pumpPowerWatts),
+      maxPermits(GardenZone::getMaxConcurrentPumps()) {
+    state = TickState{false, 0, 0, 0, Idle, false, false, false};
+    previous = state;
+}
+
+void EventSimulation::setWeatherResolution(int seconds) {
+    weatherResolution = seconds > 0 ? seconds : 1;
+}
+
+void EventSimulation::setSkipping(bool enabled) {
+    skipping = enabled;
+}
+
+EventSimulation::Weather EventSimulation::expectedWeather(int t) const {
+    // WeatherSensor::simulateWeather without noise, evaluated in the middle of the segment
+    int start = t - t % weatherResolution;
+    int mid = start + weatherResolution / 2;
+    if (params.weatherTrace) {
+        // Recorded weather: the trace at mid-segment and the segment's mean rain rate
+        WeatherSample s = params.weatherTrace->sample(mid);
+        Weather w;
+        w.temperature = s.temperature;
+        w.humidity = s.humidity;
+        w.rainfall = params.weatherTrace->rainBetween(start, start + weatherResolution) / weatherResolution;
+        return w;
+    }
+    Weather w;
+    w.temperature = WeatherBatch::diurnal(mid % WeatherBatch::kDaySeconds);
+    w.humidity = 80.0f - (w.temperature - 15.0f) * 2.0f;
+    if (w.temperature < -10.0f) w.temperature = -10.0f;
+    if (w.temperature > 40.0f) w.temperature = 40.0f;
+    if (w.humidity < 0.0f) w.humidity = 0.0f;
+    if (w.humidity > 100.0f) w.humidity = 100.0f;
+    w.rainfall = kExpectedRainfall;
+    return w;
+}
+
+float EventSimulation::evapotranspiration(const Weather& w) {
+    return (w.temperature / 30.0f) * (1.0f - w.humidity / 100.0f) * 0.05f;
+}
+
+bool EventSimulation::wantsWater(float soilMoisture, float effective, int t) const {
+    // IrrigationController: conservation mode swaps in its own threshold and a night window
+    if (params.conservationModeEnabled &&
+        NightConservation::active(soilMoisture, params.conservationDroughtMoistureThreshold, params.waterCost,
+                                  params.conservationWaterCostThreshold)) {
+        return NightConservation::allowWatering(t, params.conservationNightStartHour, params.conservationNightEndHour) &&
+               effective < params.conservationMoistureThreshold;
+    }
+    return effective < wateringThreshold();
+}
+
+float EventSimulation::wateringThreshold() const {
+    // IrrigationController's threshold policy
+    if (!params.predictiveWateringEnabled) return params.moistureThreshold;
+    return PredictiveWatering::threshold(params.moistureThreshold, rainfallHistory, moistureHistory,
+                                         trendSlopeThreshold, trendAdjustment);
+}
+
+int EventSimulation::findFailure(int from, int end) const {
+    // Same draw as WeatherSensor::update: 0.2% chance per tick while the sensor works
+    int t = from;
+    while (t < end && weatherRng.drawInt(t, 0, 5000) >= 10) ++t;
+    return t;
+}
+
+int EventSimulation::findHeavyRain(int from, int end) const {
+    // The rain WeatherSensor reads on each tick, from the trace or the same draws as WeatherBatch
+    float temperature[64], humidity[64], rainfall[64];
+    for (int t = from; t < end; t += 64) {
+        int n = std::min(64, end - t);
+        if (params.weatherTrace) {
+            for (int i = 0; i < n; ++i) rainfall[i] = params.weatherTrace->sample(t + i).rainfall;
+        } else {
+            WeatherBatch::generateTicks(weatherRng, t, static_cast<size_t>(n), temperature, humidity, rainfall);
+        }
+        for (int i = 0; i < n; ++i) {
+            if (rainfall[i] > kHeavyRain) return t + i;
+        }
+    }
+    return end;
+}
+
+float EventSimulation::rainForecast(int hour) {
+    // WeatherSensor::getRainForecast: the sum of the timeline's first rainForecastHours hours, issued hourly
+    if (hour == forecastHour) return forecast;
+    forecastHour = hour;
+    forecast = 0.0f;
+    for (int h = 0; h < rainForecastHours; ++h) {
+        int64_t start = (static_cast<int64_t>(hour) + h) * 3600;
+        forecast += params.weatherTrace
+            ? params.weatherTrace->rainBetween(start, start + 3600)
+            : WeatherSensor::syntheticForecastRain(forecastRng, params.forecastEnsembleMembers, hour + h);
+    }
+    return forecast;
+}
+
+float EventSimulation::moistureDelta() const {
+    // Per-tick Soil::update change before clamping, with what the soil model is fed right now
+    Weather sensed = state.sensorFailed ? Weather{-999.0f, -999.0f, -999.0f} : weather;
+    float irrigation = pump.isOn() ? pump.getFlowRate() / 60.0f : 0.0f;
+    return (sensed.rainfall + irrigation) * params.soilRetentionRate
+         - evapotranspiration(sensed) * (1.0f - params.soilDrainageFactor);
+}
+
+void EventSimulation::exactTick(int t, Logger& logger) {
+    ProfileScope profile(ProfileSection::ZoneStep);
+    previous = state;
+    havePrevious = t > 0;
+    TickState next;
+    // ZoneSimulation::step, from last tick's reading; a failed sensor reads -999
+    next.forecastRain = t > 0 && !state.sensorFailed && findHeavyRain(t - 1, t) < t;
+    next.wantsWater = false;
+    // IrrigationController::update sees last tick's weather and moisture
+    bool wasOn = pump.isOn();
+    pump.update(t);
+    float effective = moisture + weather.rainfall - evapotranspiration(weather);
+    if (t < 5) {
+        pump.turnOn();
+        next.decision = Forced;
+    } else {
+        if (params.predictiveWateringEnabled) {
+            PredictiveWatering::record(rainfallHistory, moistureHistory, t, weather.rainfall, moisture);
+        }
+        next.wantsWater = wantsWater(moisture, effective, t);
+        // WeatherSensor's forecast was issued on the last tick; a failed sensor reports -999
+        bool delay = params.forecastDelayEnabled && !state.sensorFailed &&
+                     rainForecast((t - 1) / 3600) > rainForecastThreshold;
+        if (delay) {
+            if (pump.isOn()) pump.turnOff();
+            next.decision = Delayed;
+        } else if (next.wantsWater && !next.forecastRain && (pump.isOn() || pump.canRun())) {
+            pump.turnOn();
+            next.decision = Water;
+        } else {
+            if (pump.isOn()) pump.turnOff();
+            next.decision = Idle;
+        }
+    }
+    // GardenZone::settlePumpPermit: a start takes a permit or is undone, a stop returns it
+    if (pump.isOn() && !wasOn) {
+        if (permits < maxPermits) ++permits;
+        else pump.turnOff();
+    } else if (!pump.isOn() && wasOn) {
+        --permits;
+    }
+    // GardenZone::update with this tick's weather; a failed sensor feeds -999 into the soil model
+    if (t == nextFailure) failureStart = t;
+    next.sensorFailed = failureStart >= 0;
+    Weather sensed = next.sensorFailed ? Weather{-999.0f, -999.0f, -999.0f} : expectedWeather(t);
+    if (!next.sensorFailed) weather = sensed;
+    float irrigation = pump.isOn() ? pump.getFlowRate() / 60.0f : 0.0f;
+    moisture += (sensed.rainfall + irrigation) * params.soilRetentionRate;
+    moisture -= evapotranspiration(sensed) * (1.0f - params.soilDrainageFactor);
+    if (moisture > 100.0f) moisture = 100.0f;
+    if (moisture < 0.0f) moisture = 0.0f;
+    float absorbed = moisture * params.plantAbsorptionRate;
+    float needPerSecond = params.plantWaterNeedPerDay / 86400.0f;
+    if (absorbed < needPerSecond) {
+        stress += (needPerSecond - absorbed) * 10.0f;
+    } else {
+        stress -= 0.1f;
+    }
+    if (stress < 0.0f) stress = 0.0f;
+    if (stress > 100.0f) stress = 100.0f;
+    next.pumpOn = pump.isOn();
+    next.runTime = pump.getRunTime();
+    next.cooldownLeft = pump.getCooldownLeft();
+    next.permits = permits;
+    state = next;
+    bool on = pump.isOn();
+    logger.logSecond(t, moisture, moisture + weather.rainfall - evapotranspiration(weather),
+                     weather.temperature, weather.humidity, weather.rainfall, on, pump.getFlowRate(),
+                     on ? pump.getFlowRate() * (params.simulationStep / 60.0f) : 0.0f,
+                     stress, next.sensorFailed, zoneId, soilType,
+                     on ? pump.getPowerWatts() * (params.simulationStep / 3600.0f) : 0.0f);
+    if (next.sensorFailed && t - failureStart == kFailureTicks - 1) {
+        failureStart = -1;
+        nextFailure = findFailure(t + 1, failureEnd);
+    }
+}
+
+bool EventSimulation::isSteady() const {
+    if (!havePrevious) return false;
+    if (state.pumpOn != previous.pumpOn || state.permits != previous.permits || state.decision != previous.decision
+        || state.wantsWater != previous.wantsWater || state.forecastRain != previous.forecastRain
+        || state.sensorFailed != previous.sensorFailed) {
+        return false;
+    }
+    if (state.pumpOn) {
+        return state.runTime == previous.runTime + 1 && state.cooldownLeft == previous.cooldownLeft;
+    }
+    // Off: either cooled down, or counting down
+    return state.runTime == previous.runTime
+        && (state.cooldownLeft == previous.cooldownLeft || state.cooldownLeft == previous.cooldownLeft - 1);
+}
+
+int EventSimulation::nextEvent(int t, int end) const {
+    int e = end;
+    if (t < 5 && e > 5) e = 5;
+    int segment = (t / weatherResolution + 1) * weatherResolution;
+    if (segment < e) e = segment;
+    int hour = (t / 3600 + 1) * 3600;
+    if (hour < e) e = hour;
+    // The tick after an hour starts sees the new forecast
+    int issued = ((t - 1) / 3600 + 1) * 3600 + 1;
+    if (issued < e) e = issued;
+    if (!state.sensorFailed && nextFailure < e) e = nextFailure;
+    // The last failed tick runs exactly, since the sensor is reset on it
+    if (state.sensorFailed && failureStart + kFailureTicks - 1 < e) e = failureStart + kFailureTicks - 1;
+    if (state.pumpOn) {
+        int expiry = t + pump.getMaxRunTime() - state.runTime;
+        if (expiry < e) e = expiry;
+        // Heavy rain on a tick stops the pump on the next one
+        int rain = findHeavyRain(t, e - 1);
+        if (rain + 1 < e) e = rain + 1;
+    } else if (state.cooldownLeft == previous.cooldownLeft - 1) {
+        int cooled = t + (state.cooldownLeft > 0 ? state.cooldownLeft : 1);
+        if (cooled < e) e = cooled;
+    }
+    if (t >= 5 && e > t + 1) {
+        // Tick k's controller looks at moisture after tick k-1; thresholds and the hour do not change in the span
+        float offset = weather.rainfall - evapotranspiration(weather);
+        double m = moisture, d = moistureDelta();
+        int span = e - t - 1;
+        int flip = firstIndex(span, [&](int i) {
+            double mk = m + i * d;
+            if (mk > 100.0) mk = 100.0;
+            if (mk < 0.0) mk = 0.0;
+            return wantsWater(static_cast<float>(mk), static_cast<float>(mk + offset), t + 1 + i) != state.wantsWater;
+        });
+        if (flip < span) e = t + 1 + flip;
+    }
+    return e;
+}
+
+void EventSimulation::skipTicks(int first, int count, Logger& logger) {
+    double m = moisture, d = moistureDelta();
+    double absorption = params.plantAbsorptionRate;
+    double needPerSecond = params.plantWaterNeedPerDay / 86400.0f;
+    // Moisture on span tick i is m + (i + 1) d until it reaches a bound, then stays there
+    double bound = d > 0.0 ? 100.0 : 0.0;
+    int linear = d == 0.0 ? count : firstIndex(count, [&](int i) {
+        double mk = m + (i + 1) * d;
+        return d > 0.0 ? mk >= 100.0 : mk <= 0.0;
+    });
+    // Plant::update changes branch where absorbed water crosses the per-second need
+    bool firstStressed = (m + d) * absorption < needPerSecond;
+    int split = firstIndex(linear, [&](int i) {
+        return ((m + (i + 1) * d) * absorption < needPerSecond) != firstStressed;
+    });
+    double stressSum = 0.0;
+    int healthy = 0;
+    // Stress is monotonic within each phase, so its range is set by the first tick and the phase ends
+    double stressMin = 100.0, stressMax = 0.0;
+    auto phase = [&](double s0, int n, double m0, double dm) {
+        if (n <= 0) return s0;
+        double firstSum = 0.0;
+        int firstHealthy = 0;
+        double first = advancePlant(s0, 1, m0, dm, absorption, needPerSecond, firstSum, firstHealthy);
+        double last = advancePlant(s0, n, m0, dm, absorption, needPerSecond, stressSum, healthy);
+        stressMin = std::min(stressMin, std::min(first, last));
+        stressMax = std::max(stressMax, std::max(first, last));
+        return last;
+    };
+    double s = stress;
+    s = phase(s, split, m + d, d);
+    s = phase(s, linear - split, m + (split + 1) * d, d);
+    s = phase(s, count - linear, bound, 0.0);
+    stress = static_cast<float>(s);
+    float moistureFirst = static_cast<float>(linear > 0 ? m + d : bound);
+    moisture = static_cast<float>(linear < count ? bound : m + count * d);
+    // Linear up to the bound, then flat: sum of m + (i + 1) d over [0, linear), plus the clamped ticks
+    double moistureSum = linear * m + d * linear * (linear + 1.0) / 2.0 + (count - linear) * bound;
+    pump.advance(count);
+    state.runTime = pump.getRunTime();
+    state.cooldownLeft = pump.getCooldownLeft();
+    float water = state.pumpOn ? count * pump.getFlowRate() * (params.simulationStep / 60.0f) : 0.0f;
+    float power = state.pumpOn ? count * pump.getPowerWatts() * (params.simulationStep / 3600.0f) : 0.0f;
+    logger.logSpan(count, water, power, stressSum, healthy, state.sensorFailed ? count : 0, first, moistureFirst,
+                   moisture, moistureSum, static_cast<float>(stressMin), static_cast<float>(stressMax),
+                   state.pumpOn, zoneId);
+}
+
+EventRunStats EventSimulation::run(int durationSeconds, Logger& logger) {
+    EventRunStats stats;
+    failureEnd = durationSeconds;
+    nextFailure = findFailure(0, durationSeconds);
+    int t = 0;
+    while (t < durationSeconds) {
+        exactTick(t, logger);
+        ++stats.exactTicks;
+        if (skipping && isSteady()) {
+            int e = nextEvent(t, durationSeconds);
+            int count = e - t - 1;
+            if (count > 0) {
+                skipTicks(t + 1, count, logger);
+                stats.skippedTicks += count;
+                ++stats.spans;
+                t = e;
+                continue;
+            }
+        }
+        ++t;
+    }
+    return stats;
+}
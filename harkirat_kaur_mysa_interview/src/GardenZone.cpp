@@ -1,29 +1,50 @@
 #include "../include/GardenZone.h"
+#include "../include/Profiler.h"
 
-GardenZone::GardenZone(Plant* plant, Soil* soil, WeatherSensor* weather, WaterPump* pump)
-    : plant(plant), soil(soil), weather(weather), pump(pump) {}
+bool PumpBudget::tryAcquire() {
+    int count = active.load();
+    while (count < maxActive.load()) {
+        if (active.compare_exchange_weak(count, count + 1)) return true;
+    }
+    return false;
+}
+void PumpBudget::release() {
+    int count = active.load();
+    while (count > 0 && !active.compare_exchange_weak(count, count - 1)) {}
+}
 
-// Static members for multi-zone coordination
-int GardenZone::activePumpCount = 0;
-int GardenZone::maxConcurrentPumps = 2;
+GardenZone::GardenZone(Plant* plant, Soil* soil, WeatherSensor* weather, WaterPump* pump, PumpBudget* budget)
+    : plant(plant), soil(soil), weather(weather), pump(pump), budget(budget ? budget : &siteBudget()) {}
 
+// Site-wide budget for multi-zone coordination
+PumpBudget& GardenZone::siteBudget() {
+    static PumpBudget site(2);
+    return site;
+}
 void GardenZone::setMaxConcurrentPumps(int max) {
-    maxConcurrentPumps = max;
+    siteBudget().setMax(max);
 }
 int GardenZone::getActivePumpCount() {
-    return activePumpCount;
+    return siteBudget().getActive();
+}
+int GardenZone::getMaxConcurrentPumps() {
+    return siteBudget().getMax();
 }
 bool GardenZone::canActivatePump() {
-    return activePumpCount < maxConcurrentPumps;
+    return siteBudget().canActivate();
+}
+bool GardenZone::tryAcquirePump() {
+    return siteBudget().tryAcquire();
 }
 void GardenZone::incrementActivePumps() {
-    ++activePumpCount;
+    siteBudget().increment();
 }
 void GardenZone::decrementActivePumps() {
-    if (activePumpCount > 0) --activePumpCount;
+    siteBudget().release();
 }
 
 void GardenZone::update(int secondsElapsed) {
+    ProfileScope profile(ProfileSection::ZoneUpdate);
     weather->update(secondsElapsed);
     float temp = weather->getTemperature();
     float humidity = weather->getHumidity();
@@ -36,12 +57,15 @@ void GardenZone::update(int secondsElapsed) {
     }
     soil->update(evapotranspiration, rainfall, irrigation);
     plant->update(soil->getMoisture());
-    // Multi-zone pump coordination: only activate pump if allowed
-    if (!pump->isOn() && canActivatePump()) {
-        pump->turnOn();
-        incrementActivePumps();
-    } else if (pump->isOn() && !canActivatePump()) {
+}
+
+bool GardenZone::settlePumpPermit(bool wasOn) {
+    // Permits follow real pump transitions, whether the controller, max runtime or a refusal caused them
+    if (pump->isOn() && !wasOn) {
+        if (budget->tryAcquire()) return true;
         pump->turnOff();
-        decrementActivePumps();
+        return false;
     }
-} 
\ No newline at end of file
+    if (!pump->isOn() && wasOn) budget->release();
+    return true;
+}
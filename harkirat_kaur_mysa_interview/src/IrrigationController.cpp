@@ -1,10 +1,80 @@
 #include "../include/IrrigationController.h"
-#include <cstdlib>
-#include <ctime>
+#include <algorithm>
+#include <cmath>
 
-IrrigationController::IrrigationController(Soil* soil, WeatherSensor* weather, WaterPump* pump, Logger* loggerPtr)
-    : soil(soil), weather(weather), pump(pump), logger(loggerPtr), moistureThreshold(40.0f), forecastRain(false) {
-    std::srand(static_cast<unsigned int>(std::time(nullptr)));
+const char* pumpReasonName(PumpReason reason) {
+    switch (reason) {
+        case PumpReason::Forced: return "forced";
+        case PumpReason::Dry: return "dry";
+        case PumpReason::RainForecast: return "rain_forecast";
+        case PumpReason::RainNow: return "rain_now";
+        case PumpReason::PumpLimit: return "pump_limit";
+        case PumpReason::NightWindow: return "night_window";
+        case PumpReason::MoistureOk: return "moisture_ok";
+        case PumpReason::ZoneBudget: return "zone_budget";
+        case PumpReason::Planned: return "planned";
+    }
+    return "unknown";
+}
+
+IrrigationController::IrrigationController(Soil* soil, WeatherSensor* weather, WaterPump* pump, Logger* loggerPtr,
+                                           const CounterRng& rng)
+    : soil(soil), weather(weather), pump(pump), logger(loggerPtr), moistureThreshold(40.0f), forecastRain(false),
+      rng(rng.withStream(CounterRng::ControllerStream)) {
+    selectPipeline();
+}
+
+float PredictiveWatering::threshold(float base, const RollingWindow& rainfall, const RollingWindow& moisture,
+                                    float trendSlopeThreshold, float trendAdjustment) {
+    float avgRain = rainfall.mean();
+    float avgMoisture = moisture.mean();
+    float moistureTrend = moisture.size() >= 3 ? moisture.slope() : 0.0f; // %/hour
+    /*
+     * Predictive watering logic:
+     * - If the last 2-3 days have been dry (low avgRain, low avgMoisture), be more aggressive (lower threshold).
+     * - If wet (high avgRain, high avgMoisture), be more conservative (raise threshold).
+     * - Assumptions: "Dry" means avgRain < 1mm/hr and avgMoisture < 30%. "Wet" means avgRain > 2mm/hr or avgMoisture > 60%.
+     * - Adjust threshold by +/- 5%.
+     * - Trend: if moisture is falling faster than trendSlopeThreshold %/hour, start watering earlier
+     *   (raise threshold by trendAdjustment); if it is rising that fast, hold off (lower it).
+     */
+    float predictiveThreshold = base;
+    if (avgRain < 1.0f && avgMoisture < 30.0f) {
+        predictiveThreshold -= 5.0f; // Be more aggressive
+    } else if (avgRain > 2.0f || avgMoisture > 60.0f) {
+        predictiveThreshold += 5.0f; // Be more conservative
+    }
+    if (trendSlopeThreshold > 0.0f) {
+        if (moistureTrend < -trendSlopeThreshold) {
+            predictiveThreshold += trendAdjustment; // Drying out: water before crossing the threshold
+        } else if (moistureTrend > trendSlopeThreshold) {
+            predictiveThreshold -= trendAdjustment; // Wetting up: let the trend carry it
+        }
+    }
+    return predictiveThreshold;
+}
+
+void IrrigationController::selectPipeline() {
+    if (plannerEnabled) {
+        pipeline = &IrrigationController::decidePlanned;
+        conservationActive = false;
+        return;
+    }
+    // Runtime factory over the eight instantiations, indexed by the enabled features
+    typedef void (IrrigationController::*Pipeline)(int);
+    static const Pipeline pipelines[8] = {
+        &IrrigationController::decide<FixedThreshold, NoForecastDelay, NoConservation>,
+        &IrrigationController::decide<FixedThreshold, NoForecastDelay, NightConservation>,
+        &IrrigationController::decide<FixedThreshold, ForecastDelay, NoConservation>,
+        &IrrigationController::decide<FixedThreshold, ForecastDelay, NightConservation>,
+        &IrrigationController::decide<PredictiveWatering, NoForecastDelay, NoConservation>,
+        &IrrigationController::decide<PredictiveWatering, NoForecastDelay, NightConservation>,
+        &IrrigationController::decide<PredictiveWatering, ForecastDelay, NoConservation>,
+        &IrrigationController::decide<PredictiveWatering, ForecastDelay, NightConservation>,
+    };
+    pipeline = pipelines[(predictiveWateringEnabled ? 4 : 0) + (forecastDelayEnabled ? 2 : 0) +
+                         (conservationModeEnabled ? 1 : 0)];
+    if (!conservationModeEnabled) conservationActive = false;
 }
 
 void IrrigationController::setMoistureThreshold(float threshold) {
@@ -23,8 +93,19 @@ void IrrigationController::setRainForecastThreshold(float mm) {
     rainForecastThreshold = mm;
 }
 
+void IrrigationController::setForecastDelayEnabled(bool enabled) {
+    forecastDelayEnabled = enabled;
+    selectPipeline();
+}
+
+void IrrigationController::setPredictiveWateringEnabled(bool enabled) {
+    predictiveWateringEnabled = enabled;
+    selectPipeline();
+}
+
 void IrrigationController::setConservationModeEnabled(bool enabled) {
     conservationModeEnabled = enabled;
+    selectPipeline();
 }
 void IrrigationController::setConservationWaterCostThreshold(float threshold) {
     conservationWaterCostThreshold = threshold;
@@ -43,46 +124,71 @@ void IrrigationController::setCurrentWaterCost(float cost) {
     currentWaterCost = cost;
 }
 
+void IrrigationController::setPlannerEnabled(bool enabled) {
+    if (enabled == plannerEnabled) return;
+    plannerEnabled = enabled;
+    if (enabled) planner.configure(plannerModel);
+    runStage = -1; // Decide afresh at the next update
+    selectPipeline();
+}
+
+void IrrigationController::setPlannerModel(const PlannerModel& model) {
+    if (model == plannerModel) return;
+    plannerModel = model;
+    planStage = -1;
+    if (plannerEnabled) planner.configure(plannerModel);
+}
+
 void IrrigationController::setHistoryWindowDays(int days) {
     historyWindowDays = days;
     historyWindowHours = days * 24;
-    rainfallHistory.clear();
-    moistureHistory.clear();
+    rainfallHistory.reset(historyWindowHours);
+    moistureHistory.reset(historyWindowHours);
+}
+
+void IrrigationController::setTrendSlopeThreshold(float percentPerHour) {
+    trendSlopeThreshold = percentPerHour;
 }
 
 float IrrigationController::getNoisyMoisture() const {
-    float noise = (std::rand() % 100 - 50) / 100.0f; // -0.5 to +0.5
+    float noise = (rng.drawInt(lastTick, 0, 100) - 50) / 100.0f; // -0.5 to +0.5
     return soil->getMoisture() + noise;
 }
 
-void IrrigationController::update(int secondsElapsed) {
-    pump->update(secondsElapsed);
+void IrrigationController::readSensors(float& soilMoisture, float& temp, float& humidity, float& recentRain) {
     // --- Sensor failure handling and fallback ---
-    float soilMoisture = soil->getMoisture();
+    soilMoisture = soil->getMoisture();
     if (soilMoisture < 0) {
         soilMoisture = lastKnownSoilMoisture;
     } else {
         lastKnownSoilMoisture = soilMoisture;
     }
-    float temp = weather->getTemperature();
+    temp = weather->getTemperature();
     if (temp == -999.0f) {
         temp = lastKnownTemperature;
     } else {
         lastKnownTemperature = temp;
     }
-    float humidity = weather->getHumidity();
+    humidity = weather->getHumidity();
     if (humidity == -999.0f) {
         humidity = lastKnownHumidity;
     } else {
         lastKnownHumidity = humidity;
     }
-    float recentRain = weather->getRainfall();
+    recentRain = weather->getRainfall();
     if (recentRain == -999.0f) {
         recentRain = lastKnownRainfall;
     } else {
         lastKnownRainfall = recentRain;
     }
-    // --- End sensor fallback ---
+}
+
+template <class Predictive, class Forecast, class Conservation>
+void IrrigationController::decide(int secondsElapsed) {
+    lastTick = secondsElapsed;
+    pump->update(secondsElapsed);
+    float soilMoisture, temp, humidity, recentRain;
+    readSensors(soilMoisture, temp, humidity, recentRain);
     /*
      * Effective moisture calculation:
      *   effectiveMoisture = soilMoisture + recentRainfall * retentionFactor - evapotranspiration;
@@ -95,74 +201,160 @@ void IrrigationController::update(int secondsElapsed) {
      * Note: In this implementation, soilMoisture already incorporates rainfall and retentionFactor via Soil::update().
      * Here, recentRainfall is used directly for short-term irrigation logic, not as a rolling sum.
      */
-    float noise = (std::rand() % 100 - 50) / 100.0f; // -0.5 to +0.5
+    float noise = (rng.drawInt(secondsElapsed, 0, 100) - 50) / 100.0f; // -0.5 to +0.5
     float noisyMoisture = soilMoisture + noise;
     float evap = (temp / 30.0f) * (1.0f - humidity / 100.0f) * 0.05f; // evapotranspiration estimate
     float effectiveMoisture = noisyMoisture + recentRain - evap;
+    // Water Conservation Mode: active while enabled and water is expensive or the soil is in drought
+    conservationActive = Conservation::active(soil->getMoisture(), conservationDroughtMoistureThreshold,
+                                              currentWaterCost, conservationWaterCostThreshold);
     // --- Force pump ON for first 5 seconds ---
     if (secondsElapsed < 5) {
-        pump->turnOn();
+        if (pumpPermit) {
+            pump->turnOn();
+            lastReason = PumpReason::Forced;
+        } else {
+            lastReason = PumpReason::ZoneBudget;
+        }
         return;
     }
     // --- Predictive Watering: Track and use weather/moisture trends ---
-    // Record hourly rainfall and soil moisture
-    if (secondsElapsed % 3600 == 0) {
-        if (rainfallHistory.size() >= (size_t)historyWindowHours) rainfallHistory.erase(rainfallHistory.begin());
-        if (moistureHistory.size() >= (size_t)historyWindowHours) moistureHistory.erase(moistureHistory.begin());
-        rainfallHistory.push_back(recentRain);
-        moistureHistory.push_back(soil->getMoisture());
-    }
-    // Calculate moving averages over the history window
-    float avgRain = 0.0f, avgMoisture = 0.0f;
-    if (!rainfallHistory.empty()) {
-        for (float r : rainfallHistory) avgRain += r;
-        avgRain /= rainfallHistory.size();
-    }
-    if (!moistureHistory.empty()) {
-        for (float m : moistureHistory) avgMoisture += m;
-        avgMoisture /= moistureHistory.size();
-    }
-    /*
-     * Predictive watering logic:
-     * - If the last 2-3 days have been dry (low avgRain, low avgMoisture), be more aggressive (lower threshold).
-     * - If wet (high avgRain, high avgMoisture), be more conservative (raise threshold).
-     * - Assumptions: "Dry" means avgRain < 1mm/hr and avgMoisture < 30%. "Wet" means avgRain > 2mm/hr or avgMoisture > 60%.
-     * - Adjust threshold by +/- 5%.
-     */
-    float predictiveThreshold = moistureThreshold;
-    if (avgRain < 1.0f && avgMoisture < 30.0f) {
-        predictiveThreshold -= 5.0f; // Be more aggressive
-    } else if (avgRain > 2.0f || avgMoisture > 60.0f) {
-        predictiveThreshold += 5.0f; // Be more conservative
-    }
+    Predictive::record(rainfallHistory, moistureHistory, secondsElapsed, recentRain, soil->getMoisture());
+    float predictiveThreshold = Predictive::threshold(moistureThreshold, rainfallHistory, moistureHistory,
+                                                      trendSlopeThreshold, trendAdjustment);
     // Weather-aware irrigation: delay if rain forecast exceeds threshold
-    float rainForecast = weather->getRainForecast(rainForecastHours);
-    if (rainForecast > rainForecastThreshold) {
+    if (Forecast::delay(*weather, rainForecastHours, rainForecastThreshold)) {
         // Delay irrigation due to forecasted rain
-        pump->turnOff();
+        if (pump->isOn()) pump->turnOff();
+        lastReason = PumpReason::RainForecast;
         return;
     }
-    // Water Conservation Mode
-    bool drought = soil->getMoisture() < conservationDroughtMoistureThreshold;
-    bool highCost = currentWaterCost > conservationWaterCostThreshold;
-    bool conservationActive = conservationModeEnabled && (highCost || drought);
     float thresholdToUse = conservationActive ? conservationMoistureThreshold : predictiveThreshold;
     // Only water at night if conservation mode is active
-    bool allowWatering = true;
-    if (conservationActive) {
-        // Calculate current hour (0-23) from secondsElapsed
-        int hour = (secondsElapsed / 3600) % 24;
-        if (conservationNightStartHour < conservationNightEndHour) {
-            // Night window does not cross midnight
-            allowWatering = (hour >= conservationNightStartHour && hour < conservationNightEndHour);
+    bool allowWatering = !conservationActive ||
+        Conservation::allowWatering(secondsElapsed, conservationNightStartHour, conservationNightEndHour);
+    // A running pump keeps watering until the soil is wet enough or it reaches its max run time
+    bool canWater = pump->isOn() || pump->canRun();
+    if (effectiveMoisture < thresholdToUse && !forecastRain && canWater && allowWatering) {
+        if (pumpPermit) {
+            pump->turnOn();
+            lastReason = PumpReason::Dry;
         } else {
-            // Night window crosses midnight
-            allowWatering = (hour >= conservationNightStartHour || hour < conservationNightEndHour);
+            if (pump->isOn()) pump->turnOff();
+            lastReason = PumpReason::ZoneBudget; // Pump stays off without starting a cooldown
         }
+    } else {
+        if (pump->isOn()) pump->turnOff(); // Stopping a resting pump would restart its cooldown
+        if (effectiveMoisture >= thresholdToUse) lastReason = PumpReason::MoistureOk;
+        else if (forecastRain) lastReason = PumpReason::RainNow;
+        else if (!pump->canRun()) lastReason = PumpReason::PumpLimit;
+        else lastReason = PumpReason::NightWindow;
     }
-    if (effectiveMoisture < thresholdToUse && !forecastRain && pump->canRun() && allowWatering) {
-        pump->turnOn();
+} 
+
+int64_t IrrigationController::firstPlanStage(int64_t stage) const {
+    // The first stage starting in the hour this one starts in. The plan in force is then a function of the
+    // stage alone, so a restored checkpoint re-plans to the schedule the original run followed.
+    double stageSeconds = static_cast<double>(planner.getStageTicks()) * plannerModel.tickSeconds;
+    double hourStart = std::floor(stage * stageSeconds / 3600.0) * 3600.0;
+    int64_t first = static_cast<int64_t>(std::ceil(hourStart / stageSeconds));
+    return first < stage ? first : stage;
+}
+
+void IrrigationController::replan(int64_t first) {
+    int stageTicks = planner.getStageTicks();
+    double stageSeconds = static_cast<double>(stageTicks) * plannerModel.tickSeconds;
+    plannerInputs.resize(planner.getStageCount());
+    for (size_t k = 0; k < plannerInputs.size(); ++k) {
+        double start = (first + static_cast<int64_t>(k)) * stageSeconds;
+        double end = start + stageSeconds;
+        // Forecast rain of every hour the stage overlaps, in proportion to the overlap, spread over its updates
+        float rain = 0.0f;
+        for (int64_t hour = static_cast<int64_t>(std::floor(start / 3600.0)); hour * 3600.0 < end; ++hour) {
+            double overlap = std::min(end, (hour + 1) * 3600.0) - std::max(start, hour * 3600.0);
+            rain += weather->getForecastRainAt(hour) * static_cast<float>(overlap / 3600.0);
+        }
+        WeatherSample w = weather->expectedWeather(static_cast<int64_t>(start + stageSeconds / 2.0));
+        plannerInputs[k].rain = rain / stageTicks;
+        plannerInputs[k].evapotranspiration = (w.temperature / 30.0f) * (1.0f - w.humidity / 100.0f) * 0.05f;
+    }
+    planner.plan(first, plannerInputs.data());
+    planStage = first;
+}
+
+void IrrigationController::decidePlanned(int secondsElapsed) {
+    lastTick = secondsElapsed;
+    pump->update(secondsElapsed);
+    float soilMoisture, temp, humidity, recentRain;
+    readSensors(soilMoisture, temp, humidity, recentRain);
+    if (secondsElapsed < 5) {
+        if (pumpPermit) {
+            pump->turnOn();
+            lastReason = PumpReason::Forced;
+        } else {
+            lastReason = PumpReason::ZoneBudget;
+        }
+        return;
+    }
+    int64_t tick = static_cast<int64_t>(secondsElapsed / plannerModel.tickSeconds + 0.5f);
+    int64_t stage = tick / planner.getStageTicks();
+    if (stage != runStage) {
+        // Stage start (or the first update after enabling): re-plan if a new hour began, then pick this stage's run
+        int64_t first = firstPlanStage(stage);
+        if (first != planStage || !planner.covers(stage)) replan(first);
+        float noise = (rng.drawInt(secondsElapsed, 0, 100) - 50) / 100.0f; // -0.5 to +0.5
+        runStage = stage;
+        runStart = tick;
+        runTicks = planner.decide(stage, static_cast<int>(tick - stage * planner.getStageTicks()), soilMoisture + noise,
+                                  pump->isOn() || pump->canRun());
+    }
+    bool wanted = tick - runStart < runTicks;
+    if (pump->isOn()) {
+        if (!wanted) pump->turnOff();
+        lastReason = PumpReason::Planned;
+    } else if (!wanted) {
+        lastReason = PumpReason::Planned; // Resting; no turnOff(), so the cooldown is not restarted
+    } else if (!pump->canRun()) {
+        lastReason = PumpReason::PumpLimit;
+    } else if (!pumpPermit) {
+        lastReason = PumpReason::ZoneBudget;
     } else {
-        pump->turnOff();
+        pump->turnOn();
+        lastReason = PumpReason::Planned;
     }
-} 
\ No newline at end of file
+}
+
+void IrrigationController::save(SnapshotWriter& out) const {
+    out.write(forecastRain);
+    out.write(lastTick);
+    out.write(conservationActive);
+    out.write(lastReason);
+    rainfallHistory.save(out);
+    moistureHistory.save(out);
+    out.write(lastKnownSoilMoisture);
+    out.write(lastKnownTemperature);
+    out.write(lastKnownHumidity);
+    out.write(lastKnownRainfall);
+    out.write(runStage);
+    out.write(runStart);
+    out.write(runTicks);
+}
+
+void IrrigationController::restore(SnapshotReader& in) {
+    in.read(forecastRain);
+    in.read(lastTick);
+    in.read(conservationActive);
+    in.read(lastReason);
+    rainfallHistory.restore(in);
+    moistureHistory.restore(in);
+    historyWindowHours = static_cast<int>(moistureHistory.capacity());
+    historyWindowDays = historyWindowHours / 24;
+    in.read(lastKnownSoilMoisture);
+    in.read(lastKnownTemperature);
+    in.read(lastKnownHumidity);
+    in.read(lastKnownRainfall);
+    in.read(runStage);
+    in.read(runStart);
+    in.read(runTicks);
+    planStage = -1; // Re-planned from the restored stage; plans do not depend on when they were made
+}
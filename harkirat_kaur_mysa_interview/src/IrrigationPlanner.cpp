@@ -0,0 +1,151 @@
+#include "../include/IrrigationPlanner.h"
+#include <cmath>
+
+bool PlannerModel::operator==(const PlannerModel& o) const {
+    return retentionRate == o.retentionRate && drainageFactor == o.drainageFactor &&
+           irrigationPerTick == o.irrigationPerTick && maxRunTicks == o.maxRunTicks &&
+           cooldownTicks == o.cooldownTicks && tickSeconds == o.tickSeconds &&
+           moistureThreshold == o.moistureThreshold && waterCost == o.waterCost &&
+           stressPenalty == o.stressPenalty && horizonTicks == o.horizonTicks;
+}
+
+void IrrigationPlanner::configure(const PlannerModel& m) {
+    if (configured && m == model) return;
+    model = m;
+    if (model.maxRunTicks < 0) model.maxRunTicks = 0;
+    if (model.cooldownTicks < 0) model.cooldownTicks = 0;
+    if (model.horizonTicks < 1) model.horizonTicks = 1;
+    stageTicks = model.maxRunTicks + model.cooldownTicks;
+    int shortest = (model.horizonTicks + kMaxStages - 1) / kMaxStages; // Keeps the horizon within kMaxStages
+    if (stageTicks < shortest) stageTicks = shortest;
+    if (stageTicks < 1) stageTicks = 1;
+    stageCount = (model.horizonTicks + stageTicks - 1) / stageTicks;
+    for (int a = 0; a < kActions; ++a) runTicks[a] = model.maxRunTicks * a / (kActions - 1);
+    // Room for the stages an hourly re-plan moves on by, so the overlap keeps its tables
+    double perHour = std::ceil(3600.0 / (static_cast<double>(stageTicks) * model.tickSeconds));
+    int shift = perHour < stageCount ? static_cast<int>(perHour) : stageCount;
+    tables.assign(stageCount + shift, StageTable());
+    value.assign(static_cast<size_t>(stageCount + 1) * kCells, 0.0f);
+    configured = true;
+    planned = false;
+}
+
+float IrrigationPlanner::advance(float moisture, float rate, int ticks, float threshold, float& deficit) {
+    if (ticks <= 0) return moisture;
+    // Linear until the clamp at 0 or 100, then constant
+    float bound = rate > 0.0f ? 100.0f : 0.0f;
+    float linearTicks = rate == 0.0f ? static_cast<float>(ticks) : (bound - moisture) / rate;
+    if (linearTicks > ticks) linearTicks = static_cast<float>(ticks);
+    if (linearTicks < 0.0f) linearTicks = 0.0f;
+    float end = rate == 0.0f ? moisture : moisture + rate * linearTicks;
+    if (end > 100.0f) end = 100.0f;
+    if (end < 0.0f) end = 0.0f;
+    float low = moisture < end ? moisture : end;
+    float high = moisture < end ? end : moisture;
+    if (high <= threshold) {
+        deficit += linearTicks * (threshold - 0.5f * (low + high));
+    } else if (low < threshold) {
+        // Only the part of the segment below the threshold
+        deficit += 0.5f * (threshold - low) * linearTicks * (threshold - low) / (high - low);
+    }
+    if (end < threshold) deficit += (ticks - linearTicks) * (threshold - end);
+    return end;
+}
+
+float IrrigationPlanner::runCost(int ticks) const {
+    return model.waterCost * model.irrigationPerTick * model.tickSeconds * ticks;
+}
+
+float IrrigationPlanner::stageCost(const PlannerStageInput& input, float moisture, int run, int length, float& next) const {
+    float loss = input.evapotranspiration * (1.0f - model.drainageFactor);
+    float onRate = (input.rain + model.irrigationPerTick) * model.retentionRate - loss;
+    float offRate = input.rain * model.retentionRate - loss;
+    float deficit = 0.0f;
+    float m = advance(moisture, onRate, run, model.moistureThreshold, deficit);
+    next = advance(m, offRate, length - run, model.moistureThreshold, deficit);
+    return runCost(run) + model.stressPenalty * deficit * (model.tickSeconds / 3600.0f);
+}
+
+void IrrigationPlanner::buildTable(StageTable& table, int64_t stage, const PlannerStageInput& input) {
+    table.stage = stage;
+    table.input = input;
+    for (int a = 0; a < kActions; ++a) {
+        for (int c = 0; c < kCells; ++c) {
+            table.cost[a][c] = stageCost(input, static_cast<float>(c), runTicks[a], stageTicks, table.next[a][c]);
+        }
+    }
+}
+
+float IrrigationPlanner::interpolate(const float* row, float moisture) {
+    if (moisture <= 0.0f) return row[0];
+    if (moisture >= kCells - 1) return row[kCells - 1];
+    int cell = static_cast<int>(moisture);
+    float f = moisture - cell;
+    return row[cell] + f * (row[cell + 1] - row[cell]);
+}
+
+void IrrigationPlanner::plan(int64_t first, const PlannerStageInput* inputs) {
+    if (!configured) configure(model);
+    ++stats.plans;
+    firstStage = first;
+    // Terminal cost: one more stage at the final moisture, unwatered
+    float* terminal = &value[static_cast<size_t>(stageCount) * kCells];
+    float perTick = model.stressPenalty * (model.tickSeconds / 3600.0f);
+    for (int c = 0; c < kCells; ++c) {
+        terminal[c] = c < model.moistureThreshold ? perTick * stageTicks * (model.moistureThreshold - c) : 0.0f;
+    }
+    for (int k = stageCount - 1; k >= 0; --k) {
+        int64_t stage = first + k;
+        StageTable& table = tables[static_cast<size_t>(stage % static_cast<int64_t>(tables.size()))];
+        const PlannerStageInput& input = inputs[k];
+        if (table.stage == stage && table.input.rain == input.rain &&
+            table.input.evapotranspiration == input.evapotranspiration) {
+            ++stats.tablesReused;
+        } else {
+            buildTable(table, stage, input);
+            ++stats.tablesBuilt;
+        }
+        const float* next = &value[static_cast<size_t>(k + 1) * kCells];
+        float* row = &value[static_cast<size_t>(k) * kCells];
+        for (int c = 0; c < kCells; ++c) {
+            float best = table.cost[0][c] + interpolate(next, table.next[0][c]);
+            for (int a = 1; a < kActions; ++a) {
+                float q = table.cost[a][c] + interpolate(next, table.next[a][c]);
+                if (q < best) best = q; // Ties keep the shorter run
+            }
+            row[c] = best;
+        }
+    }
+    planned = true;
+}
+
+int IrrigationPlanner::decide(int64_t stage, int elapsed, float moisture, bool canStart) const {
+    if (!covers(stage)) return 0;
+    if (moisture < 0.0f) moisture = 0.0f;
+    if (moisture > 100.0f) moisture = 100.0f;
+    int k = static_cast<int>(stage - firstStage);
+    int length = stageTicks - (elapsed > 0 ? elapsed : 0);
+    if (length < 1) length = 1;
+    int longest = length - model.cooldownTicks; // The stage must still hold the cooldown after the run
+    if (longest < 0 || !canStart) longest = 0;
+    const StageTable& table = tables[static_cast<size_t>(stage % static_cast<int64_t>(tables.size()))];
+    const float* next = &value[static_cast<size_t>(k + 1) * kCells];
+    // Exact one-stage look-ahead from the measured moisture onto the planned cost-to-go
+    int bestRun = 0;
+    float best = 0.0f;
+    for (int a = 0; a < kActions; ++a) {
+        int run = runTicks[a] < longest ? runTicks[a] : longest;
+        if (a > 0 && run == 0) break;
+        float end = 0.0f;
+        float q = stageCost(table.input, moisture, run, length, end) + interpolate(next, end);
+        if (a == 0 || q < best) {
+            best = q;
+            bestRun = run;
+        }
+    }
+    return bestRun;
+}
+
+float IrrigationPlanner::expectedCost(float moisture) const {
+    return planned ? interpolate(&value[0], moisture) : 0.0f;
+}
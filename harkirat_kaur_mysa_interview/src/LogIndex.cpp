@@ -0,0 +1,370 @@
+#include "../include/LogIndex.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+const char kMagic[8] = {'M', 'Y', 'S', 'A', 'I', 'D', 'X', '\0'};
+const uint32_t kVersion = 1;
+const uint32_t kAscendingFlag = 1;
+const int64_t kLogEpoch = 1751328000; // 2025-07-01 00:00:00 UTC, time 0 of CsvLogSink timestamps
+// The log rounds to one decimal, so a logged value can sit up to 0.05 past the unrounded summary
+const float kLoggedMargin = 0.06f;
+
+template <typename T>
+void writeRaw(std::ofstream& out, const T& value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+template <typename T>
+bool readRaw(std::ifstream& in, T& value) {
+    return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+
+// Parses exactly `digits` decimal digits
+bool parseDigits(const char* p, int digits, int& value) {
+    value = 0;
+    for (int i = 0; i < digits; ++i) {
+        if (p[i] < '0' || p[i] > '9') return false;
+        value = value * 10 + (p[i] - '0');
+    }
+    return true;
+}
+
+// Days since 1970-01-01 of a proleptic Gregorian date
+int64_t daysFromCivil(int64_t y, int m, int d) {
+    y -= m <= 2;
+    int64_t era = (y >= 0 ? y : y - 399) / 400;
+    int64_t yearOfEra = y - era * 400;
+    int64_t dayOfYear = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    int64_t dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    return era * 146097 + dayOfEra - 719468;
+}
+
+// A float field that must end exactly at `end` (the next comma)
+bool parseFloatField(const char* begin, const char* end, float& value) {
+    char* parsed = nullptr;
+    value = std::strtof(begin, &parsed);
+    return parsed == end && parsed != begin;
+}
+} // namespace
+
+LogIndexWriter::LogIndexWriter(const std::string& filename, uint32_t blockRows)
+    : filename(filename), blockRows(blockRows > 0 ? blockRows : 1) {
+    open = flush(); // An empty index, so a run that writes no rows still leaves a valid file
+}
+
+void LogIndexWriter::defineName(uint16_t id, const std::string& name) {
+    if (names.size() <= id) names.resize(id + 1);
+    names[id] = name;
+}
+
+void LogIndexWriter::add(const LogRecord& r, uint64_t offset, uint32_t length) {
+    if (current.rows == 0) {
+        current.offset = offset;
+        current.minTime = current.maxTime = r.time_s;
+        current.minMoisture = current.maxMoisture = r.soil_moisture;
+        current.minStress = current.maxStress = r.plant_stress;
+    } else {
+        current.minTime = std::min(current.minTime, r.time_s);
+        current.maxTime = std::max(current.maxTime, r.time_s);
+        current.minMoisture = std::min(current.minMoisture, r.soil_moisture);
+        current.maxMoisture = std::max(current.maxMoisture, r.soil_moisture);
+        current.minStress = std::min(current.minStress, r.plant_stress);
+        current.maxStress = std::max(current.maxStress, r.plant_stress);
+    }
+    current.length = offset + length - current.offset;
+    uint64_t bit = logIndexZoneBit(r.zone_id);
+    current.zones |= bit;
+    if (r.pump_on) current.pumpZones |= bit;
+    if (++current.rows == blockRows) {
+        if (!blocks.empty() && current.minTime < blocks.back().maxTime) ascending = false;
+        blocks.push_back(current);
+        current = LogIndexBlock();
+    }
+}
+
+bool LogIndexWriter::flush() {
+    std::ofstream out(filename, std::ios::binary | std::ios::trunc);
+    if (!out) return false;
+    bool partial = current.rows > 0;
+    bool ordered = ascending && !(partial && !blocks.empty() && current.minTime < blocks.back().maxTime);
+    const LogIndexBlock* last = partial ? &current : (blocks.empty() ? nullptr : &blocks.back());
+    uint64_t coveredBytes = last ? last->offset + last->length : 0;
+    out.write(kMagic, sizeof(kMagic));
+    writeRaw(out, kVersion);
+    writeRaw(out, blockRows);
+    writeRaw(out, ordered ? kAscendingFlag : uint32_t(0));
+    writeRaw(out, coveredBytes);
+    writeRaw(out, static_cast<uint32_t>(names.size()));
+    writeRaw(out, static_cast<uint32_t>(blocks.size() + (partial ? 1 : 0)));
+    for (const std::string& name : names) {
+        uint16_t len = static_cast<uint16_t>(name.size() > 0xFFFF ? 0xFFFF : name.size());
+        writeRaw(out, len);
+        out.write(name.data(), len);
+    }
+    for (size_t i = 0; i < blocks.size() + (partial ? 1 : 0); ++i) {
+        const LogIndexBlock& b = i < blocks.size() ? blocks[i] : current;
+        writeRaw(out, b.offset);
+        writeRaw(out, b.length);
+        writeRaw(out, b.rows);
+        writeRaw(out, b.minTime);
+        writeRaw(out, b.maxTime);
+        writeRaw(out, b.minMoisture);
+        writeRaw(out, b.maxMoisture);
+        writeRaw(out, b.minStress);
+        writeRaw(out, b.maxStress);
+        writeRaw(out, b.zones);
+        writeRaw(out, b.pumpZones);
+    }
+    return static_cast<bool>(out.flush());
+}
+
+bool LogIndex::load(const std::string& filename, std::string& error) {
+    names.clear();
+    blocks.clear();
+    std::ifstream in(filename, std::ios::binary);
+    if (!in) {
+        error = "cannot open " + filename;
+        return false;
+    }
+    char magic[8];
+    uint32_t version = 0, blockRows = 0, flags = 0, nameCount = 0, blockCount = 0;
+    if (!in.read(magic, sizeof(magic)) || std::memcmp(magic, kMagic, sizeof(kMagic)) != 0 ||
+        !readRaw(in, version) || version != kVersion) {
+        error = filename + " is not a log index (.idx)";
+        return false;
+    }
+    if (!readRaw(in, blockRows) || !readRaw(in, flags) || !readRaw(in, coveredBytes) || !readRaw(in, nameCount) ||
+        !readRaw(in, blockCount)) {
+        error = filename + " is truncated";
+        return false;
+    }
+    ascending = (flags & kAscendingFlag) != 0;
+    for (uint32_t i = 0; i < nameCount; ++i) {
+        uint16_t len = 0;
+        std::string name;
+        if (readRaw(in, len)) {
+            name.resize(len);
+            if (len > 0) in.read(&name[0], len);
+        }
+        if (!in) {
+            error = filename + " is truncated";
+            return false;
+        }
+        names.push_back(name);
+    }
+    uint64_t expectedOffset = 0;
+    for (uint32_t i = 0; i < blockCount; ++i) {
+        LogIndexBlock b;
+        if (!readRaw(in, b.offset) || !readRaw(in, b.length) || !readRaw(in, b.rows) || !readRaw(in, b.minTime) ||
+            !readRaw(in, b.maxTime) || !readRaw(in, b.minMoisture) || !readRaw(in, b.maxMoisture) ||
+            !readRaw(in, b.minStress) || !readRaw(in, b.maxStress) || !readRaw(in, b.zones) ||
+            !readRaw(in, b.pumpZones)) {
+            error = filename + " is truncated";
+            return false;
+        }
+        // Blocks tile the rows of the log back to back
+        if (b.rows == 0 || b.length == 0 || (i > 0 && b.offset != expectedOffset)) {
+            error = filename + " has inconsistent blocks";
+            return false;
+        }
+        expectedOffset = b.offset + b.length;
+        blocks.push_back(b);
+    }
+    if (expectedOffset != coveredBytes) {
+        error = filename + " has inconsistent blocks";
+        return false;
+    }
+    return true;
+}
+
+uint64_t LogIndex::zoneMask(const std::string& zone) const {
+    for (size_t id = 0; id < names.size(); ++id) {
+        if (names[id] == zone) return logIndexZoneBit(static_cast<uint16_t>(id));
+    }
+    return 0;
+}
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+bool MappedFile::open(const std::string& filename, std::string& error) {
+    close();
+#ifdef _WIN32
+    HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        error = "cannot open " + filename;
+        return false;
+    }
+    LARGE_INTEGER fileSize;
+    GetFileSizeEx(file, &fileSize);
+    HANDLE mapping = fileSize.QuadPart > 0 ? CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr) : nullptr;
+    const void* mapped = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (!mapped) {
+        if (mapping) CloseHandle(mapping);
+        CloseHandle(file);
+        error = "cannot map " + filename;
+        return false;
+    }
+    fileHandle = file;
+    mappingHandle = mapping;
+    length = static_cast<size_t>(fileSize.QuadPart);
+#else
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        error = "cannot open " + filename;
+        return false;
+    }
+    struct stat st;
+    void* mapped = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && st.st_size > 0) {
+        mapped = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    }
+    ::close(fd); // The mapping stays valid without the descriptor
+    if (mapped == MAP_FAILED) {
+        error = "cannot map " + filename;
+        return false;
+    }
+    length = static_cast<size_t>(st.st_size);
+#endif
+    view = static_cast<const char*>(mapped);
+    return true;
+}
+
+void MappedFile::close() {
+    if (view) {
+#ifdef _WIN32
+        UnmapViewOfFile(view);
+        CloseHandle(static_cast<HANDLE>(mappingHandle));
+        CloseHandle(static_cast<HANDLE>(fileHandle));
+        mappingHandle = nullptr;
+        fileHandle = nullptr;
+#else
+        munmap(const_cast<char*>(view), length);
+#endif
+    }
+    view = nullptr;
+    length = 0;
+}
+
+bool parseLogRow(const char* line, const char* end, LogRow& row) {
+    // Start of each column up to SoilType; the columns after it are not needed
+    const char* fields[13];
+    fields[0] = line;
+    for (int n = 1; n < 13; ++n) {
+        const char* comma = static_cast<const char*>(std::memchr(fields[n - 1], ',', end - fields[n - 1]));
+        if (!comma) return false;
+        fields[n] = comma + 1;
+    }
+    // Timestamp: "YYYY-MM-DD HH:MM:SS"
+    int year, month, day, hour, minute, second;
+    if (fields[1] - 1 - line != 19 || !parseDigits(line, 4, year) || !parseDigits(line + 5, 2, month) ||
+        !parseDigits(line + 8, 2, day) || !parseDigits(line + 11, 2, hour) || !parseDigits(line + 14, 2, minute) ||
+        !parseDigits(line + 17, 2, second) || month < 1 || month > 12) {
+        return false;
+    }
+    row.time = daysFromCivil(year, month, day) * 86400 + hour * 3600 + minute * 60 + second - kLogEpoch;
+    if (!parseFloatField(fields[1], fields[2] - 1, row.moisture) ||
+        !parseFloatField(fields[9], fields[10] - 1, row.stress)) {
+        return false;
+    }
+    size_t pumpLength = fields[7] - 1 - fields[6];
+    if (pumpLength == 2 && std::memcmp(fields[6], "ON", 2) == 0) {
+        row.pumpOn = true;
+    } else if (pumpLength == 3 && std::memcmp(fields[6], "OFF", 3) == 0) {
+        row.pumpOn = false;
+    } else {
+        return false;
+    }
+    row.zone = fields[11];
+    row.zoneLength = fields[12] - 1 - fields[11];
+    return true;
+}
+
+bool rowMatches(const LogRow& row, const LogQuery& q) {
+    if (row.time < q.from || row.time >= q.to) return false;
+    if (!q.zone.empty() && (row.zoneLength != q.zone.size() || std::memcmp(row.zone, q.zone.data(), row.zoneLength) != 0)) {
+        return false;
+    }
+    if (q.pump >= 0 && row.pumpOn != (q.pump == 1)) return false;
+    return row.moisture > q.moistureAbove && row.moisture < q.moistureBelow && row.stress > q.stressAbove &&
+           row.stress < q.stressBelow;
+}
+
+bool blockMayMatch(const LogIndexBlock& b, const LogQuery& q, uint64_t zoneMask) {
+    if (b.maxTime < q.from || b.minTime >= q.to) return false;
+    uint64_t zones = q.zone.empty() ? ~uint64_t(0) : zoneMask;
+    if ((b.zones & zones) == 0) return false;
+    // Only "pump on" can be ruled out: the summary does not say whether a zone was ever off
+    if (q.pump == 1 && (b.pumpZones & zones) == 0) return false;
+    return b.maxMoisture + kLoggedMargin > q.moistureAbove && b.minMoisture - kLoggedMargin < q.moistureBelow &&
+           b.maxStress + kLoggedMargin > q.stressAbove && b.minStress - kLoggedMargin < q.stressBelow;
+}
+
+bool queryLog(const char* data, size_t size, const LogIndex* index, const LogQuery& query,
+              const std::function<void(const LogRow& row, const char* line, size_t length)>& visit,
+              LogQueryStats& stats, std::string& error) {
+    stats = LogQueryStats();
+    const char* headerEnd = size > 0 ? static_cast<const char*>(std::memchr(data, '\n', size)) : nullptr;
+    if (!headerEnd) {
+        error = "the log has no header line";
+        return false;
+    }
+    auto scan = [&](uint64_t begin, uint64_t end) {
+        const char* p = data + begin;
+        const char* stop = data + end;
+        while (p < stop) {
+            const char* newline = static_cast<const char*>(std::memchr(p, '\n', stop - p));
+            const char* lineEnd = newline ? newline : stop;
+            LogRow row;
+            ++stats.rowsScanned;
+            if (!parseLogRow(p, lineEnd, row)) {
+                ++stats.malformedRows;
+            } else if (rowMatches(row, query)) {
+                ++stats.rowsMatched;
+                visit(row, p, lineEnd - p);
+            }
+            p = lineEnd + 1;
+        }
+        stats.bytesScanned += end - begin;
+    };
+    uint64_t tail = headerEnd + 1 - data;
+    if (index) {
+        const std::vector<LogIndexBlock>& blocks = index->getBlocks();
+        if (index->getCoveredBytes() > size || (!blocks.empty() && blocks.front().offset != tail) ||
+            (!blocks.empty() && data[index->getCoveredBytes() - 1] != '\n')) {
+            error = "the index does not describe this log";
+            return false;
+        }
+        stats.blocks = blocks.size();
+        uint64_t zoneMask = query.zone.empty() ? ~uint64_t(0) : index->zoneMask(query.zone);
+        size_t first = 0;
+        if (index->isAscending()) {
+            // Block end times ascend, so the first block that can reach `from` is found by bisection
+            first = std::lower_bound(blocks.begin(), blocks.end(), query.from,
+                                     [](const LogIndexBlock& b, int64_t from) { return b.maxTime < from; }) -
+                    blocks.begin();
+        }
+        for (size_t i = first; i < blocks.size(); ++i) {
+            const LogIndexBlock& b = blocks[i];
+            if (index->isAscending() && b.minTime >= query.to) break;
+            if (!blockMayMatch(b, query, zoneMask)) continue;
+            ++stats.blocksScanned;
+            scan(b.offset, b.offset + b.length);
+        }
+        if (!blocks.empty()) tail = index->getCoveredBytes();
+    }
+    if (tail < size) scan(tail, size); // Rows written after the index
+    return true;
+}
@@ -0,0 +1,85 @@
+#include "../include/LogSink.h"
+#include "../include/LogIndex.h"
+#include "../include/Profiler.h"
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+
+CsvLogSink::CsvLogSink(const std::string& filename) : file(filename), out(&file) {
+    *out << header() << '\n';
+    bytesWritten = std::strlen(header()) + 1;
+}
+
+CsvLogSink::CsvLogSink(std::ostream& stream) : out(&stream) {
+    *out << header() << '\n';
+    bytesWritten = std::strlen(header()) + 1;
+}
+
+CsvLogSink::~CsvLogSink() {}
+
+bool CsvLogSink::enableIndex(const std::string& filename, uint32_t blockRows) {
+    index.reset(new LogIndexWriter(filename, blockRows));
+    if (!index->isOpen()) {
+        index.reset();
+        return false;
+    }
+    for (size_t id = 0; id < names.size(); ++id) index->defineName(static_cast<uint16_t>(id), names[id]);
+    return true;
+}
+
+const char* CsvLogSink::header() {
+    return "Timestamp,SoilMoisture (%),EffectiveMoisture (%),Temperature (°C),Humidity (%),Rainfall (mm),PumpState,FlowRate (L/min),WaterUsed (L),PlantStress (%),SensorError,ZoneID,SoilType,PowerUsed (Wh)";
+}
+
+void CsvLogSink::defineName(uint16_t id, const std::string& name) {
+    if (names.size() <= id) names.resize(id + 1);
+    names[id] = name;
+    if (index) index->defineName(id, name);
+}
+
+int CsvLogSink::formatRow(const LogRecord& r, char* buf, size_t size) {
+    // Timestamp: start at 2025-07-01 00:00:00 UTC. The date part only changes once a day,
+    // so gmtime/strftime run once per simulated day instead of once per row.
+    const int64_t base = 1751328000; // 2025-07-01 00:00:00 UTC
+    int64_t t = base + r.time_s;
+    int64_t day = t / 86400;
+    if (day != cachedDay) {
+        std::time_t dayStart = static_cast<std::time_t>(day * 86400);
+        std::strftime(datePrefix, sizeof(datePrefix), "%Y-%m-%d ", std::gmtime(&dayStart));
+        cachedDay = day;
+    }
+    int secOfDay = static_cast<int>(t - day * 86400);
+    static const std::string unknown;
+    const std::string& zone = r.zone_id < names.size() ? names[r.zone_id] : unknown;
+    const std::string& soil = r.soil_type < names.size() ? names[r.soil_type] : unknown;
+    return std::snprintf(buf, size,
+        "%s%02d:%02d:%02d,%.1f,%.1f,%.1f,%.1f,%.1f,%s,%.1f,%.1f,%.1f,%s,%s,%s,%.2f\n",
+        datePrefix, secOfDay / 3600, (secOfDay / 60) % 60, secOfDay % 60,
+        r.soil_moisture, r.effective_moisture, r.temp, r.humidity, r.rain,
+        r.pump_on ? "ON" : "OFF",
+        r.flow_rate, r.water_used, r.plant_stress,
+        r.sensor_error ? "TRUE" : "FALSE",
+        zone.c_str(), soil.c_str(),
+        r.power_used);
+}
+
+void CsvLogSink::write(const LogRecord& r) {
+    char buf[256];
+    int len;
+    {
+        ProfileScope profile(ProfileSection::LogFormat);
+        len = formatRow(r, buf, sizeof(buf));
+    }
+    if (len < 0) return;
+    if (len >= static_cast<int>(sizeof(buf))) len = sizeof(buf) - 1;
+    ProfileScope profile(ProfileSection::LogWrite);
+    out->write(buf, len);
+    if (index) index->add(r, bytesWritten, static_cast<uint32_t>(len));
+    bytesWritten += len;
+}
+
+void CsvLogSink::flush() {
+    ProfileScope profile(ProfileSection::LogWrite);
+    out->flush();
+    if (index) index->flush();
+}
@@ -1,14 +1,47 @@
 #include "../include/Logger.h"
-#include <iomanip>
-#include <ctime> // Required for std::time_t and std::tm
+#include "../include/BinaryLog.h"
 
-Logger::Logger(const std::string& filename) {
-    file.open(filename);
-    file << "Timestamp,SoilMoisture (%),EffectiveMoisture (%),Temperature (°C),Humidity (%),Rainfall (mm),PumpState,FlowRate (L/min),WaterUsed (L),PlantStress (%),SensorError,ZoneID,SoilType,PowerUsed (Wh)\n";
+std::unique_ptr<LogSink> makeFileLogSink(const std::string& filename, LogFormat format) {
+    if (format == LogFormat::None) {
+        return std::unique_ptr<LogSink>();
+    }
+    if (format == LogFormat::Binary) {
+        return std::unique_ptr<LogSink>(new BinaryLogSink(filename));
+    }
+    return std::unique_ptr<LogSink>(new CsvLogSink(filename));
 }
 
+Logger::Logger(const std::string& filename, LogFormat format) : sink(makeFileLogSink(filename, format)) {}
+
+Logger::Logger(std::unique_ptr<LogSink> sink) : sink(std::move(sink)) {}
+
 Logger::~Logger() {
-    if (file.is_open()) file.close();
+    if (sink) sink->flush();
+    if (rollups) rollups->flush();
+}
+
+bool Logger::enableRollups(const std::string& filename) {
+    rollups.reset(new RollupWriter(filename));
+    if (!rollups->isOpen()) {
+        rollups.reset();
+        return false;
+    }
+    for (size_t id = 0; id < names.size(); ++id) rollups->defineName(static_cast<uint16_t>(id), names[id]);
+    return true;
+}
+
+uint16_t Logger::internName(const std::string& name, std::string& lastName, uint16_t& lastId) {
+    if (!lastName.empty() && name == lastName) return lastId;
+    size_t id = 0;
+    while (id < names.size() && names[id] != name) ++id;
+    if (id == names.size()) {
+        names.push_back(name);
+        if (sink) sink->defineName(static_cast<uint16_t>(id), name);
+        if (rollups) rollups->defineName(static_cast<uint16_t>(id), name);
+    }
+    lastName = name;
+    lastId = static_cast<uint16_t>(id);
+    return lastId;
 }
 
 void Logger::logSecond(
@@ -27,39 +60,55 @@ void Logger::logSecond(
     const std::string& soil_type,
     float power_used
 ) {
-    // Timestamp: start at 2025-07-01 00:00:00
-    std::time_t base = 1751328000; // 2025-07-01 00:00:00 UTC
-    std::time_t t = base + time_s;
-    std::tm* tm_ptr = std::gmtime(&t);
-    char buf[20];
-    std::strftime(buf, sizeof(buf), "%Y-%m-%d %H:%M:%S", tm_ptr);
-    file << buf << ','
-         << std::fixed << std::setprecision(1)
-         << soil_moisture << ','
-         << effective_moisture << ','
-         << temp << ','
-         << humidity << ','
-         << rain << ','
-         << (pump_on ? "ON" : "OFF") << ','
-         << flow_rate << ','
-         << water_used << ','
-         << plant_stress << ','
-         << (sensor_error ? "TRUE" : "FALSE") << ','
-         << zone_id << ','
-         << soil_type << ','
-         << std::fixed << std::setprecision(2) // Set higher precision for power_used
-         << power_used << '\n';
+    if (sink) {
+        LogRecord r;
+        r.time_s = time_s;
+        r.soil_moisture = soil_moisture;
+        r.effective_moisture = effective_moisture;
+        r.temp = temp;
+        r.humidity = humidity;
+        r.rain = rain;
+        r.flow_rate = flow_rate;
+        r.water_used = water_used;
+        r.plant_stress = plant_stress;
+        r.power_used = power_used;
+        r.zone_id = internName(zone_id, lastZone, lastZoneId);
+        r.soil_type = internName(soil_type, lastSoil, lastSoilId);
+        r.pump_on = pump_on;
+        r.sensor_error = sensor_error;
+        sink->write(r);
+    }
+    if (rollups) {
+        rollups->add(internName(zone_id, lastZone, lastZoneId), time_s, soil_moisture, pump_on, water_used,
+                     power_used, plant_stress, sensor_error);
+    }
     total_water_used += water_used;
     total_power_used += power_used;
     total_plant_stress += plant_stress;
     ++log_count;
     if (sensor_error) ++sensor_failure_events;
     if (plant_stress < 10.0f) ++healthy_time;
-    file.flush();
+}
+
+void Logger::logSpan(int ticks, float water_used, float power_used, double plant_stress_sum,
+                     int healthy_ticks, int sensor_error_ticks, int first_time, float moisture_first,
+                     float moisture_last, double moisture_sum, float stress_min, float stress_max, bool pump_on,
+                     const std::string& zone_id) {
+    if (rollups && ticks > 0) {
+        rollups->addSpan(internName(zone_id, lastZone, lastZoneId), first_time, ticks, moisture_first, moisture_last,
+                         moisture_sum, pump_on, water_used, power_used, stress_min, stress_max, sensor_error_ticks);
+    }
+    total_water_used += water_used;
+    total_power_used += power_used;
+    total_plant_stress += static_cast<float>(plant_stress_sum);
+    log_count += ticks;
+    sensor_failure_events += sensor_error_ticks;
+    healthy_time += healthy_ticks;
 }
 
 void Logger::finalize() {
-    if (file.is_open()) file.flush();
+    if (sink) sink->flush();
+    if (rollups) rollups->flush();
 }
 
 float Logger::getTotalWaterUsed() const {
@@ -92,4 +141,24 @@ int Logger::getHealthyTime() const {
 }
 
 void Logger::setZoneID(const std::string& id) { zone_id = id; }
-void Logger::setSoilType(const std::string& type) { soil_type = type; } 
\ No newline at end of file
+void Logger::setSoilType(const std::string& type) { soil_type = type; } 
+
+void Logger::save(SnapshotWriter& out) const {
+    out.write(total_water_used);
+    out.write(total_power_used);
+    out.write(total_plant_stress);
+    out.write(total_effective_water);
+    out.write(log_count);
+    out.write(sensor_failure_events);
+    out.write(healthy_time);
+}
+
+void Logger::restore(SnapshotReader& in) {
+    in.read(total_water_used);
+    in.read(total_power_used);
+    in.read(total_plant_stress);
+    in.read(total_effective_water);
+    in.read(log_count);
+    in.read(sensor_failure_events);
+    in.read(healthy_time);
+}
@@ -0,0 +1,240 @@
+#include "../include/ParameterSweep.h"
+#include "../include/Checkpoint.h"
+#include "../include/Config.h"
+#include "../include/EventSimulation.h"
+#include "../include/GardenZone.h"
+#include "../include/Logger.h"
+#include "../include/CounterRng.h"
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+
+std::string trim(const std::string& s) {
+    size_t begin = s.find_first_not_of(" \t\r");
+    if (begin == std::string::npos) return "";
+    size_t end = s.find_last_not_of(" \t\r");
+    return s.substr(begin, end - begin + 1);
+}
+
+std::string formatValue(float value) {
+    std::ostringstream out;
+    out << value;
+    return out.str();
+}
+
+// Whole text as a number, like parseConfig; ranges are checked per value against the key's schema
+bool parseNumber(const std::string& text, float& value) {
+    char* end = nullptr;
+    value = std::strtof(text.c_str(), &end);
+    return !text.empty() && *end == '\0' && std::isfinite(value);
+}
+
+bool parseAxis(const std::string& key, const std::string& value, SweepAxis& axis, std::string& error) {
+    axis.key = key;
+    const ConfigField* field = findConfigField(key);
+    if (!field) {
+        error = "unknown config key '" + key + "'";
+        return false;
+    }
+    size_t colon = value.find(':');
+    if (!value.empty() && value[0] == '~') {
+        if (colon == std::string::npos) {
+            error = "random range must be ~min:max";
+            return false;
+        }
+        if (!field->floatField) {
+            error = "random range needs a decimal key, not '" + key + "'";
+            return false;
+        }
+        std::string min = trim(value.substr(1, colon - 1)), max = trim(value.substr(colon + 1));
+        if (!parseNumber(min, axis.min) || !parseNumber(max, axis.max) || axis.max < axis.min) {
+            error = "random range needs numbers min <= max";
+            return false;
+        }
+        axis.random = true;
+        // Every draw lies between the two ends, so checking them covers the whole range
+        SimulationParams probe;
+        return setSimulationParam(probe, key, min, error) && setSimulationParam(probe, key, max, error);
+    }
+    if (colon != std::string::npos) {
+        size_t colon2 = value.find(':', colon + 1);
+        if (colon2 == std::string::npos) {
+            error = "grid range must be start:stop:step";
+            return false;
+        }
+        float start, stop, step;
+        if (!parseNumber(trim(value.substr(0, colon)), start) ||
+            !parseNumber(trim(value.substr(colon + 1, colon2 - colon - 1)), stop) ||
+            !parseNumber(trim(value.substr(colon2 + 1)), step) || step <= 0.0f || stop < start) {
+            error = "grid range needs numbers start <= stop and step > 0";
+            return false;
+        }
+        // Index-based so float steps do not drift past stop
+        int count = static_cast<int>((stop - start) / step + 1e-4f) + 1;
+        for (int i = 0; i < count; ++i) axis.values.push_back(formatValue(start + i * step));
+    } else {
+        std::stringstream list(value);
+        std::string item;
+        while (std::getline(list, item, ',')) {
+            item = trim(item);
+            if (!item.empty()) axis.values.push_back(item);
+        }
+        if (axis.values.empty()) {
+            error = "no values for '" + key + "'";
+            return false;
+        }
+    }
+    // The same parse and range check as config.yaml, so expandSweep only ever sets valid values
+    SimulationParams probe;
+    for (const std::string& v : axis.values) {
+        if (!setSimulationParam(probe, key, v, error)) return false;
+    }
+    return true;
+}
+
+} // namespace
+
+bool parseSweepSpec(std::istream& in, SweepSpec& spec, std::string& error) {
+    std::string line;
+    int lineNumber = 0;
+    try {
+        while (std::getline(in, line)) {
+            ++lineNumber;
+            line = trim(line.substr(0, line.find('#')));
+            if (line.empty()) continue;
+            size_t eq = line.find('=');
+            if (eq == std::string::npos) {
+                error = "line " + std::to_string(lineNumber) + ": expected key=value";
+                return false;
+            }
+            std::string key = trim(line.substr(0, eq));
+            std::string value = trim(line.substr(eq + 1));
+            if (key == "samples") {
+                spec.samples = std::stoi(value);
+            } else if (key == "seeds") {
+                spec.seeds = std::stoi(value);
+            } else {
+                SweepAxis axis;
+                if (!parseAxis(key, value, axis, error)) {
+                    error = "line " + std::to_string(lineNumber) + ": " + error;
+                    return false;
+                }
+                spec.axes.push_back(axis);
+            }
+        }
+    } catch (const std::logic_error&) {
+        error = "line " + std::to_string(lineNumber) + ": invalid number";
+        return false;
+    }
+    if (spec.samples < 1 || spec.seeds < 1) {
+        error = "samples and seeds must be at least 1";
+        return false;
+    }
+    return true;
+}
+
+bool loadSweepSpec(const std::string& path, SweepSpec& spec, std::string& error) {
+    std::ifstream file(path);
+    if (!file) {
+        error = "cannot open " + path;
+        return false;
+    }
+    return parseSweepSpec(file, spec, error);
+}
+
+std::vector<SweepRun> expandSweep(const SweepSpec& spec, const SimulationParams& base) {
+    bool anyRandom = false;
+    size_t gridPoints = 1;
+    for (const SweepAxis& axis : spec.axes) {
+        if (axis.random) anyRandom = true;
+        else gridPoints *= axis.values.size();
+    }
+    int samples = anyRandom ? spec.samples : 1;
+    CounterRng rng(base.seed, 0, CounterRng::SweepStream);
+    std::vector<SweepRun> runs;
+    runs.reserve(gridPoints * samples * spec.seeds);
+    for (size_t point = 0; point < gridPoints; ++point) {
+        for (int sample = 0; sample < samples; ++sample) {
+            SweepRun variant;
+            variant.params = base;
+            uint64_t draw = point * samples + sample;
+            for (size_t a = 0; a < spec.axes.size(); ++a) {
+                const SweepAxis& axis = spec.axes[a];
+                std::string value;
+                if (axis.random) {
+                    float u = rng.draw(draw, static_cast<uint32_t>(a)) / 4294967296.0f;
+                    value = formatValue(axis.min + (axis.max - axis.min) * u);
+                } else {
+                    // Mixed-radix digit of the grid point; the first axis varies slowest
+                    size_t stride = 1;
+                    for (size_t b = a + 1; b < spec.axes.size(); ++b) {
+                        if (!spec.axes[b].random) stride *= spec.axes[b].values.size();
+                    }
+                    value = axis.values[(point / stride) % axis.values.size()];
+                }
+                std::string unused; // parseAxis already checked every value
+                setSimulationParam(variant.params, axis.key, value, unused);
+                variant.values.push_back(value);
+            }
+            for (int s = 0; s < spec.seeds; ++s) {
+                runs.push_back(variant);
+                runs.back().params.seed = base.seed + static_cast<uint64_t>(s);
+            }
+        }
+    }
+    return runs;
+}
+
+SweepResult runSweepSimulation(const SimulationParams& params, int durationSeconds, bool eventEngine, int maxPumps,
+                               const Checkpoint* start) {
+    Logger logger{std::unique_ptr<LogSink>()};
+    if (eventEngine) {
+        EventSimulation sim(params);
+        sim.run(durationSeconds, logger);
+    } else {
+        // Same per-step sequence as main.cpp's tick loop, with a budget private to this run
+        PumpBudget budget(maxPumps);
+        ZoneSimulation zone(params, 0, "Zone1", "Loam", &budget);
+        int steps = static_cast<int>(durationSeconds / params.simulationStep);
+        float secondsElapsed = 0.0f;
+        if (start) {
+            // What-if continuation: warm state from the checkpoint, this run's params from here on
+            restoreZone(*start, 0, zone);
+            budget.setActive(zone.isPumpOn() ? 1 : 0);
+            secondsElapsed = start->secondsElapsed;
+        }
+        for (int i = 0; i < steps; ++i) {
+            ZoneStepResult r = zone.step(secondsElapsed);
+            logger.logSecond(r.time_s, r.soilMoisture, r.effectiveMoisture, r.temperature, r.humidity, r.rainfall,
+                             r.pumpOn, params.pumpFlowRate, r.waterUsed, r.plantStress,
+                             r.weatherFailed || r.soilFailed, "Zone1", "Loam", r.powerUsed);
+            secondsElapsed += params.simulationStep;
+        }
+    }
+    SweepResult result;
+    result.waterUsed = logger.getTotalWaterUsed();
+    result.powerUsed = logger.getTotalPowerUsed();
+    result.dailyCost = logger.getAverageDailyCost(params.waterCost, durationSeconds);
+    result.averageStress = logger.getAveragePlantStress();
+    result.efficiency = logger.getWaterEfficiency();
+    result.sensorFailures = logger.getSensorFailureEvents();
+    return result;
+}
+
+void writeSweepResults(std::ostream& out, const SweepSpec& spec, const std::vector<SweepRun>& runs,
+                       const std::vector<SweepResult>& results) {
+    out << "Run,Seed";
+    for (const SweepAxis& axis : spec.axes) out << "," << axis.key;
+    out << ",WaterUsed (L),PowerUsed (Wh),AverageDailyCost ($),AveragePlantStress (%),WateringEfficiency (%),SensorFailureEvents\n";
+    for (size_t i = 0; i < runs.size() && i < results.size(); ++i) {
+        const SweepResult& r = results[i];
+        out << i << "," << runs[i].params.seed;
+        for (const std::string& value : runs[i].values) out << "," << value;
+        out << "," << r.waterUsed << "," << r.powerUsed << "," << r.dailyCost << "," << r.averageStress
+            << "," << r.efficiency << "," << r.sensorFailures << "\n";
+    }
+}
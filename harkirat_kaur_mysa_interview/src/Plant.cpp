@@ -15,4 +15,12 @@ void Plant::update(float availableWater) {
 }
 
 float Plant::getStress() const { return stress; }
-float Plant::getWaterNeed() const { return waterNeedPerDay; } 
\ No newline at end of file
+float Plant::getWaterNeed() const { return waterNeedPerDay; } 
+
+void Plant::save(SnapshotWriter& out) const {
+    out.write(stress);
+}
+
+void Plant::restore(SnapshotReader& in) {
+    in.read(stress);
+}
@@ -0,0 +1,223 @@
+#include "../include/Profiler.h"
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+
+namespace {
+typedef std::chrono::steady_clock Clock;
+
+// Log-linear buckets: exact below 16 ns, then 8 per power of two (at most 12.5% wide)
+const int kLinearBuckets = 16;
+const int kSubBuckets = 8;
+const int kBuckets = kLinearBuckets + (63 - 4) * kSubBuckets + kSubBuckets;
+const int kSections = static_cast<int>(ProfileSection::Count);
+
+int bucketOf(uint64_t ns) {
+    if (ns < kLinearBuckets) return static_cast<int>(ns);
+    int octave = 4;
+    while (octave < 63 && (ns >> (octave + 1)) != 0) ++octave;
+    return kLinearBuckets + (octave - 4) * kSubBuckets + static_cast<int>((ns >> (octave - 3)) & (kSubBuckets - 1));
+}
+
+// Largest value that falls in the bucket
+uint64_t bucketLimit(int bucket) {
+    if (bucket < kLinearBuckets) return static_cast<uint64_t>(bucket);
+    int octave = 4 + (bucket - kLinearBuckets) / kSubBuckets;
+    uint64_t sub = static_cast<uint64_t>((bucket - kLinearBuckets) % kSubBuckets);
+    return ((kSubBuckets + sub + 1) << (octave - 3)) - 1;
+}
+
+struct SectionHistogram {
+    uint64_t count;
+    uint64_t totalNs;
+    uint64_t maxNs;
+    uint64_t buckets[kBuckets];
+};
+
+struct TraceEvent {
+    int64_t startNs; // Since Profiler::enable()
+    uint32_t durationNs;
+    ProfileSection section;
+};
+
+// One thread's recordings; written only by that thread
+struct ThreadProfile {
+    uint32_t tid;
+    SectionHistogram sections[kSections];
+    std::vector<TraceEvent> events;
+    uint64_t dropped;
+    void clear() {
+        for (SectionHistogram& s : sections) s = SectionHistogram();
+        events.clear();
+        dropped = 0;
+    }
+};
+
+std::mutex registryMutex; // Guards the list itself; each ThreadProfile is lock-free for its thread
+std::vector<std::unique_ptr<ThreadProfile>> registry;
+Clock::time_point epoch;
+bool tracing = false;
+size_t traceCapacity = 0;
+uint64_t generation = 0; // Bumped by enable() so threads re-register into a cleared buffer
+
+thread_local ThreadProfile* local = nullptr;
+thread_local uint64_t localGeneration = 0;
+
+ThreadProfile& threadProfile() {
+    if (!local || localGeneration != generation) {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        if (!local) {
+            registry.emplace_back(new ThreadProfile());
+            local = registry.back().get();
+            local->tid = static_cast<uint32_t>(registry.size());
+        }
+        local->clear();
+        localGeneration = generation;
+    }
+    return *local;
+}
+} // namespace
+
+std::atomic<bool> Profiler::enabled{false};
+
+const char* profileSectionName(ProfileSection section) {
+    switch (section) {
+        case ProfileSection::ZoneStep: return "ZoneStep";
+        case ProfileSection::ControllerUpdate: return "ControllerUpdate";
+        case ProfileSection::ZoneUpdate: return "ZoneUpdate";
+        case ProfileSection::WeatherUpdate: return "WeatherUpdate";
+        case ProfileSection::Forecast: return "Forecast";
+        case ProfileSection::LogFormat: return "LogFormat";
+        case ProfileSection::LogWrite: return "LogWrite";
+        default: return "Unknown";
+    }
+}
+
+void Profiler::enable(bool trace, size_t maxTraceEventsPerThread) {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    for (const auto& profile : registry) profile->clear();
+    ++generation;
+    tracing = trace;
+    traceCapacity = maxTraceEventsPerThread;
+    epoch = Clock::now();
+    enabled.store(true, std::memory_order_relaxed);
+}
+
+void Profiler::disable() {
+    enabled.store(false, std::memory_order_relaxed);
+}
+
+void Profiler::record(ProfileSection section, Clock::time_point start, Clock::time_point end) {
+    ThreadProfile& profile = threadProfile();
+    uint64_t ns = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+    SectionHistogram& h = profile.sections[static_cast<int>(section)];
+    ++h.count;
+    h.totalNs += ns;
+    if (ns > h.maxNs) h.maxNs = ns;
+    ++h.buckets[bucketOf(ns)];
+    if (!tracing) return;
+    if (profile.events.size() >= traceCapacity) {
+        ++profile.dropped;
+        return;
+    }
+    TraceEvent event;
+    event.startNs = std::chrono::duration_cast<std::chrono::nanoseconds>(start - epoch).count();
+    event.durationNs = ns > 0xffffffffULL ? 0xffffffffU : static_cast<uint32_t>(ns);
+    event.section = section;
+    profile.events.push_back(event);
+}
+
+std::vector<ProfileStats> Profiler::report() {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    std::vector<ProfileStats> stats;
+    for (int s = 0; s < kSections; ++s) {
+        SectionHistogram merged = SectionHistogram();
+        for (const auto& profile : registry) {
+            const SectionHistogram& h = profile->sections[s];
+            merged.count += h.count;
+            merged.totalNs += h.totalNs;
+            if (h.maxNs > merged.maxNs) merged.maxNs = h.maxNs;
+            for (int b = 0; b < kBuckets; ++b) merged.buckets[b] += h.buckets[b];
+        }
+        if (merged.count == 0) continue;
+        ProfileStats st;
+        st.section = static_cast<ProfileSection>(s);
+        st.count = merged.count;
+        st.totalMs = merged.totalNs / 1e6;
+        st.maxUs = merged.maxNs / 1e3;
+        // Nearest-rank percentiles, reported as the bucket's upper edge (never above the true max)
+        const double quantiles[3] = {0.50, 0.90, 0.99};
+        double* outputs[3] = {&st.p50Us, &st.p90Us, &st.p99Us};
+        for (int q = 0; q < 3; ++q) {
+            uint64_t rank = static_cast<uint64_t>(quantiles[q] * merged.count + 0.999999);
+            if (rank < 1) rank = 1;
+            uint64_t seen = 0;
+            int b = 0;
+            while (b < kBuckets - 1 && seen + merged.buckets[b] < rank) seen += merged.buckets[b++];
+            uint64_t limit = bucketLimit(b);
+            *outputs[q] = (limit < merged.maxNs ? limit : merged.maxNs) / 1e3;
+        }
+        stats.push_back(st);
+    }
+    return stats;
+}
+
+uint64_t Profiler::getDroppedTraceEvents() {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    uint64_t dropped = 0;
+    for (const auto& profile : registry) dropped += profile->dropped;
+    return dropped;
+}
+
+void Profiler::printTable(std::ostream& out) {
+    std::vector<ProfileStats> stats = report();
+    std::ios::fmtflags flags = out.flags();
+    std::streamsize precision = out.precision();
+    out << std::left << std::setw(18) << "Section" << std::right << std::setw(12) << "Calls" << std::setw(12)
+        << "Total ms" << std::setw(10) << "p50 us" << std::setw(10) << "p90 us" << std::setw(10) << "p99 us"
+        << std::setw(10) << "max us" << "\n";
+    out << std::fixed;
+    for (const ProfileStats& s : stats) {
+        out << std::left << std::setw(18) << profileSectionName(s.section) << std::right << std::setw(12) << s.count
+            << std::setprecision(1) << std::setw(12) << s.totalMs << std::setprecision(3) << std::setw(10) << s.p50Us
+            << std::setw(10) << s.p90Us << std::setw(10) << s.p99Us << std::setprecision(1) << std::setw(10)
+            << s.maxUs << "\n";
+    }
+    if (stats.empty()) out << "(no sections recorded)\n";
+    out.flags(flags);
+    out.precision(precision);
+}
+
+bool Profiler::writeChromeTrace(const std::string& path, std::string& error) {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        error = "cannot open " + path;
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(registryMutex);
+    file << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+    char line[160];
+    bool first = true;
+    for (const auto& profile : registry) {
+        int len = std::snprintf(line, sizeof(line),
+            "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"thread %u\"}}",
+            first ? "" : ",\n", profile->tid, profile->tid);
+        file.write(line, len);
+        first = false;
+        for (const TraceEvent& e : profile->events) {
+            len = std::snprintf(line, sizeof(line),
+                ",\n{\"name\":\"%s\",\"cat\":\"mysa\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                profileSectionName(e.section), profile->tid, e.startNs / 1e3, e.durationNs / 1e3);
+            file.write(line, len);
+        }
+    }
+    file << "\n]}\n";
+    file.flush();
+    if (!file) {
+        error = "write failed for " + path;
+        return false;
+    }
+    return true;
+}
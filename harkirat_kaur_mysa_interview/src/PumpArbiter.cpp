@@ -0,0 +1,149 @@
+#include "../include/PumpArbiter.h"
+#include <cmath>
+
+const float PumpArbiter::kRekeyStep = 1.0f;
+
+PumpArbiter::PumpArbiter(size_t zoneCount, int maxActive)
+    : position(zoneCount, -1), key(zoneCount, 0.0f), wants(zoneCount, 0), postedUrgency(zoneCount, 0.0f),
+      dirty(zoneCount, 0), dirtyZones(zoneCount), granted(zoneCount, 0), waitingSince(zoneCount, -1),
+      lastWatered(zoneCount, 0), zoneGrants(zoneCount, 0), starved(zoneCount, 0),
+      maxActive(maxActive) {
+    heap.reserve(zoneCount);
+}
+
+void PumpArbiter::post(uint32_t zone, bool wantsPump, float urgency) {
+    if ((wants[zone] != 0) == wantsPump && std::fabs(urgency - postedUrgency[zone]) < kRekeyStep) return;
+    wants[zone] = wantsPump ? 1 : 0;
+    postedUrgency[zone] = urgency;
+    if (!dirty[zone]) {
+        dirty[zone] = 1;
+        dirtyZones[dirtyCount.fetch_add(1, std::memory_order_relaxed)] = zone;
+    }
+}
+
+void PumpArbiter::arbitrate(int secondsElapsed) {
+    size_t changed = dirtyCount.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < changed; ++i) {
+        uint32_t zone = dirtyZones[i];
+        dirty[zone] = 0;
+        apply(zone, secondsElapsed);
+    }
+    dirtyCount.store(0, std::memory_order_relaxed);
+    while (active < maxActive && !heap.empty()) {
+        uint32_t zone = popTop();
+        granted[zone] = 1;
+        ++active;
+        ++grants;
+        ++zoneGrants[zone];
+        int wait = secondsElapsed - waitingSince[zone];
+        totalWaitSeconds += wait;
+        if (wait > maxWaitSeconds) maxWaitSeconds = wait;
+        if (wait > starvationSeconds) starved[zone] = 1;
+        waitingSince[zone] = -1;
+    }
+}
+
+void PumpArbiter::apply(uint32_t zone, int secondsElapsed) {
+    if (wants[zone]) {
+        if (granted[zone]) return; // Keeps its permit while the pump runs
+        if (waitingSince[zone] < 0) waitingSince[zone] = secondsElapsed;
+        upsert(zone, postedUrgency[zone] - agingPerHour * lastWatered[zone] / 3600.0f);
+    } else if (granted[zone]) {
+        granted[zone] = 0;
+        --active;
+        lastWatered[zone] = secondsElapsed;
+    } else if (position[zone] >= 0) {
+        remove(zone); // Rain, a full soil or a pump limit ended the wish before a permit came
+        waitingSince[zone] = -1;
+    }
+}
+
+ArbiterStats PumpArbiter::getStats(int secondsElapsed) const {
+    ArbiterStats stats;
+    stats.grants = grants;
+    stats.heapUpdates = heapUpdates;
+    stats.meanWaitSeconds = grants > 0 ? totalWaitSeconds / grants : 0.0;
+    stats.maxWaitSeconds = maxWaitSeconds;
+    stats.waitingZones = heap.size();
+    double sum = 0.0, sumSquares = 0.0;
+    size_t counted = 0;
+    for (size_t z = 0; z < granted.size(); ++z) {
+        int waited = waitingSince[z] >= 0 ? secondsElapsed - waitingSince[z] : 0;
+        if (waited > stats.maxWaitSeconds) stats.maxWaitSeconds = waited;
+        if (starved[z] || waited > starvationSeconds) ++stats.starvedZones;
+        // Zones that stopped asking before a permit came were not passed over, so they do not count
+        if (zoneGrants[z] == 0 && waitingSince[z] < 0) continue;
+        ++counted;
+        sum += zoneGrants[z];
+        sumSquares += static_cast<double>(zoneGrants[z]) * zoneGrants[z];
+    }
+    if (sumSquares > 0.0) stats.fairness = sum * sum / (counted * sumSquares);
+    return stats;
+}
+
+// Ties go to the lower zone index, so grants do not depend on which thread posted first
+bool PumpArbiter::higher(uint32_t a, uint32_t b) const {
+    return key[a] > key[b] || (key[a] == key[b] && a < b);
+}
+
+void PumpArbiter::place(size_t i, uint32_t zone) {
+    heap[i] = zone;
+    position[zone] = static_cast<int32_t>(i);
+}
+
+void PumpArbiter::siftUp(size_t i) {
+    uint32_t zone = heap[i];
+    while (i > 0) {
+        size_t parent = (i - 1) / 2;
+        if (!higher(zone, heap[parent])) break;
+        place(i, heap[parent]);
+        i = parent;
+    }
+    place(i, zone);
+}
+
+void PumpArbiter::siftDown(size_t i) {
+    uint32_t zone = heap[i];
+    size_t n = heap.size();
+    for (;;) {
+        size_t child = 2 * i + 1;
+        if (child >= n) break;
+        if (child + 1 < n && higher(heap[child + 1], heap[child])) ++child;
+        if (!higher(heap[child], zone)) break;
+        place(i, heap[child]);
+        i = child;
+    }
+    place(i, zone);
+}
+
+void PumpArbiter::upsert(uint32_t zone, float newKey) {
+    ++heapUpdates;
+    if (position[zone] < 0) {
+        key[zone] = newKey;
+        heap.push_back(zone);
+        siftUp(heap.size() - 1);
+        return;
+    }
+    bool rises = newKey > key[zone];
+    key[zone] = newKey;
+    if (rises) siftUp(static_cast<size_t>(position[zone]));
+    else siftDown(static_cast<size_t>(position[zone]));
+}
+
+void PumpArbiter::remove(uint32_t zone) {
+    ++heapUpdates;
+    size_t i = static_cast<size_t>(position[zone]);
+    position[zone] = -1;
+    uint32_t last = heap.back();
+    heap.pop_back();
+    if (last == zone) return;
+    place(i, last);
+    siftUp(i);
+    siftDown(static_cast<size_t>(position[last]));
+}
+
+uint32_t PumpArbiter::popTop() {
+    uint32_t top = heap[0];
+    remove(top);
+    return top;
+}
@@ -0,0 +1,136 @@
+#include "../include/Rollup.h"
+#include <algorithm>
+#include <cstring>
+
+int StressSketch::binOf(float stress) {
+    int bin = static_cast<int>(stress * (kBins / 100.0f));
+    if (bin < 0) bin = 0;
+    if (bin >= kBins) bin = kBins - 1;
+    return bin;
+}
+
+void StressSketch::add(float stress, uint32_t weight) {
+    addRange(stress, stress, weight);
+}
+
+void StressSketch::addRange(float lo, float hi, uint32_t weight) {
+    if (weight == 0) return;
+    if (hi < lo) std::swap(lo, hi);
+    int first = binOf(lo), last = binOf(hi);
+    if (first == last) {
+        bins[first] += weight;
+    } else {
+        uint32_t count = static_cast<uint32_t>(last - first + 1);
+        for (int bin = first; bin <= last; ++bin) {
+            // The remainder goes to the lowest bins, one each
+            bins[bin] += weight / count + (static_cast<uint32_t>(bin - first) < weight % count ? 1 : 0);
+        }
+    }
+    if (total == 0 || lo < minValue) minValue = lo;
+    if (total == 0 || hi > maxValue) maxValue = hi;
+    total += weight;
+}
+
+float StressSketch::percentile(float p) const {
+    if (total == 0) return 0.0f;
+    uint64_t rank = static_cast<uint64_t>(p * (total - 1)); // Nearest-rank, 0-based
+    uint64_t seen = 0;
+    float value = maxValue;
+    for (int bin = 0; bin < kBins; ++bin) {
+        seen += bins[bin];
+        if (seen > rank) {
+            value = (bin + 0.5f) * (100.0f / kBins); // Bin midpoint
+            break;
+        }
+    }
+    return value < minValue ? minValue : value > maxValue ? maxValue : value;
+}
+
+void StressSketch::clear() {
+    std::memset(bins, 0, sizeof(bins));
+    total = 0;
+    minValue = 0.0f;
+    maxValue = 0.0f;
+}
+
+RollupWriter::RollupWriter(const std::string& filename) : file(filename) {
+    file << "Period,StartTime (s),ZoneID,Ticks,MinMoisture (%),MaxMoisture (%),MeanMoisture (%),PumpDuty (%),"
+            "WaterUsed (L),PowerUsed (Wh),StressP50 (%),StressP90 (%),StressP99 (%),SensorErrorTicks\n";
+}
+
+RollupWriter::~RollupWriter() {
+    flush();
+}
+
+void RollupWriter::defineName(uint16_t id, const std::string& name) {
+    if (names.size() <= id) names.resize(id + 1);
+    names[id] = name;
+}
+
+RollupWriter::ZoneRollup& RollupWriter::zoneState(uint16_t zone) {
+    if (zones.size() <= zone) zones.resize(zone + 1);
+    return zones[zone];
+}
+
+void RollupWriter::add(uint16_t zone, int time_s, float soil_moisture, bool pump_on, float water_used,
+                       float power_used, float plant_stress, bool sensor_error) {
+    ZoneRollup& z = zoneState(zone);
+    accumulate(z.hour, time_s / 3600, 1, soil_moisture, soil_moisture, soil_moisture, pump_on ? 1 : 0,
+               water_used, power_used, plant_stress, plant_stress, sensor_error ? 1 : 0, zone, "hour", 3600);
+    accumulate(z.day, time_s / 86400, 1, soil_moisture, soil_moisture, soil_moisture, pump_on ? 1 : 0,
+               water_used, power_used, plant_stress, plant_stress, sensor_error ? 1 : 0, zone, "day", 86400);
+}
+
+void RollupWriter::addSpan(uint16_t zone, int first_time, int ticks, float moisture_first, float moisture_last,
+                           double moisture_sum, bool pump_on, float water_used, float power_used, float stress_min,
+                           float stress_max, int sensor_error_ticks) {
+    if (ticks <= 0) return;
+    ZoneRollup& z = zoneState(zone);
+    float lo = moisture_first < moisture_last ? moisture_first : moisture_last;
+    float hi = moisture_first < moisture_last ? moisture_last : moisture_first;
+    int64_t on = pump_on ? ticks : 0;
+    accumulate(z.hour, first_time / 3600, ticks, lo, hi, moisture_sum, on, water_used, power_used, stress_min,
+               stress_max, sensor_error_ticks, zone, "hour", 3600);
+    accumulate(z.day, first_time / 86400, ticks, lo, hi, moisture_sum, on, water_used, power_used, stress_min,
+               stress_max, sensor_error_ticks, zone, "day", 86400);
+}
+
+void RollupWriter::accumulate(RollupBucket& b, int64_t period, int64_t ticks, float minMoisture, float maxMoisture,
+                              double moistureSum, int64_t pumpOnTicks, float water, float power, float stressMin,
+                              float stressMax, int64_t sensorErrorTicks, uint16_t zone, const char* label, int64_t seconds) {
+    if (b.period != period) {
+        if (b.period >= 0) writeBucket(b, zone, label, seconds);
+        b.period = period;
+        b.minMoisture = minMoisture;
+        b.maxMoisture = maxMoisture;
+    }
+    if (minMoisture < b.minMoisture) b.minMoisture = minMoisture;
+    if (maxMoisture > b.maxMoisture) b.maxMoisture = maxMoisture;
+    b.ticks += ticks;
+    b.moistureSum += moistureSum;
+    b.pumpOnTicks += pumpOnTicks;
+    b.water += water;
+    b.power += power;
+    b.sensorErrorTicks += sensorErrorTicks;
+    b.stress.addRange(stressMin, stressMax, static_cast<uint32_t>(ticks));
+}
+
+void RollupWriter::writeBucket(RollupBucket& b, uint16_t zone, const char* label, int64_t seconds) {
+    if (b.ticks > 0 && file) {
+        file << label << "," << b.period * seconds << "," << (zone < names.size() ? names[zone] : std::to_string(zone))
+             << "," << b.ticks << "," << b.minMoisture << "," << b.maxMoisture << "," << b.moistureSum / b.ticks
+             << "," << 100.0 * b.pumpOnTicks / b.ticks << "," << b.water << "," << b.power << ","
+             << b.stress.percentile(0.5f) << "," << b.stress.percentile(0.9f) << "," << b.stress.percentile(0.99f)
+             << "," << b.sensorErrorTicks << "\n";
+        ++rowsWritten;
+    }
+    b = RollupBucket();
+}
+
+void RollupWriter::flush() {
+    for (size_t z = 0; z < zones.size(); ++z) {
+        writeBucket(zones[z].hour, static_cast<uint16_t>(z), "hour", 3600);
+        writeBucket(zones[z].day, static_cast<uint16_t>(z), "day", 86400);
+    }
+    file.flush();
+}
@@ -0,0 +1,479 @@
+#include "../include/SensorIngest.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+#ifdef __linux__
+#include <cerrno>
+#include <netdb.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+const unsigned char kBinaryMagic = 0xFE;
+const size_t kMaxReadingsPerDatagram = 128; // More than a full datagram of the shortest valid records
+
+bool sameWord(const char* begin, const char* end, const char* word) {
+    size_t length = std::strlen(word);
+    return static_cast<size_t>(end - begin) == length && std::memcmp(begin, word, length) == 0;
+}
+
+// Parses [begin, end) as a whole number; strtof needs a terminated copy, which stays on the stack
+bool parseNumber(const char* begin, const char* end, float& value) {
+    char text[32];
+    size_t length = static_cast<size_t>(end - begin);
+    if (length == 0 || length >= sizeof(text)) return false;
+    std::memcpy(text, begin, length);
+    text[length] = '\0';
+    char* stop = nullptr;
+    value = std::strtof(text, &stop);
+    return stop == text + length;
+}
+
+// "weather,zone=3 temperature=21.5,humidity=60,rainfall=0" (see SensorIngest.h)
+bool parseLine(const char* p, const char* end, SensorReading& r) {
+    const char* comma = static_cast<const char*>(std::memchr(p, ',', end - p));
+    if (!comma) return false;
+    if (sameWord(p, comma, "weather")) r.kind = SensorKind::Weather;
+    else if (sameWord(p, comma, "soil")) r.kind = SensorKind::Soil;
+    else return false;
+    const char* tags = comma + 1;
+    const char* space = static_cast<const char*>(std::memchr(tags, ' ', end - tags));
+    if (!space || end - tags < 6 || std::memcmp(tags, "zone=", 5) != 0) return false;
+    char* stop = nullptr;
+    char zone[12];
+    size_t zoneLength = static_cast<size_t>(space - tags - 5);
+    if (zoneLength == 0 || zoneLength >= sizeof(zone)) return false;
+    std::memcpy(zone, tags + 5, zoneLength);
+    zone[zoneLength] = '\0';
+    unsigned long index = std::strtoul(zone, &stop, 10);
+    if (stop != zone + zoneLength || zone[0] == '-' || index > 0xFFFFFFFFUL) return false;
+    r.zone = static_cast<uint32_t>(index);
+    // Fields end at the next space (an optional timestamp follows) or the end of the line
+    const char* fieldsEnd = static_cast<const char*>(std::memchr(space + 1, ' ', end - space - 1));
+    if (!fieldsEnd) fieldsEnd = end;
+    static const char* const kWeatherFields[] = {"temperature", "humidity", "rainfall"};
+    int expected = r.kind == SensorKind::Weather ? 3 : 1;
+    int seen = 0;
+    for (const char* field = space + 1; field < fieldsEnd;) {
+        const char* next = static_cast<const char*>(std::memchr(field, ',', fieldsEnd - field));
+        if (!next) next = fieldsEnd;
+        const char* equals = static_cast<const char*>(std::memchr(field, '=', next - field));
+        if (!equals) return false;
+        float value = 0.0f;
+        if (!parseNumber(equals + 1, next, value)) return false;
+        if (sameWord(field, equals, "failed")) {
+            r.failed = value != 0.0f;
+        } else if (r.kind == SensorKind::Soil && sameWord(field, equals, "moisture")) {
+            r.values[0] = value;
+            seen |= 1;
+        } else if (r.kind == SensorKind::Weather) {
+            int i = 0;
+            while (i < 3 && !sameWord(field, equals, kWeatherFields[i])) ++i;
+            if (i == 3) return false;
+            r.values[i] = value;
+            seen |= 1 << i;
+        } else {
+            return false;
+        }
+        field = next + 1;
+    }
+    return r.failed || seen == (1 << expected) - 1;
+}
+
+bool parseBinary(const unsigned char* p, SensorReading& r) {
+    if (p[0] != kBinaryMagic || (p[1] != 1 && p[1] != 2)) return false;
+    r.kind = static_cast<SensorKind>(p[1]);
+    r.failed = (p[2] & 1) != 0;
+    std::memcpy(&r.zone, p + 4, sizeof(uint32_t));
+    std::memcpy(r.values, p + 8, sizeof(r.values));
+    return true;
+}
+
+#ifdef __linux__
+// "udp:<host>:<port>" or "unix:<path>"
+bool splitEndpoint(const std::string& endpoint, std::string& host, std::string& port, std::string& path, std::string& error) {
+    if (endpoint.compare(0, 5, "unix:") == 0) {
+        path = endpoint.substr(5);
+        if (path.empty() || path.size() >= sizeof(sockaddr_un().sun_path)) {
+            error = "invalid UNIX socket path in " + endpoint;
+            return false;
+        }
+        return true;
+    }
+    size_t colon = endpoint.find_last_of(':');
+    if (endpoint.compare(0, 4, "udp:") != 0 || colon < 4 || colon + 1 >= endpoint.size()) {
+        error = "invalid endpoint " + endpoint + " (expected udp:<host>:<port> or unix:<path>)";
+        return false;
+    }
+    host = endpoint.substr(4, colon - 4);
+    port = endpoint.substr(colon + 1);
+    return true;
+}
+
+sockaddr_un unixAddress(const std::string& path) {
+    sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    std::memcpy(address.sun_path, path.c_str(), path.size());
+    return address;
+}
+
+// Opens a datagram socket bound (server) or connected (client) to a UDP endpoint
+int openUdp(const std::string& host, const std::string& port, bool bindIt, int flags, std::string& error) {
+    addrinfo hints;
+    std::memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_DGRAM;
+    hints.ai_flags = AI_NUMERICSERV | (bindIt ? AI_PASSIVE : 0);
+    addrinfo* found = nullptr;
+    int status = getaddrinfo(host.empty() ? nullptr : host.c_str(), port.c_str(), &hints, &found);
+    if (status != 0) {
+        error = "cannot resolve " + host + ":" + port + ": " + gai_strerror(status);
+        return -1;
+    }
+    int fd = -1;
+    for (addrinfo* a = found; a && fd < 0; a = a->ai_next) {
+        fd = socket(a->ai_family, a->ai_socktype | flags, a->ai_protocol);
+        if (fd < 0) continue;
+        if ((bindIt ? bind(fd, a->ai_addr, a->ai_addrlen) : connect(fd, a->ai_addr, a->ai_addrlen)) != 0) {
+            error = std::string(bindIt ? "cannot bind " : "cannot connect to ") + host + ":" + port + ": " + std::strerror(errno);
+            ::close(fd);
+            fd = -1;
+        }
+    }
+    freeaddrinfo(found);
+    return fd;
+}
+#endif
+
+} // namespace
+
+size_t decodeSensorDatagram(const char* data, size_t size, SensorReading* out, size_t capacity, size_t& malformed) {
+    size_t count = 0;
+    if (size > 0 && static_cast<unsigned char>(data[0]) == kBinaryMagic) {
+        const unsigned char* p = reinterpret_cast<const unsigned char*>(data);
+        size_t records = size / kBinaryRecordSize;
+        if (size % kBinaryRecordSize != 0) ++malformed; // Truncated last record
+        for (size_t i = 0; i < records && count < capacity; ++i) {
+            SensorReading r;
+            if (parseBinary(p + i * kBinaryRecordSize, r)) out[count++] = r;
+            else ++malformed;
+        }
+        return count;
+    }
+    const char* end = data + size;
+    for (const char* p = data; p < end && count < capacity;) {
+        const char* eol = static_cast<const char*>(std::memchr(p, '\n', end - p));
+        if (!eol) eol = end;
+        const char* last = eol;
+        if (last > p && last[-1] == '\r') --last;
+        if (last > p) {
+            SensorReading r;
+            if (parseLine(p, last, r)) out[count++] = r;
+            else ++malformed;
+        }
+        p = eol + 1;
+    }
+    return count;
+}
+
+size_t encodeSensorLine(const SensorReading& r, char* buffer, size_t size) {
+    int n;
+    if (r.failed) {
+        n = std::snprintf(buffer, size, "%s,zone=%u failed=1\n", r.kind == SensorKind::Weather ? "weather" : "soil", r.zone);
+    } else if (r.kind == SensorKind::Weather) {
+        n = std::snprintf(buffer, size, "weather,zone=%u temperature=%.2f,humidity=%.2f,rainfall=%.2f\n", r.zone,
+                          r.values[0], r.values[1], r.values[2]);
+    } else {
+        n = std::snprintf(buffer, size, "soil,zone=%u moisture=%.2f\n", r.zone, r.values[0]);
+    }
+    return n > 0 && static_cast<size_t>(n) < size ? static_cast<size_t>(n) : 0;
+}
+
+size_t encodeSensorBinary(const SensorReading& r, char* buffer, size_t size) {
+    if (size < kBinaryRecordSize) return 0;
+    unsigned char* p = reinterpret_cast<unsigned char*>(buffer);
+    p[0] = kBinaryMagic;
+    p[1] = static_cast<unsigned char>(r.kind);
+    p[2] = r.failed ? 1 : 0;
+    p[3] = 0;
+    std::memcpy(p + 4, &r.zone, sizeof(uint32_t));
+    std::memcpy(p + 8, r.values, sizeof(r.values));
+    return kBinaryRecordSize;
+}
+
+SensorIngestService::SensorIngestService(SensorSlots& slots) : slots(slots) {}
+
+SensorIngestService::~SensorIngestService() {
+    stop();
+}
+
+void SensorIngestService::ingest(const char* data, size_t size, int64_t receivedNs) {
+    SensorReading decoded[kMaxReadingsPerDatagram];
+    size_t bad = 0;
+    size_t count = decodeSensorDatagram(data, size, decoded, kMaxReadingsPerDatagram, bad);
+    uint64_t stored = 0;
+    for (size_t i = 0; i < count; ++i) stored += slots.store(decoded[i], receivedNs) ? 1 : 0;
+    datagrams.fetch_add(1, std::memory_order_relaxed);
+    readings.fetch_add(stored, std::memory_order_relaxed);
+    malformed.fetch_add(bad, std::memory_order_relaxed);
+    unknownZone.fetch_add(count - stored, std::memory_order_relaxed);
+}
+
+IngestStats SensorIngestService::getStats() const {
+    IngestStats stats;
+    stats.datagrams = datagrams.load(std::memory_order_relaxed);
+    stats.readings = readings.load(std::memory_order_relaxed);
+    stats.malformed = malformed.load(std::memory_order_relaxed);
+    stats.unknownZone = unknownZone.load(std::memory_order_relaxed);
+    return stats;
+}
+
+#ifdef __linux__
+bool SensorIngestService::start(const std::string& endpoint, std::string& error) {
+    stop();
+    std::string host, portText, path;
+    if (!splitEndpoint(endpoint, host, portText, path, error)) return false;
+    if (!path.empty()) {
+        socketFd = socket(AF_UNIX, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        sockaddr_un address = unixAddress(path);
+        unlink(path.c_str()); // A socket file left by an earlier run
+        if (socketFd < 0 || bind(socketFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+            error = "cannot bind " + path + ": " + std::strerror(errno);
+            stop();
+            return false;
+        }
+        unixPath = path;
+        port = 0;
+    } else {
+        socketFd = openUdp(host, portText, true, SOCK_NONBLOCK | SOCK_CLOEXEC, error);
+        if (socketFd < 0) return false;
+        sockaddr_storage bound;
+        socklen_t length = sizeof(bound);
+        getsockname(socketFd, reinterpret_cast<sockaddr*>(&bound), &length);
+        port = ntohs(bound.ss_family == AF_INET6 ? reinterpret_cast<sockaddr_in6*>(&bound)->sin6_port
+                                                 : reinterpret_cast<sockaddr_in*>(&bound)->sin_port);
+    }
+    int receiveBuffer = 1 << 20; // Room for bursts while the thread is descheduled
+    setsockopt(socketFd, SOL_SOCKET, SO_RCVBUF, &receiveBuffer, sizeof(receiveBuffer));
+    epollFd = epoll_create1(EPOLL_CLOEXEC);
+    stopFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    epoll_event socketEvent, stopEvent;
+    socketEvent.events = EPOLLIN;
+    socketEvent.data.fd = socketFd;
+    stopEvent.events = EPOLLIN;
+    stopEvent.data.fd = stopFd;
+    if (epollFd < 0 || stopFd < 0 || epoll_ctl(epollFd, EPOLL_CTL_ADD, socketFd, &socketEvent) != 0 ||
+        epoll_ctl(epollFd, EPOLL_CTL_ADD, stopFd, &stopEvent) != 0) {
+        error = std::string("cannot set up epoll: ") + std::strerror(errno);
+        stop();
+        return false;
+    }
+    buffers.assign(kBatch * kMaxSensorDatagram, '\0');
+    thread = std::thread(&SensorIngestService::run, this);
+    return true;
+}
+
+void SensorIngestService::stop() {
+    if (thread.joinable()) {
+        uint64_t one = 1;
+        ssize_t written = write(stopFd, &one, sizeof(one));
+        (void)written; // Cannot fail: the counter is far from overflowing
+        thread.join();
+    }
+    if (socketFd >= 0) ::close(socketFd);
+    if (epollFd >= 0) ::close(epollFd);
+    if (stopFd >= 0) ::close(stopFd);
+    socketFd = epollFd = stopFd = -1;
+    if (!unixPath.empty()) unlink(unixPath.c_str());
+    unixPath.clear();
+}
+
+void SensorIngestService::run() {
+    mmsghdr messages[kBatch];
+    iovec vectors[kBatch];
+    for (;;) {
+        epoll_event events[2];
+        int ready = epoll_wait(epollFd, events, 2, -1);
+        if (ready < 0 && errno == EINTR) continue;
+        if (ready < 0) return;
+        for (int e = 0; e < ready; ++e) {
+            if (events[e].data.fd == stopFd) return;
+        }
+        // Drain the socket in batches; a short batch means it is empty
+        int received;
+        do {
+            std::memset(messages, 0, sizeof(messages));
+            for (size_t i = 0; i < kBatch; ++i) {
+                vectors[i].iov_base = &buffers[i * kMaxSensorDatagram];
+                vectors[i].iov_len = kMaxSensorDatagram;
+                messages[i].msg_hdr.msg_iov = &vectors[i];
+                messages[i].msg_hdr.msg_iovlen = 1;
+            }
+            received = recvmmsg(socketFd, messages, kBatch, MSG_DONTWAIT, nullptr);
+            int64_t now = SensorSlots::nowNs();
+            for (int i = 0; i < received; ++i) {
+                if (messages[i].msg_hdr.msg_flags & MSG_TRUNC) {
+                    datagrams.fetch_add(1, std::memory_order_relaxed);
+                    malformed.fetch_add(1, std::memory_order_relaxed); // Larger than kMaxSensorDatagram
+                    continue;
+                }
+                ingest(&buffers[i * kMaxSensorDatagram], messages[i].msg_len, now);
+            }
+        } while (received == static_cast<int>(kBatch));
+    }
+}
+
+SensorClient::~SensorClient() {
+    close();
+}
+
+bool SensorClient::open(const std::string& endpoint, std::string& error) {
+    close();
+    std::string host, port, path;
+    if (!splitEndpoint(endpoint, host, port, path, error)) return false;
+    if (path.empty()) {
+        fd = openUdp(host, port, false, SOCK_CLOEXEC, error);
+        return fd >= 0;
+    }
+    fd = socket(AF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    sockaddr_un address = unixAddress(path);
+    if (fd < 0 || connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+        error = "cannot connect to " + path + ": " + std::strerror(errno);
+        close();
+        return false;
+    }
+    return true;
+}
+
+bool SensorClient::send(const char* data, size_t size) {
+    return fd >= 0 && ::send(fd, data, size, 0) == static_cast<ssize_t>(size);
+}
+
+void SensorClient::close() {
+    if (fd >= 0) ::close(fd);
+    fd = -1;
+}
+#else
+bool SensorIngestService::start(const std::string&, std::string& error) {
+    error = "sensor ingestion needs Linux (epoll)";
+    return false;
+}
+
+void SensorIngestService::stop() {}
+
+void SensorIngestService::run() {}
+
+SensorClient::~SensorClient() {}
+
+bool SensorClient::open(const std::string&, std::string& error) {
+    error = "sensor ingestion needs Linux (epoll)";
+    return false;
+}
+
+bool SensorClient::send(const char*, size_t) {
+    return false;
+}
+
+void SensorClient::close() {}
+#endif
+
+bool replaySensorLog(std::istream& csv, SensorClient& client, SensorEncoding encoding, double stepsPerSecond,
+                     ReplayStats& stats, std::string& error) {
+    std::string line;
+    if (!std::getline(csv, line)) {
+        error = "empty log";
+        return false;
+    }
+    // Columns by header name (the units after each name vary)
+    const char* const kNames[] = {"Timestamp", "SoilMoisture", "Temperature", "Humidity", "Rainfall", "SensorError", "ZoneID"};
+    int column[7] = {-1, -1, -1, -1, -1, -1, -1};
+    std::stringstream header(line);
+    std::string name;
+    for (int c = 0; std::getline(header, name, ','); ++c) {
+        for (int k = 0; k < 7; ++k) {
+            if (name.compare(0, std::strlen(kNames[k]), kNames[k]) == 0 && column[k] < 0) column[k] = c;
+        }
+    }
+    for (int k = 0; k < 7; ++k) {
+        if (column[k] < 0) {
+            error = std::string("no ") + kNames[k] + " column (expected a CSV log written by mysa_irrigation)";
+            return false;
+        }
+    }
+    char datagram[kMaxSensorDatagram];
+    size_t used = 0;
+    auto flush = [&]() -> bool {
+        if (used == 0) return true;
+        if (!client.send(datagram, used)) {
+            error = "send failed";
+            return false;
+        }
+        ++stats.datagrams;
+        used = 0;
+        return true;
+    };
+    auto append = [&](const SensorReading& r) -> bool {
+        char record[128];
+        size_t n = encoding == SensorEncoding::Binary ? encodeSensorBinary(r, record, sizeof(record))
+                                                      : encodeSensorLine(r, record, sizeof(record));
+        if (used + n > sizeof(datagram) && !flush()) return false;
+        std::memcpy(datagram + used, record, n);
+        used += n;
+        ++stats.readings;
+        return true;
+    };
+    std::string step;
+    std::vector<std::string> field;
+    auto start = std::chrono::steady_clock::now();
+    int lineNumber = 1;
+    while (std::getline(csv, line)) {
+        ++lineNumber;
+        if (line.find_first_not_of(" \t\r") == std::string::npos) continue;
+        field.clear();
+        std::stringstream row(line);
+        std::string value;
+        while (std::getline(row, value, ',')) field.push_back(value);
+        if (field.size() <= static_cast<size_t>(column[6]) || field.size() <= static_cast<size_t>(column[5])) {
+            error = "line " + std::to_string(lineNumber) + ": too few columns";
+            return false;
+        }
+        if (field[column[0]] != step) {
+            // A new step: send the previous one, then wait for this one's slot
+            if (!flush()) return false;
+            if (!step.empty() && stepsPerSecond > 0.0) {
+                std::this_thread::sleep_until(start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                                                          std::chrono::duration<double>(stats.steps / stepsPerSecond)));
+            }
+            step = field[column[0]];
+            ++stats.steps;
+        }
+        const std::string& zoneId = field[column[6]];
+        SensorReading weather, soil;
+        try {
+            if (zoneId.compare(0, 4, "Zone") != 0 || std::stoi(zoneId.substr(4)) < 1) throw std::invalid_argument(zoneId);
+            weather.zone = soil.zone = static_cast<uint32_t>(std::stoi(zoneId.substr(4)) - 1);
+            weather.values[0] = std::stof(field[column[2]]);
+            weather.values[1] = std::stof(field[column[3]]);
+            weather.values[2] = std::stof(field[column[4]]);
+            soil.values[0] = std::stof(field[column[1]]);
+        } catch (const std::logic_error&) {
+            error = "line " + std::to_string(lineNumber) + ": expected ZoneN and numeric readings";
+            return false;
+        }
+        weather.kind = SensorKind::Weather;
+        soil.kind = SensorKind::Soil;
+        weather.failed = soil.failed = field[column[5]].compare(0, 4, "TRUE") == 0;
+        if (!append(weather) || !append(soil)) return false;
+    }
+    return flush();
+}
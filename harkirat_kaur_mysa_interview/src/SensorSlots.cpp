@@ -0,0 +1,43 @@
+#include "../include/SensorSlots.h"
+#include <chrono>
+
+SensorSlots::SensorSlots(size_t zoneCount, double maxAgeSeconds)
+    : zoneCount(zoneCount), maxAgeNs(static_cast<int64_t>(maxAgeSeconds * 1e9)), slots(new Slot[zoneCount * 2]) {
+    for (size_t i = 0; i < zoneCount * 2; ++i) {
+        for (std::atomic<float>& value : slots[i].values) value.store(0.0f, std::memory_order_relaxed);
+    }
+}
+
+int64_t SensorSlots::nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+bool SensorSlots::store(const SensorReading& reading, int64_t receivedNs) {
+    if (reading.zone >= zoneCount) return false;
+    Slot& s = slot(reading.zone, reading.kind);
+    uint32_t sequence = s.sequence.load(std::memory_order_relaxed);
+    s.sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for (int i = 0; i < 3; ++i) s.values[i].store(reading.values[i], std::memory_order_relaxed);
+    s.receivedNs.store(receivedNs, std::memory_order_relaxed);
+    s.valid.store(!reading.failed, std::memory_order_relaxed);
+    s.sequence.store(sequence + 2, std::memory_order_release);
+    return true;
+}
+
+bool SensorSlots::read(uint32_t zone, SensorKind kind, float* values) const {
+    if (zone >= zoneCount) return false;
+    const Slot& s = slot(zone, kind);
+    uint32_t before, after;
+    bool valid;
+    int64_t receivedNs;
+    do {
+        before = s.sequence.load(std::memory_order_acquire);
+        for (int i = 0; i < 3; ++i) values[i] = s.values[i].load(std::memory_order_relaxed);
+        receivedNs = s.receivedNs.load(std::memory_order_relaxed);
+        valid = s.valid.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        after = s.sequence.load(std::memory_order_relaxed);
+    } while ((before & 1) != 0 || before != after);
+    return valid && nowNs() - receivedNs <= maxAgeNs;
+}
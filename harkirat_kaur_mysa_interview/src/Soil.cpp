@@ -1,9 +1,14 @@
 #include "../include/Soil.h"
+#include "../include/SensorSlots.h"
 
 Soil::Soil(float retentionRate, float drainageFactor)
     : moisture(0.0f), retentionRate(retentionRate), drainageFactor(drainageFactor) {}
 
 void Soil::update(float evapotranspiration, float rainfall, float irrigation) {
+    if (live) {
+        sampleLive(); // The device measures what rain and irrigation did
+        return;
+    }
     // Add water from rainfall and irrigation
     moisture += (rainfall + irrigation) * retentionRate;
     // Remove water from evapotranspiration
@@ -18,8 +23,31 @@ void Soil::simulateFailure() {
 }
 void Soil::resetFailure() {
     failed = false;
+    if (live) sampleLive();
+}
+
+void Soil::setLiveSource(const SensorSlots* slots, uint32_t zone) {
+    live = slots;
+    liveZone = zone;
+    if (live) sampleLive();
+}
+
+void Soil::sampleLive() {
+    float values[3];
+    failed = !live->read(liveZone, SensorKind::Soil, values);
+    if (!failed) moisture = values[0];
 }
 float Soil::getMoisture() const {
     if (failed) return -1.0f;
     return moisture;
-} 
\ No newline at end of file
+} 
+
+void Soil::save(SnapshotWriter& out) const {
+    out.write(moisture);
+    out.write(failed);
+}
+
+void Soil::restore(SnapshotReader& in) {
+    in.read(moisture);
+    in.read(failed);
+}
@@ -27,6 +27,17 @@ void WaterPump::update(int secondsElapsed) {
         cooldownLeft--;
     }
 }
+void WaterPump::advance(int ticks) {
+    if (on) {
+        if (runTime + ticks < maxRunTime) {
+            runTime += ticks;
+            return;
+        }
+        ticks -= maxRunTime - runTime; // The tick that hits maxRunTime turns the pump off
+        turnOff();
+    }
+    cooldownLeft = ticks < cooldownLeft ? cooldownLeft - ticks : 0;
+}
 bool WaterPump::canRun() const {
     return !on && cooldownLeft == 0;
 }
@@ -35,4 +46,16 @@ void WaterPump::setMaxRunTime(int seconds) {
 }
 void WaterPump::setCooldownTime(int seconds) {
     cooldownTime = seconds;
-} 
\ No newline at end of file
+} 
+
+void WaterPump::save(SnapshotWriter& out) const {
+    out.write(on);
+    out.write(runTime);
+    out.write(cooldownLeft);
+}
+
+void WaterPump::restore(SnapshotReader& in) {
+    in.read(on);
+    in.read(runTime);
+    in.read(cooldownLeft);
+}
@@ -0,0 +1,128 @@
+#include "../include/WeatherBatch.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+namespace {
+
+const size_t kChunk = 64;
+const uint32_t kDraws = 4; // Draw indices 1-4 of a tick: temperature noise, humidity noise, rain chance, rain amount
+
+std::vector<double> buildDiurnalTable() {
+    std::vector<double> table(WeatherBatch::kDaySeconds);
+    for (int s = 0; s < WeatherBatch::kDaySeconds; ++s) {
+        float dayFraction = s / 86400.0f; // Float, as in WeatherSensor::simulateWeather
+        table[s] = 15.0f + 10.0f * std::sin(2 * M_PI * dayFraction);
+    }
+    return table;
+}
+
+// CounterRng::mix on four 64-bit lanes. There is no 64-bit lane multiply before AVX-512, so the
+// products are built from 32 x 32 -> 64-bit multiplies: lo * lo + ((hi * lo + lo * hi) << 32).
+// With only two SSE2 lanes that costs more than the scalar multiplies, so SSE2 builds stay scalar.
+#if defined(__AVX2__)
+inline __m256i mul64(__m256i a, __m256i b) {
+    __m256i low = _mm256_mul_epu32(a, b);
+    __m256i cross = _mm256_add_epi64(_mm256_mul_epu32(_mm256_srli_epi64(a, 32), b),
+                                     _mm256_mul_epu32(a, _mm256_srli_epi64(b, 32)));
+    return _mm256_add_epi64(low, _mm256_slli_epi64(cross, 32));
+}
+
+inline __m256i mix4(__m256i x) {
+    x = _mm256_add_epi64(x, _mm256_set1_epi64x(static_cast<long long>(CounterRng::kGamma)));
+    x = mul64(_mm256_xor_si256(x, _mm256_srli_epi64(x, 30)), _mm256_set1_epi64x(static_cast<long long>(0xBF58476D1CE4E5B9ULL)));
+    x = mul64(_mm256_xor_si256(x, _mm256_srli_epi64(x, 27)), _mm256_set1_epi64x(static_cast<long long>(0x94D049BB133111EBULL)));
+    return _mm256_xor_si256(x, _mm256_srli_epi64(x, 31));
+}
+#endif
+
+// draws[k][i] = CounterRng::draw(tick i, k + 1), from the pre-mix counters of n <= kChunk readings
+void drawNoise(const uint64_t* counters, size_t n, uint32_t (*draws)[kChunk]) {
+    size_t i = 0;
+#if defined(__AVX2__)
+    const __m256i oddDwords = _mm256_setr_epi32(1, 3, 5, 7, 0, 2, 4, 6);
+    for (; i + 4 <= n; i += 4) {
+        __m256i tickHash = mix4(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(counters + i)));
+        for (uint32_t k = 0; k < kDraws; ++k) {
+            __m256i d = mix4(_mm256_add_epi64(tickHash, _mm256_set1_epi64x(k + 1)));
+            // The draw is the high half of each lane
+            __m256i high = _mm256_permutevar8x32_epi32(d, oddDwords);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(draws[k] + i), _mm256_castsi256_si128(high));
+        }
+    }
+#endif
+    for (; i < n; ++i) {
+        uint64_t tickHash = CounterRng::mix(counters[i]);
+        for (uint32_t k = 0; k < kDraws; ++k) draws[k][i] = static_cast<uint32_t>(CounterRng::mix(tickHash + k + 1) >> 32);
+    }
+}
+
+// The rest of WeatherSensor::simulateWeather for n readings; curve[i * curveStride] is reading i's daily curve value
+void finish(const uint32_t (*draws)[kChunk], size_t n, const double* curve, size_t curveStride, float* temperature,
+            float* humidity, float* rainfall) {
+    for (size_t i = 0; i < n; ++i) {
+        float t = curve[i * curveStride] + (static_cast<int>(draws[0][i] % 200u) - 100) / 100.0f;
+        float h = 80.0f - (t - 15.0f) * 2.0f + (static_cast<int>(draws[1][i] % 100u) - 50) / 100.0f;
+        if (t < -10.0f) t = -10.0f;
+        if (t > 40.0f) t = 40.0f;
+        if (h < 0.0f) h = 0.0f;
+        if (h > 100.0f) h = 100.0f;
+        temperature[i] = t;
+        humidity[i] = h;
+        rainfall[i] = draws[2][i] % 3600u < 360u ? (static_cast<int>(draws[3][i] % 10u) + 1) * 0.5f : 0.0f;
+    }
+}
+
+} // namespace
+
+const double* WeatherBatch::diurnalTable() {
+    static const std::vector<double> table = buildDiurnalTable();
+    return table.data();
+}
+
+const char* WeatherBatch::simdLevel() {
+#if defined(__AVX2__)
+    return "AVX2";
+#else
+    return "scalar";
+#endif
+}
+
+void WeatherBatch::generateTicks(const CounterRng& rng, int first, size_t count, float* temperature, float* humidity,
+                                 float* rainfall) {
+    const double* table = diurnalTable();
+    uint64_t counters[kChunk];
+    uint32_t draws[kDraws][kChunk];
+    size_t done = 0;
+    while (done < count) {
+        int tick = first + static_cast<int>(done);
+        int daySecond = tick % kDaySeconds;
+        // Chunks end at midnight, where the curve wraps
+        size_t n = std::min(std::min(kChunk, count - done), static_cast<size_t>(kDaySeconds - daySecond));
+        for (size_t i = 0; i < n; ++i) counters[i] = rng.counter(static_cast<uint64_t>(tick) + i);
+        drawNoise(counters, n, draws);
+        finish(draws, n, table + daySecond, 1, temperature + done, humidity + done, rainfall + done);
+        done += n;
+    }
+}
+
+void WeatherBatch::generateZones(const CounterRng* rngs, size_t count, int tick, float* temperature, float* humidity,
+                                 float* rainfall) {
+    const double* curve = diurnalTable() + tick % kDaySeconds;
+    uint64_t counters[kChunk];
+    uint32_t draws[kDraws][kChunk];
+    for (size_t done = 0; done < count; done += kChunk) {
+        size_t n = std::min(kChunk, count - done);
+        for (size_t i = 0; i < n; ++i) counters[i] = rngs[done + i].counter(static_cast<uint64_t>(tick));
+        drawNoise(counters, n, draws);
+        finish(draws, n, curve, 0, temperature + done, humidity + done, rainfall + done);
+    }
+}
@@ -1,18 +1,26 @@
 #include "../include/WeatherSensor.h"
-#include <cmath>
-#include <ctime>
+#include "../include/Profiler.h"
+#include "../include/SensorSlots.h"
+#include "../include/WeatherBatch.h"
 
-#ifndef M_PI
-#define M_PI 3.14159265358979323846
-#endif
+WeatherSensor::WeatherSensor() : WeatherSensor(CounterRng()) {}
 
-WeatherSensor::WeatherSensor() : temperature(20.0f), humidity(50.0f), rainfall(0.0f), failed(false) {
-    std::srand(static_cast<unsigned int>(std::time(nullptr)));
+WeatherSensor::WeatherSensor(const CounterRng& rng)
+    : temperature(20.0f), humidity(50.0f), rainfall(0.0f), failed(false),
+      rng(rng.withStream(CounterRng::WeatherStream)), forecastRng(rng.withStream(CounterRng::ForecastStream)) {
+    issueForecast(0);
 }
 
 void WeatherSensor::update(int secondsElapsed) {
+    ProfileScope profile(ProfileSection::WeatherUpdate);
+    int hour = secondsElapsed / 3600;
+    if (hour != forecastHour) issueForecast(hour);
+    if (live) {
+        sampleLive();
+        return;
+    }
     // 0.2% chance per update to simulate failure
-    if (!failed && (std::rand() % 5000 < 10)) {
+    if (!failed && (rng.drawInt(secondsElapsed, 0, 5000) < 10)) {
         failed = true;
     }
     simulateWeather(secondsElapsed);
@@ -25,21 +33,24 @@ void WeatherSensor::simulateWeather(int secondsElapsed) {
         rainfall = -999.0f;
         return;
     }
-    // Simulate a daily temperature cycle (sine wave: 24h = 86400s)
-    float dayFraction = (secondsElapsed % 86400) / 86400.0f;
-    temperature = 15.0f + 10.0f * std::sin(2 * M_PI * dayFraction) + (std::rand() % 200 - 100) / 100.0f;
-    humidity = 80.0f - (temperature - 15.0f) * 2.0f + (std::rand() % 100 - 50) / 100.0f;
-    // Clamp temperature and humidity
-    if (temperature < -10.0f) temperature = -10.0f;
-    if (temperature > 40.0f) temperature = 40.0f;
-    if (humidity < 0.0f) humidity = 0.0f;
-    if (humidity > 100.0f) humidity = 100.0f;
-    // Random rainfall event (10% chance per hour)
-    if (std::rand() % 3600 < 360) {
-        rainfall = (std::rand() % 10 + 1) * 0.5f; // 0.5 to 5 mm
-    } else {
-        rainfall = 0.0f;
+    if (trace) {
+        WeatherSample s = trace->sample(secondsElapsed);
+        temperature = s.temperature;
+        humidity = s.humidity;
+        rainfall = s.rainfall;
+        return;
     }
+    // Daily temperature cycle plus noise and random rain events, read from the batch block.
+    // Consecutive ticks fill a block ahead; a sensor stepped in larger strides computes just the tick it needs.
+    if (secondsElapsed < blockStart || secondsElapsed >= blockStart + blockLength) {
+        blockStart = secondsElapsed;
+        blockLength = secondsElapsed == lastTick + 1 ? kBlockTicks : 1;
+        WeatherBatch::generateTicks(rng, blockStart, blockLength, blockTemperature, blockHumidity, blockRainfall);
+    }
+    lastTick = secondsElapsed;
+    temperature = blockTemperature[secondsElapsed - blockStart];
+    humidity = blockHumidity[secondsElapsed - blockStart];
+    rainfall = blockRainfall[secondsElapsed - blockStart];
 }
 
 float WeatherSensor::getTemperature() const { return failed ? -999.0f : temperature; }
@@ -49,18 +60,136 @@ bool WeatherSensor::hasFailed() const { return failed; }
 
 void WeatherSensor::resetFailure() {
     failed = false;
+    if (live) sampleLive(); // Still failed if the device has not sent a valid reading since
 }
 
-float WeatherSensor::getRainForecast(int hours) const {
-    if (failed) return -999.0f;
-    float totalForecast = 0.0f;
-    for (int h = 0; h < hours; ++h) {
-        // 10% chance per hour for rain event, as in simulateWeather
-        bool rainEvent = (std::rand() % 10 == 0); // 1 in 10
-        if (rainEvent) {
-            float rainAmount = (std::rand() % 10 + 1) * 0.5f; // 0.5 to 5 mm
-            totalForecast += rainAmount;
+void WeatherSensor::setLiveSource(const SensorSlots* slots, uint32_t zone) {
+    live = slots;
+    liveZone = zone;
+    if (live) sampleLive();
+}
+
+void WeatherSensor::sampleLive() {
+    float values[3];
+    failed = !live->read(liveZone, SensorKind::Weather, values);
+    temperature = failed ? -999.0f : values[0];
+    humidity = failed ? -999.0f : values[1];
+    rainfall = failed ? -999.0f : values[2];
+}
+
+void WeatherSensor::setForecastEnsembleMembers(int members) {
+    if (members < 1) members = 1;
+    if (members > kMaxEnsembleMembers) members = kMaxEnsembleMembers;
+    ensembleMembers = members;
+    issueForecast(forecastHour < 0 ? 0 : forecastHour);
+}
+
+void WeatherSensor::setTrace(const WeatherTrace* t) {
+    trace = t && t->isOpen() ? t : nullptr;
+    issueForecast(forecastHour < 0 ? 0 : forecastHour);
+}
+
+void WeatherSensor::issueForecast(int hour) {
+    ProfileScope profile(ProfileSection::Forecast);
+    forecastHour = hour;
+    if (trace) {
+        // The recorded rain is a perfect forecast: every member agrees
+        rainPrefix[0] = 0.0f;
+        rainProbability[0] = 0.0f;
+        for (int h = 0; h < kForecastHours; ++h) {
+            int64_t start = (static_cast<int64_t>(hour) + h) * 3600;
+            float rain = trace->rainBetween(start, start + 3600);
+            rainHourly[h] = rain;
+            rainPrefix[h + 1] = rainPrefix[h] + rain;
+            rainProbability[h + 1] = rain > 0.0f ? 1.0f : rainProbability[h];
         }
+        return;
     }
-    return totalForecast;
-} 
\ No newline at end of file
+    // firstRain[h]: members whose first rainy hour is h (kForecastHours if none)
+    int firstRain[kForecastHours + 1] = {};
+    float rain[kForecastHours] = {};
+    for (int m = 0; m < ensembleMembers; ++m) {
+        int first = kForecastHours;
+        for (int h = 0; h < kForecastHours; ++h) {
+            float memberHour = memberRain(forecastRng, m, static_cast<uint64_t>(hour) + h);
+            if (memberHour > 0.0f) {
+                rain[h] += memberHour;
+                if (first == kForecastHours) first = h;
+            }
+        }
+        ++firstRain[first];
+    }
+    rainPrefix[0] = 0.0f;
+    rainProbability[0] = 0.0f;
+    int rainyMembers = 0;
+    for (int h = 0; h < kForecastHours; ++h) {
+        rainHourly[h] = rain[h] / ensembleMembers;
+        rainPrefix[h + 1] = rainPrefix[h] + rainHourly[h];
+        rainyMembers += firstRain[h];
+        rainProbability[h + 1] = static_cast<float>(rainyMembers) / ensembleMembers;
+    }
+}
+
+float WeatherSensor::memberRain(const CounterRng& forecastRng, int member, uint64_t hour) {
+    // 10% chance per hour for rain event, as in simulateWeather
+    if (forecastRng.drawInt(hour, 2 * member, 10) != 0) return 0.0f;
+    return (forecastRng.drawInt(hour, 2 * member + 1, 10) + 1) * 0.5f; // 0.5 to 5 mm
+}
+
+float WeatherSensor::syntheticForecastRain(const CounterRng& forecastRng, int members, int64_t hour) {
+    // Same member order and float sums as issueForecast
+    float rain = 0.0f;
+    for (int m = 0; m < members; ++m) rain += memberRain(forecastRng, m, static_cast<uint64_t>(hour));
+    return rain / members;
+}
+
+float WeatherSensor::getRainForecast(int hours) const {
+    if (failed) return -999.0f;
+    if (hours < 0) hours = 0;
+    if (hours > kForecastHours) hours = kForecastHours;
+    return rainPrefix[hours];
+}
+
+float WeatherSensor::getRainProbability(int hours) const {
+    if (failed) return -999.0f;
+    if (hours < 0) hours = 0;
+    if (hours > kForecastHours) hours = kForecastHours;
+    return rainProbability[hours];
+}
+
+float WeatherSensor::getForecastRainAt(int64_t hour) const {
+    int64_t h = hour - forecastHour;
+    return h >= 0 && h < kForecastHours ? rainHourly[h] : 0.0f;
+}
+
+WeatherSample WeatherSensor::expectedWeather(int64_t t) const {
+    if (trace) return trace->sample(t);
+    // simulateWeather's daily cycle without the noise, clamped the same way
+    WeatherSample w;
+    w.temperature = static_cast<float>(WeatherBatch::diurnal(static_cast<int>(t % WeatherBatch::kDaySeconds)));
+    w.humidity = 80.0f - (w.temperature - 15.0f) * 2.0f;
+    if (w.temperature < -10.0f) w.temperature = -10.0f;
+    if (w.temperature > 40.0f) w.temperature = 40.0f;
+    if (w.humidity < 0.0f) w.humidity = 0.0f;
+    if (w.humidity > 100.0f) w.humidity = 100.0f;
+    w.rainfall = 0.0f;
+    return w;
+}
+
+void WeatherSensor::save(SnapshotWriter& out) const {
+    out.write(temperature);
+    out.write(humidity);
+    out.write(rainfall);
+    out.write(failed);
+    out.write(forecastHour);
+}
+
+void WeatherSensor::restore(SnapshotReader& in) {
+    in.read(temperature);
+    in.read(humidity);
+    in.read(rainfall);
+    in.read(failed);
+    int hour = 0;
+    in.read(hour);
+    issueForecast(hour < 0 ? 0 : hour); // Draws are keyed by hour, so this reproduces the saved timeline
+}
@@ -0,0 +1,208 @@
+#include "../include/WeatherTrace.h"
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+const char kMagic[8] = {'M', 'Y', 'S', 'A', 'W', 'X', '\0', '\0'};
+const uint32_t kVersion = 1;
+const size_t kHeaderSize = 24;
+
+template <typename T>
+void writeRaw(std::ofstream& out, const T& value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+} // namespace
+
+WeatherTrace::WeatherTrace() {}
+
+WeatherTrace::~WeatherTrace() {
+    close();
+}
+
+bool WeatherTrace::open(const std::string& filename, std::string& error) {
+    close();
+#ifdef _WIN32
+    HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        error = "cannot open " + filename;
+        return false;
+    }
+    LARGE_INTEGER fileSize;
+    GetFileSizeEx(file, &fileSize);
+    HANDLE mapping = fileSize.QuadPart > 0 ? CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr) : nullptr;
+    const void* view = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (!view) {
+        if (mapping) CloseHandle(mapping);
+        CloseHandle(file);
+        error = "cannot map " + filename;
+        return false;
+    }
+    fileHandle = file;
+    mappingHandle = mapping;
+    size = static_cast<size_t>(fileSize.QuadPart);
+#else
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        error = "cannot open " + filename;
+        return false;
+    }
+    struct stat st;
+    void* view = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && st.st_size > 0) {
+        view = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    }
+    ::close(fd); // The mapping stays valid without the descriptor
+    if (view == MAP_FAILED) {
+        error = "cannot map " + filename;
+        return false;
+    }
+    size = static_cast<size_t>(st.st_size);
+#endif
+    data = static_cast<const char*>(view);
+    uint32_t version = 0, samples = 0;
+    if (size >= kHeaderSize) {
+        std::memcpy(&version, data + 8, sizeof(version));
+        std::memcpy(&interval, data + 12, sizeof(interval));
+        std::memcpy(&samples, data + 16, sizeof(samples));
+    }
+    if (size < kHeaderSize || std::memcmp(data, kMagic, sizeof(kMagic)) != 0 || version != kVersion) {
+        error = filename + " is not a weather trace (.mwx)";
+    } else if (interval == 0 || samples == 0) {
+        error = filename + " has no samples";
+    } else if ((size - kHeaderSize) / (3 * sizeof(float)) < samples) {
+        error = filename + " is truncated";
+    } else {
+        // The header keeps the columns 4-byte aligned within the page-aligned mapping
+        temperature = reinterpret_cast<const float*>(data + kHeaderSize);
+        humidity = temperature + samples;
+        rainfall = humidity + samples;
+        count = samples;
+        return true;
+    }
+    close();
+    return false;
+}
+
+void WeatherTrace::close() {
+    if (data) {
+#ifdef _WIN32
+        UnmapViewOfFile(data);
+        CloseHandle(static_cast<HANDLE>(mappingHandle));
+        CloseHandle(static_cast<HANDLE>(fileHandle));
+        mappingHandle = nullptr;
+        fileHandle = nullptr;
+#else
+        munmap(const_cast<char*>(data), size);
+#endif
+    }
+    data = nullptr;
+    size = 0;
+    interval = 0;
+    count = 0;
+    temperature = humidity = rainfall = nullptr;
+}
+
+WeatherSample WeatherTrace::sample(int64_t t) const {
+    int64_t duration = getDuration();
+    int64_t wrapped = t % duration;
+    if (wrapped < 0) wrapped += duration;
+    uint32_t i = static_cast<uint32_t>(wrapped / interval);
+    uint32_t next = i + 1 == count ? 0 : i + 1;
+    float fraction = static_cast<float>(wrapped % interval) / interval;
+    WeatherSample s;
+    s.temperature = temperature[i] + (temperature[next] - temperature[i]) * fraction;
+    s.humidity = humidity[i] + (humidity[next] - humidity[i]) * fraction;
+    s.rainfall = rainfall[i] / interval;
+    return s;
+}
+
+float WeatherTrace::rainBetween(int64_t from, int64_t to) const {
+    int64_t duration = getDuration();
+    float total = 0.0f;
+    while (from < to) {
+        int64_t wrapped = from % duration;
+        if (wrapped < 0) wrapped += duration;
+        int64_t offset = wrapped % interval;
+        int64_t end = from + (interval - offset);
+        if (end > to) end = to;
+        total += rainfall[wrapped / interval] * static_cast<float>(end - from) / interval;
+        from = end;
+    }
+    return total;
+}
+
+bool writeWeatherTrace(const std::string& filename, uint32_t intervalSeconds, const std::vector<float>& temperature,
+                       const std::vector<float>& humidity, const std::vector<float>& rainfall) {
+    if (temperature.size() != humidity.size() || temperature.size() != rainfall.size()) return false;
+    std::ofstream file(filename, std::ios::binary);
+    if (!file) return false;
+    file.write(kMagic, sizeof(kMagic));
+    writeRaw(file, kVersion);
+    writeRaw(file, intervalSeconds);
+    writeRaw(file, static_cast<uint32_t>(temperature.size()));
+    writeRaw(file, static_cast<uint32_t>(0));
+    file.write(reinterpret_cast<const char*>(temperature.data()), temperature.size() * sizeof(float));
+    file.write(reinterpret_cast<const char*>(humidity.data()), humidity.size() * sizeof(float));
+    file.write(reinterpret_cast<const char*>(rainfall.data()), rainfall.size() * sizeof(float));
+    return static_cast<bool>(file);
+}
+
+bool convertWeatherCsv(std::istream& csv, const std::string& filename, std::string& error) {
+    std::vector<float> temperature, humidity, rainfall;
+    long long firstTime = 0, lastTime = 0, interval = 0;
+    std::string line;
+    int lineNumber = 0;
+    try {
+        while (std::getline(csv, line)) {
+            ++lineNumber;
+            if (line.find_first_not_of(" \t\r") == std::string::npos) continue;
+            if (temperature.empty() && line.find_first_of("0123456789-") != line.find_first_not_of(" \t")) {
+                continue; // Header
+            }
+            std::stringstream row(line);
+            std::string field[4];
+            for (std::string& f : field) std::getline(row, f, ',');
+            long long time = std::stoll(field[0]);
+            if (temperature.size() == 1) {
+                interval = time - firstTime;
+                if (interval <= 0) {
+                    error = "line " + std::to_string(lineNumber) + ": times must increase";
+                    return false;
+                }
+            } else if (temperature.size() > 1 && time - lastTime != interval) {
+                error = "line " + std::to_string(lineNumber) + ": samples must be evenly spaced (" +
+                        std::to_string(interval) + " s)";
+                return false;
+            }
+            if (temperature.empty()) firstTime = time;
+            lastTime = time;
+            temperature.push_back(std::stof(field[1]));
+            humidity.push_back(std::stof(field[2]));
+            rainfall.push_back(std::stof(field[3]));
+        }
+    } catch (const std::logic_error&) {
+        error = "line " + std::to_string(lineNumber) + ": expected time_s,temperature,humidity,rain_mm";
+        return false;
+    }
+    if (temperature.empty()) {
+        error = "no samples";
+        return false;
+    }
+    if (interval == 0) interval = 1;
+    if (!writeWeatherTrace(filename, static_cast<uint32_t>(interval), temperature, humidity, rainfall)) {
+        error = "cannot write " + filename;
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,241 @@
+#include "../include/ZoneBatch.h"
+
+#if defined(__AVX__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+size_t ZoneBatch::addZone(const ZoneParams& p) {
+    moisture.push_back(0.0f);
+    retentionRate.push_back(p.retentionRate);
+    evapScale.push_back(1.0f - p.drainageFactor);
+    stress.push_back(0.0f);
+    absorptionRate.push_back(p.absorptionRate);
+    needPerSecond.push_back(p.waterNeedPerDay / 86400.0f);
+    flowRateLpm.push_back(p.flowRateLpm);
+    flowPerSecond.push_back(p.flowRateLpm / 60.0f);
+    powerWatts.push_back(p.powerWatts);
+    pumpOn.push_back(0);
+    runTime.push_back(0);
+    maxRunTime.push_back(p.maxRunTime);
+    cooldownTime.push_back(p.cooldownTime);
+    cooldownLeft.push_back(0);
+    evapBuffer.push_back(0.0f);
+    return moisture.size() - 1;
+}
+
+const char* ZoneBatch::simdLevel() {
+#if defined(__AVX2__)
+    return "AVX2";
+#elif defined(__AVX__)
+    return "AVX";
+#elif defined(__SSE2__)
+    return "SSE2";
+#else
+    return "scalar";
+#endif
+}
+
+void ZoneBatch::turnOn(size_t zone) {
+    if (canRun(zone)) pumpOn[zone] = 1;
+}
+
+void ZoneBatch::turnOff(size_t zone) {
+    pumpOn[zone] = 0;
+    runTime[zone] = 0;
+    cooldownLeft[zone] = cooldownTime[zone];
+}
+
+void ZoneBatch::updatePumps() {
+    const size_t n = size();
+    size_t i = 0;
+    int32_t* on = pumpOn.data();
+    int32_t* rt = runTime.data();
+    int32_t* cl = cooldownLeft.data();
+    const int32_t* maxRt = maxRunTime.data();
+    const int32_t* cd = cooldownTime.data();
+#if defined(__AVX2__)
+    const __m256i one8 = _mm256_set1_epi32(1);
+    const __m256i zero8 = _mm256_setzero_si256();
+    for (; i + 8 <= n; i += 8) {
+        __m256i vOn = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(on + i));
+        __m256i vRt = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rt + i));
+        __m256i vCl = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(cl + i));
+        __m256i vMax = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(maxRt + i));
+        __m256i vCd = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(cd + i));
+        __m256i onMask = _mm256_cmpeq_epi32(vOn, one8);
+        __m256i rtNext = _mm256_add_epi32(vRt, one8);
+        // expired = on && runTime + 1 >= maxRunTime
+        __m256i expired = _mm256_andnot_si256(_mm256_cmpgt_epi32(vMax, rtNext), onMask);
+        __m256i running = _mm256_andnot_si256(expired, onMask);
+        __m256i cooling = _mm256_andnot_si256(onMask, _mm256_cmpgt_epi32(vCl, zero8));
+        vRt = _mm256_blendv_epi8(vRt, rtNext, running);
+        vRt = _mm256_andnot_si256(expired, vRt);
+        vCl = _mm256_blendv_epi8(vCl, _mm256_sub_epi32(vCl, one8), cooling);
+        vCl = _mm256_blendv_epi8(vCl, vCd, expired);
+        vOn = _mm256_and_si256(running, one8);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(on + i), vOn);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(rt + i), vRt);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(cl + i), vCl);
+    }
+#elif defined(__SSE2__)
+    const __m128i one4 = _mm_set1_epi32(1);
+    const __m128i zero4 = _mm_setzero_si128();
+    for (; i + 4 <= n; i += 4) {
+        __m128i vOn = _mm_loadu_si128(reinterpret_cast<const __m128i*>(on + i));
+        __m128i vRt = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rt + i));
+        __m128i vCl = _mm_loadu_si128(reinterpret_cast<const __m128i*>(cl + i));
+        __m128i vMax = _mm_loadu_si128(reinterpret_cast<const __m128i*>(maxRt + i));
+        __m128i vCd = _mm_loadu_si128(reinterpret_cast<const __m128i*>(cd + i));
+        __m128i onMask = _mm_cmpeq_epi32(vOn, one4);
+        __m128i rtNext = _mm_add_epi32(vRt, one4);
+        __m128i expired = _mm_andnot_si128(_mm_cmplt_epi32(rtNext, vMax), onMask);
+        __m128i running = _mm_andnot_si128(expired, onMask);
+        __m128i cooling = _mm_andnot_si128(onMask, _mm_cmpgt_epi32(vCl, zero4));
+        // SSE2 has no blend: select with and/andnot/or
+        vRt = _mm_or_si128(_mm_and_si128(running, rtNext), _mm_andnot_si128(onMask, vRt));
+        vCl = _mm_or_si128(_mm_and_si128(cooling, _mm_sub_epi32(vCl, one4)), _mm_andnot_si128(cooling, vCl));
+        vCl = _mm_or_si128(_mm_and_si128(expired, vCd), _mm_andnot_si128(expired, vCl));
+        vOn = _mm_and_si128(running, one4);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(on + i), vOn);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(rt + i), vRt);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(cl + i), vCl);
+    }
+#endif
+    for (; i < n; ++i) {
+        if (on[i]) {
+            rt[i]++;
+            if (rt[i] >= maxRt[i]) {
+                on[i] = 0;
+                rt[i] = 0;
+                cl[i] = cd[i];
+            }
+        } else if (cl[i] > 0) {
+            cl[i]--;
+        }
+    }
+}
+
+void ZoneBatch::updateSoil(const float* evapotranspiration, const float* rainfall) {
+    const size_t n = size();
+    size_t i = 0;
+    float* m = moisture.data();
+    const float* ret = retentionRate.data();
+    const float* scale = evapScale.data();
+    const float* flow = flowPerSecond.data();
+    const int32_t* on = pumpOn.data();
+#if defined(__AVX__)
+    const __m256 hundred8 = _mm256_set1_ps(100.0f);
+    const __m256 zero8 = _mm256_setzero_ps();
+    for (; i + 8 <= n; i += 8) {
+        // irrigation = pump on ? flowRate / 60 : 0 (AVX1 has no 256-bit integer compare)
+        __m256 onMask = _mm256_cmp_ps(_mm256_cvtepi32_ps(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(on + i))),
+                                      zero8, _CMP_NEQ_OQ);
+        __m256 irrigation = _mm256_and_ps(onMask, _mm256_loadu_ps(flow + i));
+        __m256 v = _mm256_loadu_ps(m + i);
+        v = _mm256_add_ps(v, _mm256_mul_ps(_mm256_add_ps(_mm256_loadu_ps(rainfall + i), irrigation), _mm256_loadu_ps(ret + i)));
+        v = _mm256_sub_ps(v, _mm256_mul_ps(_mm256_loadu_ps(evapotranspiration + i), _mm256_loadu_ps(scale + i)));
+        v = _mm256_max_ps(_mm256_min_ps(v, hundred8), zero8);
+        _mm256_storeu_ps(m + i, v);
+    }
+#elif defined(__SSE2__)
+    const __m128 hundred4 = _mm_set1_ps(100.0f);
+    const __m128 zero4 = _mm_setzero_ps();
+    const __m128i zeroi = _mm_setzero_si128();
+    for (; i + 4 <= n; i += 4) {
+        __m128i offMask = _mm_cmpeq_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(on + i)), zeroi);
+        __m128 irrigation = _mm_andnot_ps(_mm_castsi128_ps(offMask), _mm_loadu_ps(flow + i));
+        __m128 v = _mm_loadu_ps(m + i);
+        v = _mm_add_ps(v, _mm_mul_ps(_mm_add_ps(_mm_loadu_ps(rainfall + i), irrigation), _mm_loadu_ps(ret + i)));
+        v = _mm_sub_ps(v, _mm_mul_ps(_mm_loadu_ps(evapotranspiration + i), _mm_loadu_ps(scale + i)));
+        v = _mm_max_ps(_mm_min_ps(v, hundred4), zero4);
+        _mm_storeu_ps(m + i, v);
+    }
+#endif
+    for (; i < n; ++i) {
+        float irrigation = on[i] ? flow[i] : 0.0f;
+        float v = m[i] + (rainfall[i] + irrigation) * ret[i];
+        v -= evapotranspiration[i] * scale[i];
+        if (v > 100.0f) v = 100.0f;
+        if (v < 0.0f) v = 0.0f;
+        m[i] = v;
+    }
+}
+
+void ZoneBatch::updatePlants() {
+    const size_t n = size();
+    size_t i = 0;
+    float* s = stress.data();
+    const float* m = moisture.data();
+    const float* abs = absorptionRate.data();
+    const float* need = needPerSecond.data();
+#if defined(__AVX__)
+    const __m256 hundred8 = _mm256_set1_ps(100.0f);
+    const __m256 zero8 = _mm256_setzero_ps();
+    const __m256 ten8 = _mm256_set1_ps(10.0f);
+    const __m256 recover8 = _mm256_set1_ps(0.1f);
+    for (; i + 8 <= n; i += 8) {
+        __m256 vNeed = _mm256_loadu_ps(need + i);
+        __m256 absorbed = _mm256_mul_ps(_mm256_loadu_ps(m + i), _mm256_loadu_ps(abs + i));
+        __m256 thirsty = _mm256_cmp_ps(absorbed, vNeed, _CMP_LT_OQ);
+        __m256 v = _mm256_loadu_ps(s + i);
+        __m256 up = _mm256_add_ps(v, _mm256_mul_ps(_mm256_sub_ps(vNeed, absorbed), ten8));
+        __m256 down = _mm256_sub_ps(v, recover8);
+        v = _mm256_blendv_ps(down, up, thirsty);
+        v = _mm256_min_ps(_mm256_max_ps(v, zero8), hundred8);
+        _mm256_storeu_ps(s + i, v);
+    }
+#elif defined(__SSE2__)
+    const __m128 hundred4 = _mm_set1_ps(100.0f);
+    const __m128 zero4 = _mm_setzero_ps();
+    const __m128 ten4 = _mm_set1_ps(10.0f);
+    const __m128 recover4 = _mm_set1_ps(0.1f);
+    for (; i + 4 <= n; i += 4) {
+        __m128 vNeed = _mm_loadu_ps(need + i);
+        __m128 absorbed = _mm_mul_ps(_mm_loadu_ps(m + i), _mm_loadu_ps(abs + i));
+        __m128 thirsty = _mm_cmplt_ps(absorbed, vNeed);
+        __m128 v = _mm_loadu_ps(s + i);
+        __m128 up = _mm_add_ps(v, _mm_mul_ps(_mm_sub_ps(vNeed, absorbed), ten4));
+        __m128 down = _mm_sub_ps(v, recover4);
+        v = _mm_or_ps(_mm_and_ps(thirsty, up), _mm_andnot_ps(thirsty, down));
+        v = _mm_min_ps(_mm_max_ps(v, zero4), hundred4);
+        _mm_storeu_ps(s + i, v);
+    }
+#endif
+    for (; i < n; ++i) {
+        float absorbed = m[i] * abs[i];
+        float v = s[i];
+        if (absorbed < need[i]) {
+            v += (need[i] - absorbed) * 10.0f;
+        } else {
+            v -= 0.1f;
+        }
+        if (v < 0.0f) v = 0.0f;
+        if (v > 100.0f) v = 100.0f;
+        s[i] = v;
+    }
+}
+
+void ZoneBatch::step(const float* temperature, const float* humidity, const float* rainfall) {
+    const size_t n = size();
+    size_t i = 0;
+    float* evap = evapBuffer.data();
+    // evapotranspiration = (temp / 30) * (1 - humidity / 100) * 0.05, as in GardenZone::update
+#if defined(__AVX__)
+    for (; i + 8 <= n; i += 8) {
+        __m256 t = _mm256_div_ps(_mm256_loadu_ps(temperature + i), _mm256_set1_ps(30.0f));
+        __m256 h = _mm256_sub_ps(_mm256_set1_ps(1.0f), _mm256_div_ps(_mm256_loadu_ps(humidity + i), _mm256_set1_ps(100.0f)));
+        _mm256_storeu_ps(evap + i, _mm256_mul_ps(_mm256_mul_ps(t, h), _mm256_set1_ps(0.05f)));
+    }
+#elif defined(__SSE2__)
+    for (; i + 4 <= n; i += 4) {
+        __m128 t = _mm_div_ps(_mm_loadu_ps(temperature + i), _mm_set1_ps(30.0f));
+        __m128 h = _mm_sub_ps(_mm_set1_ps(1.0f), _mm_div_ps(_mm_loadu_ps(humidity + i), _mm_set1_ps(100.0f)));
+        _mm_storeu_ps(evap + i, _mm_mul_ps(_mm_mul_ps(t, h), _mm_set1_ps(0.05f)));
+    }
+#endif
+    for (; i < n; ++i) {
+        evap[i] = (temperature[i] / 30.0f) * (1.0f - humidity[i] / 100.0f) * 0.05f;
+    }
+    updateSoil(evap, rainfall);
+    updatePlants();
+}
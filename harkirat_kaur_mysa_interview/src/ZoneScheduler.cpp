@@ -0,0 +1,100 @@
+#include "../include/ZoneScheduler.h"
+
+ZoneScheduler::ZoneScheduler(size_t threadCount, size_t grain) : grain(grain > 0 ? grain : 1) {
+    if (threadCount == 0) threadCount = 1;
+    for (size_t i = 0; i < threadCount; ++i) queues.emplace_back(new WorkerQueue());
+    for (size_t i = 1; i < threadCount; ++i) threads.emplace_back(&ZoneScheduler::workerLoop, this, i);
+}
+
+ZoneScheduler::~ZoneScheduler() {
+    {
+        std::lock_guard<std::mutex> lock(tickMutex);
+        stopping = true;
+        generation.fetch_add(1);
+    }
+    tickStart.notify_all();
+    for (auto& t : threads) t.join();
+}
+
+void ZoneScheduler::runTick(size_t zoneCount, const std::function<void(size_t)>& fn) {
+    if (zoneCount == 0) return;
+    if (queues.size() == 1) {
+        for (size_t z = 0; z < zoneCount; ++z) fn(z);
+        return;
+    }
+    // Publish the work before any chunk becomes visible to a worker still finishing the previous tick
+    size_t chunks = (zoneCount + grain - 1) / grain;
+    work = &fn;
+    pendingRanges.store(chunks, std::memory_order_release);
+    // Give each worker a contiguous share of the chunks so zones stay on the same thread between ticks
+    size_t workers = queues.size();
+    for (size_t w = 0; w < workers; ++w) {
+        size_t firstChunk = chunks * w / workers;
+        size_t lastChunk = chunks * (w + 1) / workers;
+        std::lock_guard<std::mutex> lock(queues[w]->mutex);
+        for (size_t c = firstChunk; c < lastChunk; ++c) {
+            Range r;
+            r.begin = c * grain;
+            r.end = r.begin + grain < zoneCount ? r.begin + grain : zoneCount;
+            queues[w]->ranges.push_back(r);
+        }
+    }
+    {
+        std::lock_guard<std::mutex> lock(tickMutex);
+        generation.fetch_add(1, std::memory_order_release);
+    }
+    tickStart.notify_all();
+    drain(0);
+    // Wait for chunks still being processed by other workers
+    while (pendingRanges.load(std::memory_order_acquire) > 0) std::this_thread::yield();
+}
+
+void ZoneScheduler::workerLoop(size_t worker) {
+    unsigned long long seen = 0;
+    for (;;) {
+        // Spin briefly for the next tick before falling back to the condition variable
+        int spins = 0;
+        while (generation.load(std::memory_order_acquire) == seen && spins < 2000) {
+            ++spins;
+            std::this_thread::yield();
+        }
+        {
+            std::unique_lock<std::mutex> lock(tickMutex);
+            tickStart.wait(lock, [this, seen]() { return generation.load() != seen; });
+            seen = generation.load();
+            if (stopping) return;
+        }
+        drain(worker);
+    }
+}
+
+void ZoneScheduler::drain(size_t worker) {
+    Range r;
+    while (popLocal(worker, r) || steal(worker, r)) {
+        for (size_t z = r.begin; z < r.end; ++z) (*work)(z);
+        pendingRanges.fetch_sub(1, std::memory_order_acq_rel);
+    }
+}
+
+bool ZoneScheduler::popLocal(size_t worker, Range& range) {
+    WorkerQueue& q = *queues[worker];
+    std::lock_guard<std::mutex> lock(q.mutex);
+    if (q.ranges.empty()) return false;
+    range = q.ranges.back();
+    q.ranges.pop_back();
+    return true;
+}
+
+bool ZoneScheduler::steal(size_t thief, Range& range) {
+    size_t workers = queues.size();
+    for (size_t i = 1; i < workers; ++i) {
+        WorkerQueue& q = *queues[(thief + i) % workers];
+        std::lock_guard<std::mutex> lock(q.mutex);
+        if (q.ranges.empty()) continue;
+        range = q.ranges.front();
+        q.ranges.pop_front();
+        steals.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+    return false;
+}
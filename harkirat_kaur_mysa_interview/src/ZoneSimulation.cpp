@@ -0,0 +1,157 @@
+#include "../include/ZoneSimulation.h"
+#include "../include/Config.h"
+#include "../include/Profiler.h"
+#include "../include/PumpArbiter.h"
+
+ZoneSimulation::ZoneSimulation(const SimulationParams& p, uint32_t zoneIndex, const std::string& zoneId,
+                               const std::string& soilType, PumpBudget* budget)
+    : params(p), zoneId(zoneId), soilType(soilType), zoneIndex(zoneIndex),
+      rng(p.seed, zoneIndex, CounterRng::DisplayStream),
+      weather(rng),
+      soil(p.soilRetentionRate, p.soilDrainageFactor),
+      plant(p.plantWaterNeedPerDay, p.plantStressThreshold, p.plantAbsorptionRate),
+      pump(p.pumpFlowRate, p.pumpPowerWatts),
+      zone(&plant, &soil, &weather, &pump, budget),
+      controller(&soil, &weather, &pump, nullptr, rng) {
+    weather.setForecastEnsembleMembers(p.forecastEnsembleMembers);
+    weather.setTrace(p.weatherTrace);
+    configureController();
+}
+
+void ZoneSimulation::configureController() {
+    const SimulationParams& p = params;
+    controller.setMoistureThreshold(p.moistureThreshold);
+    controller.setCurrentWaterCost(p.waterCost);
+    controller.setConservationModeEnabled(p.conservationModeEnabled);
+    controller.setConservationWaterCostThreshold(p.conservationWaterCostThreshold);
+    controller.setConservationDroughtMoistureThreshold(p.conservationDroughtMoistureThreshold);
+    controller.setConservationMoistureThreshold(p.conservationMoistureThreshold);
+    controller.setConservationNightWindow(p.conservationNightStartHour, p.conservationNightEndHour);
+    controller.setForecastDelayEnabled(p.forecastDelayEnabled);
+    controller.setPredictiveWateringEnabled(p.predictiveWateringEnabled);
+    PlannerModel model;
+    model.retentionRate = p.soilRetentionRate;
+    model.drainageFactor = p.soilDrainageFactor;
+    model.irrigationPerTick = p.pumpFlowRate / 60.0f;
+    model.maxRunTicks = pump.getMaxRunTime();
+    model.cooldownTicks = pump.getCooldownTime();
+    model.tickSeconds = p.simulationStep;
+    model.moistureThreshold = p.moistureThreshold;
+    model.waterCost = p.waterCost;
+    model.stressPenalty = p.plannerStressPenalty;
+    model.horizonTicks = static_cast<int>(p.plannerHorizonHours * 3600.0f / p.simulationStep);
+    controller.setPlannerModel(model);
+    controller.setPlannerEnabled(p.plannerEnabled);
+}
+
+void ZoneSimulation::setPumpArbiter(PumpArbiter* a) {
+    arbiter = a;
+    if (!a) controller.setPumpPermit(true);
+}
+
+void ZoneSimulation::setSensorSlots(const SensorSlots* slots) {
+    weather.setLiveSource(slots, zoneIndex);
+    soil.setLiveSource(slots, zoneIndex);
+}
+
+ZoneStepResult ZoneSimulation::step(float secondsElapsed) {
+    ProfileScope profile(ProfileSection::ZoneStep);
+    if (live) {
+        // One acquire load per step; a new version takes effect at this step boundary
+        const ConfigVersion* latest = live->current();
+        if (latest->version != configVersion) {
+            configVersion = latest->version;
+            if (applyReloadable(latest->params, params)) configureController();
+        }
+    }
+    ZoneStepResult r;
+    r.time_s = static_cast<int>(secondsElapsed);
+    // Simulate a simple forecast: if rain is likely in the next 10s, set forecastRain
+    r.rainLikely = (weather.getRainfall() > 2.0f);
+    controller.setForecastRain(r.rainLikely);
+    if (arbiter) controller.setPumpPermit(arbiter->isGranted(zoneIndex));
+    bool wasOn = pump.isOn();
+    {
+        ProfileScope controllerProfile(ProfileSection::ControllerUpdate);
+        controller.update(secondsElapsed);
+    }
+    // Without an arbiter, every run holds a budget permit from start to stop
+    bool refused = !arbiter && !zone.settlePumpPermit(wasOn);
+    bool commanded = pump.isOn();
+    zone.update(secondsElapsed);
+    // Detect and handle weather sensor failure
+    bool weatherFailed = weather.hasFailed();
+    r.weatherFailureDetected = false;
+    r.weatherFailureReset = false;
+    if (weatherFailed && weatherFailureStart == -1) {
+        weatherFailureStart = secondsElapsed;
+        r.weatherFailureDetected = true;
+    }
+    if (weatherFailed && weatherFailureStart != -1 && secondsElapsed - weatherFailureStart > 10) {
+        weather.resetFailure();
+        weatherFailureStart = -1;
+        r.weatherFailureReset = true;
+    }
+    // Detect and handle soil sensor failure
+    bool soilFailed = (soil.getMoisture() < 0);
+    r.soilFailureDetected = false;
+    r.soilFailureReset = false;
+    if (soilFailed && soilFailureStart == -1) {
+        soilFailureStart = secondsElapsed;
+        r.soilFailureDetected = true;
+    }
+    if (soilFailed && soilFailureStart != -1 && secondsElapsed - soilFailureStart > 10) {
+        soil.resetFailure();
+        soilFailureStart = -1;
+        r.soilFailureReset = true;
+    }
+    // Use fallback values for display if failed
+    r.temperature = weatherFailed ? controller.getLastKnownTemperature() : weather.getTemperature();
+    r.humidity = weatherFailed ? controller.getLastKnownHumidity() : weather.getHumidity();
+    r.rainfall = weatherFailed ? controller.getLastKnownRainfall() : weather.getRainfall();
+    r.soilMoisture = soilFailed ? controller.getLastKnownSoilMoisture() : soil.getMoisture();
+    // Effective moisture calculation (match controller logic)
+    float noise = (rng.drawInt(r.time_s, 0, 100) - 50) / 100.0f;
+    float noisyMoisture = r.soilMoisture + noise;
+    float evap = (r.temperature / 30.0f) * (1.0f - r.humidity / 100.0f) * 0.05f;
+    r.effectiveMoisture = noisyMoisture + r.rainfall - evap;
+    r.weatherFailed = weatherFailed;
+    r.soilFailed = soilFailed;
+    // All per-second calculations now scale by simulation_step
+    r.pumpOn = pump.isOn();
+    r.pumpReason = controller.getLastReason();
+    if (!commanded && (r.pumpReason == PumpReason::Forced || r.pumpReason == PumpReason::Dry)) {
+        r.pumpReason = PumpReason::PumpLimit; // turnOn() refused during cooldown
+    }
+    if (refused) r.pumpReason = PumpReason::ZoneBudget;
+    r.conservationActive = controller.isConservationActive();
+    r.waterUsed = r.pumpOn ? params.pumpFlowRate * (params.simulationStep / 60.0f) : 0.0f; // L per step
+    r.powerUsed = r.pumpOn ? pump.getPowerWatts() * (params.simulationStep / 3600.0f) : 0.0f; // Wh per step
+    r.plantStress = plant.getStress();
+    if (arbiter) {
+        // A running pump keeps its permit; a ZoneBudget decision is a wish waiting for one
+        bool wantsPump = r.pumpOn || controller.getLastReason() == PumpReason::ZoneBudget;
+        arbiter->post(zoneIndex, wantsPump, PumpArbiter::urgency(params.moistureThreshold - r.effectiveMoisture, r.plantStress));
+    }
+    return r;
+}
+
+void ZoneSimulation::save(SnapshotWriter& out) const {
+    weather.save(out);
+    soil.save(out);
+    plant.save(out);
+    pump.save(out);
+    controller.save(out);
+    out.write(weatherFailureStart);
+    out.write(soilFailureStart);
+}
+
+void ZoneSimulation::restore(SnapshotReader& in) {
+    weather.restore(in);
+    soil.restore(in);
+    plant.restore(in);
+    pump.restore(in);
+    controller.restore(in);
+    in.read(weatherFailureStart);
+    in.read(soilFailureStart);
+}
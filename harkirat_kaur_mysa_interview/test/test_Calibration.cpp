@@ -0,0 +1,118 @@
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <sstream>
+#include "../include/Calibration.h"
+#include "../include/Plant.h"
+#include "../include/Soil.h"
+#include "../include/ZoneScheduler.h"
+
+// A bed replayed through the real Soil and Plant, with dry spells long enough to stress the plant at 4 L/min
+static ObservedSeries generate(const SoilPlantParams& p, int steps, float waterNeed = 10.0f, float flow = 4.0f) {
+    Soil soil(p.soilRetentionRate, p.soilDrainageFactor);
+    Plant plant(waterNeed, 50.0f, p.plantAbsorptionRate);
+    ObservedSeries series;
+    for (int t = 0; t < steps; ++t) {
+        float temp = 20.0f + 10.0f * std::sin(t / 700.0f);
+        float humidity = 55.0f + 20.0f * std::cos(t / 1100.0f);
+        float evap = (temp / 30.0f) * (1.0f - humidity / 100.0f) * 0.05f;
+        float rain = (t / 900) % 5 == 0 ? 0.04f : 0.0f;
+        float irrigation = (t / 400) % 7 == 3 ? flow / 60.0f : 0.0f;
+        soil.update(evap, rain, irrigation);
+        plant.update(soil.getMoisture());
+        if (t == 0) {
+            series.anchor(soil.getMoisture(), plant.getStress());
+            continue;
+        }
+        series.add(evap, rain + irrigation, soil.getMoisture(), plant.getStress());
+    }
+    return series;
+}
+
+int main() {
+    // Test 1: the kernel reproduces Soil::update and Plant::update exactly, in every SIMD lane
+    SoilPlantParams truth;
+    truth.soilRetentionRate = 0.55f;
+    truth.soilDrainageFactor = 0.35f;
+    truth.plantAbsorptionRate = 0.03f;
+    ObservedSeries series = generate(truth, 20000);
+    assert(series.stressedRows > 1000);
+    FitError exact = evaluateFit(series, truth, 10.0f);
+    assert(exact.rows == 19999 && exact.moistureSquared == 0.0 && exact.stressSquared == 0.0);
+    exact = evaluateFit(series, truth, 10.0f, 700);
+    assert(exact.rows == 19999 && exact.moistureSquared == 0.0 && exact.stressSquared == 0.0);
+    assert(evaluateFit(series, SoilPlantParams(), 10.0f).moistureSquared > 0.0);
+    SoilPlantParams batch[5] = {truth, SoilPlantParams(), truth, truth, truth}; // Four lanes and a scalar tail
+    batch[2].soilRetentionRate = 0.9f;
+    batch[3].plantAbsorptionRate = 0.0001f;
+    batch[4].soilDrainageFactor = 0.0f;
+    FitError lanes[5];
+    evaluateFitBatch(series, batch, 5, 10.0f, 700, lanes);
+    for (int k = 0; k < 5; ++k) {
+        FitError one = evaluateFit(series, batch[k], 10.0f, 700);
+        assert(lanes[k].moistureSquared == one.moistureSquared && lanes[k].stressSquared == one.stressSquared);
+    }
+
+    // Test 2: the log is read per zone; flagged rows are dropped and the replay restarts after them
+    std::istringstream csv(
+        "Timestamp,SoilMoisture (%),EffectiveMoisture (%),Temperature (°C),Humidity (%),Rainfall (mm),PumpState,"
+        "FlowRate (L/min),WaterUsed (L),PlantStress (%),SensorError,ZoneID,SoilType,PowerUsed (Wh)\n"
+        "0,40,40,30,50,0,OFF,0,0,0,FALSE,Zone1,Loam,0\n"
+        "0,70,70,30,50,0,OFF,0,0,0,FALSE,Zone2,Clay,0\n"
+        "1,41,41,30,50,0.5,ON,6,0.1,0,FALSE,Zone1,Loam,1\n"
+        "1,71,71,30,50,0.5,OFF,0,0,0,FALSE,Zone2,Clay,0\n"
+        "2,0,41,30,50,0,OFF,0,0,0,TRUE,Zone1,Loam,0\n"
+        "3,0,0,30,50,0,OFF,0,0,0,FALSE,Zone1,Loam,0\n"
+        "4,0.2,0,30,50,0.3,OFF,0,0,0,FALSE,Zone1,Loam,0\n");
+    ObservedSeries zone1;
+    std::string error;
+    assert(loadObservedSeries(csv, "", zone1, error));
+    assert(zone1.size() == 2 && zone1.stressedRows == 0);
+    assert(std::fabs(zone1.water[0] - 0.6f) < 1e-6f && std::fabs(zone1.evapotranspiration[0] - 0.025f) < 1e-6f);
+    assert(zone1.anchors.size() == 2 && zone1.anchors[0].moisture == 40.0f);
+    assert(zone1.anchors[1].index == 1 && zone1.anchors[1].moisture == 0.0f && zone1.water[1] == 0.3f);
+    csv.clear();
+    csv.seekg(0);
+    ObservedSeries zone2;
+    assert(loadObservedSeries(csv, "Zone2", zone2, error) && zone2.size() == 1 && zone2.water[0] == 0.5f);
+    std::istringstream noRain("Timestamp,SoilMoisture (%),Temperature (°C),Humidity (%)\n0,40,30,50\n");
+    assert(!loadObservedSeries(noRain, "", zone2, error) && error.find("Rainfall") != std::string::npos);
+
+    // Test 3: the fit recovers the soil parameters, and the thread count does not change the answer
+    CalibrationOptions options;
+    ZoneScheduler serial(1, 1), parallel(4, 1);
+    CalibrationResult fitted = calibrate(series, options, serial);
+    assert(fitted.fittedAbsorption && fitted.evaluations > 4 * 12 * 12 * 12);
+    assert(std::fabs(fitted.params.soilRetentionRate - truth.soilRetentionRate) < 0.01f);
+    assert(std::fabs(fitted.params.soilDrainageFactor - truth.soilDrainageFactor) < 0.01f);
+    assert(fitted.moistureRmse < 0.1);
+    CalibrationResult again = calibrate(series, options, parallel);
+    assert(again.params.soilRetentionRate == fitted.params.soilRetentionRate);
+    assert(again.params.soilDrainageFactor == fitted.params.soilDrainageFactor);
+    assert(again.params.plantAbsorptionRate == fitted.params.plantAbsorptionRate);
+    assert(again.loss == fitted.loss && again.evaluations == fitted.evaluations);
+
+    // Test 4: without stress, absorption is left where the options put it
+    options.initial.plantAbsorptionRate = 0.07f;
+    CalibrationResult soilOnly = calibrate(zone1, options, serial);
+    assert(!soilOnly.fittedAbsorption && soilOnly.params.plantAbsorptionRate == 0.07f);
+
+    // Test 5: a thirsty plant that is often stressed pins absorption down; a bed that is almost never
+    // stressed leaves it at the initial value unless the share is lowered
+    CalibrationOptions thirsty;
+    thirsty.waterNeedPerDay = 500.0f;
+    ObservedSeries stressed = generate(truth, 20000, 500.0f);
+    assert(stressed.stressedRows >= thirsty.minStressedShare * stressed.size());
+    CalibrationResult absorption = calibrate(stressed, thirsty, serial);
+    assert(absorption.fittedAbsorption);
+    assert(std::fabs(absorption.params.plantAbsorptionRate - truth.plantAbsorptionRate) < 0.001f);
+    ObservedSeries watered = generate(truth, 20000, 500.0f, 6.0f);
+    assert(watered.stressedRows > 0 && watered.stressedRows < 100);
+    CalibrationResult unfitted = calibrate(watered, thirsty, serial);
+    assert(!unfitted.fittedAbsorption && unfitted.params.plantAbsorptionRate == thirsty.initial.plantAbsorptionRate);
+    thirsty.minStressedShare = 0.0f;
+    assert(calibrate(watered, thirsty, serial).fittedAbsorption);
+
+    std::cout << "Calibration tests passed!" << std::endl;
+    return 0;
+}
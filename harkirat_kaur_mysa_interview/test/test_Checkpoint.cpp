@@ -0,0 +1,132 @@
+#include <cassert>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include "../include/Checkpoint.h"
+#include "../include/ParameterSweep.h"
+
+static bool sameStep(const ZoneStepResult& a, const ZoneStepResult& b) {
+    return a.time_s == b.time_s && a.soilMoisture == b.soilMoisture && a.effectiveMoisture == b.effectiveMoisture &&
+           a.temperature == b.temperature && a.humidity == b.humidity && a.rainfall == b.rainfall &&
+           a.pumpOn == b.pumpOn && a.pumpReason == b.pumpReason && a.plantStress == b.plantStress &&
+           a.weatherFailed == b.weatherFailed && a.soilFailed == b.soilFailed;
+}
+
+static void logStep(Logger& logger, const ZoneStepResult& r, float flowRate) {
+    logger.logSecond(r.time_s, r.soilMoisture, r.effectiveMoisture, r.temperature, r.humidity, r.rainfall, r.pumpOn,
+                     flowRate, r.waterUsed, r.plantStress, r.weatherFailed || r.soilFailed, "Zone1", "Loam", r.powerUsed);
+}
+
+int main() {
+    // A thirsty zone so the pump, its cooldown and the controller histories are all live at the checkpoint
+    SimulationParams params;
+    params.seed = 42;
+    params.plantWaterNeedPerDay = 400.0f;
+    params.soilDrainageFactor = 2.0f;
+    params.moistureThreshold = 60.0f;
+    params.conservationModeEnabled = true;
+    const int half = 20000;
+    const char* path = "test_checkpoint.mckp";
+
+    // Test 1: straight run vs run + checkpoint file + restore into fresh objects + run
+    std::vector<ZoneStepResult> straight;
+    Logger straightLogger{std::unique_ptr<LogSink>()};
+    {
+        PumpBudget budget(1);
+        ZoneSimulation zone(params, 0, "Zone1", "Loam", &budget);
+        float t = 0.0f;
+        for (int i = 0; i < 2 * half; ++i, t += params.simulationStep) {
+            straight.push_back(zone.step(t));
+            logStep(straightLogger, straight.back(), params.pumpFlowRate);
+        }
+    }
+    int pumpSteps = 0;
+    for (const ZoneStepResult& r : straight) pumpSteps += r.pumpOn;
+    assert(pumpSteps > 0 && pumpSteps < 2 * half);
+    {
+        std::vector<std::unique_ptr<ZoneSimulation>> zones;
+        PumpBudget budget(1);
+        zones.emplace_back(new ZoneSimulation(params, 0, "Zone1", "Loam", &budget));
+        Logger logger{std::unique_ptr<LogSink>()};
+        float t = 0.0f;
+        for (int i = 0; i < half; ++i, t += params.simulationStep) logStep(logger, zones[0]->step(t), params.pumpFlowRate);
+        assert(saveCheckpoint(path, captureCheckpoint(params, half, t, zones, budget, logger)));
+    }
+    Checkpoint loaded;
+    std::string error;
+    assert(loadCheckpoint(path, loaded, error));
+    assert(loaded.nextStep == half && loaded.params.seed == 42 && loaded.params.moistureThreshold == 60.0f);
+    assert(loaded.zoneIds.size() == 1 && loaded.zoneIds[0] == "Zone1" && loaded.soilTypes[0] == "Loam");
+    {
+        PumpBudget budget(loaded.maxPumps);
+        budget.setActive(loaded.activePumps);
+        ZoneSimulation zone(loaded.params, 0, loaded.zoneIds[0], loaded.soilTypes[0], &budget);
+        Logger logger{std::unique_ptr<LogSink>()};
+        assert(restoreZone(loaded, 0, zone));
+        assert(restoreLogger(loaded, logger));
+        float t = loaded.secondsElapsed;
+        for (int i = half; i < 2 * half; ++i, t += params.simulationStep) {
+            ZoneStepResult r = zone.step(t);
+            assert(sameStep(r, straight[i]));
+            logStep(logger, r, params.pumpFlowRate);
+        }
+        assert(logger.getTotalWaterUsed() == straightLogger.getTotalWaterUsed());
+        assert(logger.getTotalPowerUsed() == straightLogger.getTotalPowerUsed());
+        assert(logger.getAveragePlantStress() == straightLogger.getAveragePlantStress());
+        assert(logger.getHealthyTime() == straightLogger.getHealthyTime());
+        assert(logger.getSensorFailureEvents() == straightLogger.getSensorFailureEvents());
+    }
+
+    // Test 2: a fork with unchanged params matches the straight run's second half; a what-if differs
+    Logger secondHalf{std::unique_ptr<LogSink>()};
+    for (int i = half; i < 2 * half; ++i) logStep(secondHalf, straight[i], params.pumpFlowRate);
+    SweepResult same = runSweepSimulation(loaded.params, half, false, 1, &loaded);
+    assert(same.waterUsed == secondHalf.getTotalWaterUsed());
+    assert(same.averageStress == secondHalf.getAveragePlantStress());
+    SimulationParams whatIf = loaded.params;
+    whatIf.soilDrainageFactor = 8.0f;
+    SweepResult fork = runSweepSimulation(whatIf, half, false, 1, &loaded);
+    assert(fork.averageStress != same.averageStress);
+
+    // Test 3: truncated, zone-less and foreign files are rejected
+    std::string bytes;
+    {
+        std::ifstream in(path, std::ios::binary);
+        bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(bytes.data(), bytes.size() - 5);
+    }
+    Checkpoint bad;
+    assert(!loadCheckpoint(path, bad, error) && error.find("truncated") != std::string::npos);
+    {
+        // A zone count of 0 would leave main.cpp nothing to read the soil type from
+        Checkpoint empty = loaded;
+        empty.zoneIds.clear();
+        empty.soilTypes.clear();
+        empty.zoneStates.clear();
+        assert(saveCheckpoint(path, empty));
+    }
+    assert(!loadCheckpoint(path, bad, error) && error.find("corrupt (0 zones)") != std::string::npos);
+    {
+        std::ofstream out(path, std::ios::trunc);
+        out << "Timestamp,SoilMoisture\n";
+    }
+    assert(!loadCheckpoint(path, bad, error) && error.find("not a checkpoint") != std::string::npos);
+    assert(!loadCheckpoint("missing.mckp", bad, error));
+
+    // Test 4: a corrupt zone blob is caught on restore
+    loaded.zoneStates[0].resize(loaded.zoneStates[0].size() / 2);
+    PumpBudget budget(1);
+    ZoneSimulation zone(params, 0, "Zone1", "Loam", &budget);
+    assert(!restoreZone(loaded, 0, zone));
+    assert(!restoreZone(loaded, 1, zone));
+    std::remove(path);
+
+    std::cout << "Checkpoint tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,125 @@
+#include <cassert>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include "../include/Config.h"
+
+static const char kValid[] =
+    "plant_water_need_per_day=10.0\n"
+    "plant_stress_threshold=10.0\n"
+    "plant_absorption_rate=0.05\n"
+    "soil_retention_rate=0.8\n"
+    "soil_drainage_factor=0.2\n"
+    "moisture_threshold=100.0 # Force pump ON at start\n"
+    "pump_flow_rate=6.0\n"
+    "water_cost=0.1\n"
+    "simulation_duration=60\n"
+    "# Water Conservation Mode\n"
+    "conservation_mode_enabled=false\n"
+    "conservation_night_end_hour=6 \n"
+    "unknown_key=whatever\n";
+
+static ConfigStatus parse(const std::string& text, Config& config, std::string& error) {
+    std::istringstream in(text);
+    return parseConfig(in, config, error);
+}
+
+static void writeFile(const char* path, const std::string& text) {
+    std::ofstream out(path, std::ios::trunc);
+    out << text;
+}
+
+int main() {
+    // Test 1: typed parse with inline comments, trailing spaces, defaults and unknown keys
+    Config config;
+    std::string error;
+    assert(parse(kValid, config, error) == ConfigStatus::Ok);
+    assert(config.params.moistureThreshold == 100.0f && config.params.waterCost == 0.1f);
+    assert(config.params.conservationNightEndHour == 6 && !config.params.conservationModeEnabled);
+    assert(config.params.pumpPowerWatts == 60.0f && config.params.simulationStep == 1.0f); // Defaults
+    assert(config.simulationDuration == 60 && config.has("unknown_key") && !config.has("simulation_step"));
+
+    // Test 2: missing, malformed and out-of-range values
+    std::string text = kValid;
+    assert(parse(text.substr(text.find("plant_stress")), config, error) == ConfigStatus::MissingField);
+    assert(error.find("plant_water_need_per_day") != std::string::npos);
+    assert(parse(text + "water_cost=0.1x\n", config, error) == ConfigStatus::InvalidValue);
+    assert(error.find("line 14") != std::string::npos);
+    assert(parse(text + "soil_retention_rate=1.5\n", config, error) == ConfigStatus::InvalidValue);
+    assert(parse(text + "conservation_night_start_hour=24\n", config, error) == ConfigStatus::InvalidValue);
+    assert(parse(text + "conservation_mode_enabled=yes\n", config, error) == ConfigStatus::InvalidValue);
+    assert(parse(text + "just a line\n", config, error) == ConfigStatus::InvalidValue);
+    assert(loadConfig("missing.yaml", config, error) == ConfigStatus::CannotOpen);
+
+    // Test 3: only reloadable fields are copied
+    SimulationParams running, edited;
+    edited.moistureThreshold = 25.0f;
+    edited.soilRetentionRate = 0.1f;
+    assert(applyReloadable(edited, running));
+    assert(running.moistureThreshold == 25.0f && running.soilRetentionRate == 0.8f);
+    assert(!applyReloadable(edited, running));
+
+    // Test 4: channel versions stay valid after newer ones are published
+    ConfigChannel channel(running);
+    const ConfigVersion* first = channel.current();
+    assert(first->version == 0);
+    SimulationParams next = running;
+    next.waterCost = 2.0f;
+    assert(channel.publish(next) == 1);
+    assert(channel.current()->params.waterCost == 2.0f && first->params.waterCost == 0.1f);
+
+    // Test 5: a zone on a live channel follows a threshold change at its next step
+    SimulationParams base;
+    base.seed = 9;
+    base.moistureThreshold = 100.0f; // Waters whenever the pump allows
+    ConfigChannel live(base);
+    PumpBudget budgetA(1), budgetB(1);
+    ZoneSimulation a(base, 0, "Zone1", "Loam", &budgetA);
+    ZoneSimulation b(base, 0, "Zone1", "Loam", &budgetB);
+    b.setConfigChannel(&live);
+    SimulationParams wet = base;
+    wet.moistureThreshold = 0.0f; // Never water
+    wet.conservationModeEnabled = true;
+    wet.waterCost = 2.0f; // Conservation always on, and its night window starts after the run
+    wet.conservationNightStartHour = 22;
+    wet.conservationNightEndHour = 23;
+    bool differed = false;
+    float t = 0.0f;
+    for (int i = 0; i < 20000; ++i, t += 1.0f) {
+        if (i == 10) live.publish(wet);
+        ZoneStepResult ra = a.step(t), rb = b.step(t);
+        if (i >= 10) assert(rb.pumpReason != PumpReason::Dry);
+        differed = differed || ra.pumpReason != rb.pumpReason;
+    }
+    assert(differed);
+    assert(b.getParams().moistureThreshold == 0.0f && b.getParams().conservationModeEnabled);
+
+    // Test 6: the watcher publishes valid edits and rejects broken ones
+    const char* path = "test_config_watch.yaml";
+    writeFile(path, kValid);
+    ConfigChannel watchedChannel(base);
+    {
+        ConfigWatcher watcher(path, watchedChannel);
+        assert(watcher.start(error));
+        writeFile(path, text + "moisture_threshold=33.0\n");
+        for (int i = 0; i < 100 && watchedChannel.current()->version == 0; ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        }
+        assert(watchedChannel.current()->version == 1);
+        assert(watchedChannel.current()->params.moistureThreshold == 33.0f);
+        writeFile(path, text + "moisture_threshold=abc\n");
+        for (int i = 0; i < 100 && watcher.getRejectedCount() == 0; ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        }
+        assert(watcher.getRejectedCount() == 1 && watchedChannel.current()->version == 1);
+        watcher.stop();
+    }
+    std::remove(path);
+
+    std::cout << "Config tests passed!" << std::endl;
+    return 0;
+}
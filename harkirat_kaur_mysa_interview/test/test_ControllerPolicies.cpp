@@ -0,0 +1,81 @@
+#include <cassert>
+#include <iostream>
+#include "../include/Soil.h"
+#include "../include/WeatherSensor.h"
+#include "../include/WaterPump.h"
+#include "../include/IrrigationController.h"
+#include "../include/Config.h"
+#include "../include/ZoneSimulation.h"
+
+static RollingWindow filled(size_t capacity, float first, float step) {
+    RollingWindow w(capacity);
+    for (size_t i = 0; i < capacity; ++i) w.push(first + step * i);
+    return w;
+}
+
+int main() {
+    // Test 1: threshold policies
+    RollingWindow dryRain = filled(24, 0.0f, 0.0f);
+    RollingWindow dryMoisture = filled(24, 20.0f, 0.0f);
+    RollingWindow falling = filled(24, 50.0f, -1.0f);
+    RollingWindow rising = filled(24, 20.0f, 1.0f);
+    assert(FixedThreshold::threshold(40.0f, dryRain, dryMoisture, 0.5f, 2.5f) == 40.0f);
+    assert(PredictiveWatering::threshold(40.0f, dryRain, dryMoisture, 0.5f, 2.5f) == 35.0f); // Dry spell
+    assert(PredictiveWatering::threshold(40.0f, dryRain, falling, 0.5f, 2.5f) == 42.5f);     // Drying out
+    assert(PredictiveWatering::threshold(40.0f, dryRain, rising, 0.5f, 2.5f) == 37.5f);      // Wetting up
+    assert(PredictiveWatering::threshold(40.0f, dryRain, falling, 0.0f, 2.5f) == 40.0f);     // Trend check off
+    RollingWindow a(4), b(4);
+    PredictiveWatering::record(a, b, 7200, 1.0f, 30.0f);
+    PredictiveWatering::record(a, b, 7201, 1.0f, 30.0f);
+    FixedThreshold::record(a, b, 10800, 1.0f, 30.0f);
+    assert(a.size() == 1 && b.size() == 1);
+
+    // Test 2: conservation policies, including a night window that crosses midnight
+    assert(!NoConservation::active(0.0f, 20.0f, 9.0f, 0.5f) && NoConservation::allowWatering(12 * 3600, 22, 6));
+    assert(NightConservation::active(10.0f, 20.0f, 0.1f, 0.5f));  // Drought
+    assert(NightConservation::active(50.0f, 20.0f, 0.9f, 0.5f));  // Expensive water
+    assert(!NightConservation::active(50.0f, 20.0f, 0.1f, 0.5f));
+    assert(NightConservation::allowWatering(23 * 3600, 22, 6) && NightConservation::allowWatering(86400 + 3600, 22, 6));
+    assert(!NightConservation::allowWatering(12 * 3600, 22, 6));
+    assert(NightConservation::allowWatering(3 * 3600, 2, 5) && !NightConservation::allowWatering(5 * 3600, 2, 5));
+
+    // Test 3: the controller switches pipelines at runtime; disabled features never decide
+    Soil soil(0.8f, 0.2f);
+    for (int i = 0; i < 200; ++i) soil.update(10.0f, 0.0f, 0.0f); // Dry soil
+    assert(soil.getMoisture() < 20.0f);
+    WeatherSensor weather(CounterRng(3, 0));
+    WaterPump pump(6.0f, 60.0f);
+    pump.setCooldownTime(0); // Turned off before each update so only the policies decide
+    IrrigationController controller(&soil, &weather, &pump, nullptr, CounterRng(3, 0));
+    controller.setMoistureThreshold(40.0f);
+    controller.setRainForecastThreshold(-1.0f); // Any forecast delays
+    controller.update(100);
+    assert(controller.getLastReason() == PumpReason::RainForecast && !pump.isOn());
+    controller.setForecastDelayEnabled(false);
+    pump.turnOff();
+    controller.update(101);
+    assert(controller.getLastReason() == PumpReason::Dry && pump.isOn());
+    controller.setConservationModeEnabled(true);
+    pump.turnOff();
+    controller.update(12 * 3600); // Drought at noon: outside the default 22-6 window
+    assert(controller.isConservationActive() && controller.getLastReason() == PumpReason::NightWindow);
+    pump.turnOff();
+    controller.update(23 * 3600);
+    assert(controller.getLastReason() == PumpReason::Dry);
+    controller.setConservationModeEnabled(false);
+    assert(!controller.isConservationActive());
+    pump.turnOff();
+    controller.update(12 * 3600 + 1);
+    assert(!controller.isConservationActive() && controller.getLastReason() == PumpReason::Dry);
+
+    // Test 4: config keys select the features
+    SimulationParams params;
+    std::string error;
+    assert(params.predictiveWateringEnabled && params.forecastDelayEnabled);
+    assert(setSimulationParam(params, "predictive_watering_enabled", "false", error) && !params.predictiveWateringEnabled);
+    assert(setSimulationParam(params, "forecast_delay_enabled", "0", error) && !params.forecastDelayEnabled);
+    assert(setSimulationParam(params, "forecast_delay_enabled", "true", error) && params.forecastDelayEnabled);
+
+    std::cout << "ControllerPolicies tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,42 @@
+#include <cassert>
+#include <iostream>
+#include "../include/CounterRng.h"
+#include "../include/WeatherSensor.h"
+
+int main() {
+    CounterRng a(42, 0), b(42, 0), otherZone(42, 1), otherSeed(43, 0);
+    // Pure function of (seed, zone, stream, tick, index)
+    for (uint64_t t = 0; t < 1000; ++t) {
+        assert(a.draw(t, 0) == b.draw(t, 0));
+        assert(a.draw(t, 3) == b.draw(t, 3));
+    }
+    int sameZone = 0, sameSeed = 0, sameStream = 0;
+    CounterRng stream = a.withStream(CounterRng::WeatherStream);
+    for (uint64_t t = 0; t < 10000; ++t) {
+        if (a.draw(t) == otherZone.draw(t)) ++sameZone;
+        if (a.draw(t) == otherSeed.draw(t)) ++sameSeed;
+        if (a.draw(t) == stream.draw(t)) ++sameStream;
+    }
+    assert(sameZone == 0 && sameSeed == 0 && sameStream == 0);
+    // drawInt is roughly uniform
+    int buckets[10] = {0};
+    for (uint64_t t = 0; t < 100000; ++t) ++buckets[a.drawInt(t, 0, 10)];
+    for (int i = 0; i < 10; ++i) {
+        std::cout << "Bucket " << i << ": " << buckets[i] << std::endl;
+        assert(buckets[i] > 9500 && buckets[i] < 10500);
+    }
+    // Sensors with the same seed produce the same weather, no matter what other zones draw in between
+    WeatherSensor s1(CounterRng(7, 3)), other(CounterRng(7, 4)), s2(CounterRng(7, 3));
+    for (int t = 0; t < 20000; ++t) {
+        s1.update(t);
+        other.update(t);
+        for (int i = 0; i < t % 5; ++i) other.getRainForecast(12); // Would have shifted a shared std::rand()
+        s2.update(t);
+        assert(s1.getTemperature() == s2.getTemperature());
+        assert(s1.getRainfall() == s2.getRainfall());
+        assert(s1.getRainForecast(6) == s2.getRainForecast(6));
+        if (s1.hasFailed()) { s1.resetFailure(); s2.resetFailure(); }
+    }
+    std::cout << "CounterRng tests passed!" << std::endl;
+    return 0;
+}
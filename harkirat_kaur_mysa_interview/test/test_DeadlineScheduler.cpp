@@ -0,0 +1,76 @@
+#include <cassert>
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include "../include/DeadlineScheduler.h"
+
+// Drives the grid from a simulated clock: work() advances it, and a sleep wakes `wakeLatencyNs` late
+class FakeClockScheduler : public DeadlineScheduler {
+public:
+    using DeadlineScheduler::DeadlineScheduler;
+    int64_t now = 0;
+    int64_t wakeLatencyNs = 0;
+    void work(double ms) { now += static_cast<int64_t>(ms * 1e6); }
+    double nowMs() const { return now / 1e6; }
+protected:
+    int64_t nowNs() const override { return now; }
+    void sleepUntil(int64_t deadlineNs) override {
+        if (deadlineNs > now) now = deadlineNs;
+        now += wakeLatencyNs;
+    }
+};
+
+int main() {
+    // Test 1: work inside the period does not add up into drift, and every period's lateness is recorded
+    FakeClockScheduler paced(0.010);
+    paced.start();
+    for (int i = 0; i < 40; ++i) {
+        paced.wakeLatencyNs = i % 10 == 9 ? 300000 : 20000; // Every tenth wake-up is 0.3 ms late
+        paced.work(3.0); // The step's work
+        assert(paced.waitForNextPeriod());
+    }
+    assert(paced.nowMs() == 400.3); // A sleep after the work would end at 40 * 13 ms = 520 ms
+    assert(paced.getPeriods() == 40 && paced.getOverruns() == 0);
+    assert(paced.getBucketCount(0) == 36 && paced.getBucketCount(2) == 4);
+    assert(paced.latenessPercentileMs(0.5) == 0.05);
+    assert(paced.latenessPercentileMs(0.99) == 0.3 && paced.getMaxLatenessMs() == 0.3);
+
+    // Test 2: catch-up keeps the original grid after an overrun
+    FakeClockScheduler catchUp(0.005, OverrunPolicy::CatchUp);
+    catchUp.start();
+    for (int i = 0; i < 20; ++i) {
+        if (i == 5) catchUp.work(22.0); // Ends at 47 ms: misses the deadlines at 30, 35, 40 and 45 ms
+        catchUp.waitForNextPeriod();
+    }
+    assert(catchUp.getOverruns() == 4 && catchUp.getRealignments() == 0);
+    assert(catchUp.nowMs() == 100.0);
+    assert(catchUp.getMaxLatenessMs() == 17.0);
+
+    // Test 3: realign starts a new grid, so the overrun's time is not made up
+    FakeClockScheduler realign(0.005, OverrunPolicy::Realign);
+    realign.start();
+    for (int i = 0; i < 20; ++i) {
+        if (i == 5) realign.work(22.0);
+        realign.waitForNextPeriod();
+    }
+    assert(realign.getOverruns() == 1 && realign.getRealignments() == 1);
+    assert(realign.nowMs() == 117.0); // New grid from 47 ms; catch-up would finish at 100 ms
+
+    // Test 4: the histogram line names every bucket
+    std::ostringstream line;
+    line.setf(std::ios::fixed);
+    line.precision(1);
+    realign.printJitter(line);
+    assert(line.str().find("<0.05ms ") == 0 && line.str().find(">=100ms ") != std::string::npos);
+
+    // Test 5: the real clock sleeps until the deadlines (a busy host can only make it later)
+    DeadlineScheduler real(0.002);
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    real.start();
+    for (int i = 0; i < 10; ++i) real.waitForNextPeriod();
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    assert(ms >= 19.9 && real.getPeriods() == 10);
+
+    std::cout << "DeadlineScheduler tests passed!" << std::endl;
+    return 0;
+}
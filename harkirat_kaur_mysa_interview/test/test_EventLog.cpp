@@ -0,0 +1,101 @@
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "../include/EventLog.h"
+
+// Keeps expanded records in memory
+class CaptureSink : public LogSink {
+public:
+    std::vector<LogRecord> rows;
+    std::vector<std::string> names;
+    void defineName(uint16_t id, const std::string& name) override {
+        if (names.size() <= id) names.resize(id + 1);
+        names[id] = name;
+    }
+    void write(const LogRecord& record) override { rows.push_back(record); }
+    void flush() override {}
+};
+
+static ZoneStepResult makeStep(int t, bool pumpOn, bool weatherFailed, float moisture) {
+    ZoneStepResult r = ZoneStepResult();
+    r.time_s = t;
+    r.soilMoisture = moisture;
+    r.effectiveMoisture = moisture + 1.0f;
+    r.temperature = 20.0f;
+    r.humidity = 60.0f;
+    r.rainfall = 0.0f;
+    r.pumpOn = pumpOn;
+    r.pumpReason = pumpOn ? PumpReason::Dry : PumpReason::MoistureOk;
+    r.weatherFailed = weatherFailed;
+    r.plantStress = 1.0f;
+    return r;
+}
+
+int main() {
+    const char* path = "test_events.mevt";
+    const int steps = 2000;
+    std::vector<ZoneStepResult> zoneA, zoneB;
+    {
+        EventLogWriter writer(path, 100);
+        assert(writer.isOpen());
+        writer.declareZone("ZoneA", "Loam", 6.0f, 60.0f, 1.0f);
+        writer.declareZone("ZoneB", "Clay", 4.0f, 30.0f, 1.0f);
+        for (int t = 0; t < steps; ++t) {
+            // ZoneA: pump on for 0-599 and 1500-1699, a weather failure at 800-811, moisture a linear ramp
+            zoneA.push_back(makeStep(t, t < 600 || (t >= 1500 && t < 1700), t >= 800 && t < 812, 20.0f + 0.01f * t));
+            zoneB.push_back(makeStep(t, false, false, 50.0f));
+            writer.record(0, t, zoneA.back());
+            writer.record(1, t, zoneB.back());
+        }
+        writer.finish(steps);
+        assert(writer.getEventCount() == 5); // 3 pump + 2 sensor transitions
+        assert(writer.getKeyframeCount() < 60);
+    }
+    std::ifstream in(path);
+    CaptureSink sink;
+    std::string error;
+    assert(expandEventLog(in, sink, error));
+    assert(sink.rows.size() == 2 * steps);
+    for (int t = 0; t < steps; ++t) {
+        for (int z = 0; z < 2; ++z) {
+            const LogRecord& r = sink.rows[2 * t + z];
+            const ZoneStepResult& s = z == 0 ? zoneA[t] : zoneB[t];
+            assert(r.time_s == t);
+            assert(sink.names[r.zone_id] == (z == 0 ? "ZoneA" : "ZoneB"));
+            assert(sink.names[r.soil_type] == (z == 0 ? "Loam" : "Clay"));
+            // Discrete state and the values derived from it are exact
+            assert(r.pump_on == s.pumpOn);
+            assert(r.sensor_error == s.weatherFailed);
+            float flow = z == 0 ? 6.0f : 4.0f;
+            assert(r.flow_rate == flow);
+            assert(r.water_used == (s.pumpOn ? flow * (1.0f / 60.0f) : 0.0f)); // Same expression as ZoneSimulation
+            // A linear series survives keyframe interpolation
+            assert(std::fabs(r.soil_moisture - s.soilMoisture) < 1e-3f);
+            assert(std::fabs(r.effective_moisture - s.effectiveMoisture) < 1e-3f);
+        }
+    }
+    // The pump transitions carry their reason
+    std::ifstream text(path);
+    std::string line, log;
+    while (std::getline(text, line)) log += line + "\n";
+    assert(log.find("P,600,0,0,moisture_ok\n") != std::string::npos);
+    assert(log.find("P,1500,0,1,dry\n") != std::string::npos);
+    assert(log.find("S,812,0,weather,0\n") != std::string::npos);
+
+    // Malformed logs are rejected
+    std::istringstream noHeader("Z,0,Zone1,Loam,6,60,1\nE,1\n");
+    assert(!expandEventLog(noHeader, sink, error));
+    std::istringstream noEnd("# mysa-events v1\nZ,0,Zone1,Loam,6,60,1\nK,0,0,1,0,0,0,1,1,1,1,1,1\n");
+    assert(!expandEventLog(noEnd, sink, error));
+    std::istringstream badZone("# mysa-events v1\nK,0,3,1,0,0,0,1,1,1,1,1,1\nE,1\n");
+    assert(!expandEventLog(badZone, sink, error));
+    std::cout << "Rejected: " << error << std::endl;
+    std::remove(path);
+    std::cout << "EventLog tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,72 @@
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include "../include/EventSimulation.h"
+#include "../include/ZoneSimulation.h"
+#include "../include/Logger.h"
+
+static bool near(float a, float b, float tolerance) {
+    return std::fabs(a - b) <= tolerance;
+}
+
+int main() {
+    // Closed-form spans reproduce exact stepping of the same expected-weather model,
+    // including a dry soil where plant stress rises, saturates and recovers
+    SimulationParams dry;
+    dry.soilRetentionRate = 0.02f;
+    dry.plantAbsorptionRate = 0.00002f;
+    dry.plantWaterNeedPerDay = 10.0f;
+    SimulationParams wet; // config.yaml defaults
+    const SimulationParams cases[] = {dry, wet};
+    for (const SimulationParams& p : cases) {
+        Logger exactLog{std::unique_ptr<LogSink>()}, eventLog{std::unique_ptr<LogSink>()};
+        EventSimulation exact(p), events(p);
+        exact.setSkipping(false);
+        EventRunStats exactStats = exact.run(10 * 86400, exactLog);
+        EventRunStats eventStats = events.run(10 * 86400, eventLog);
+        std::cout << "Exact ticks: " << exactStats.exactTicks << " vs " << eventStats.exactTicks
+                  << " (+" << eventStats.skippedTicks << " skipped), average stress "
+                  << exactLog.getAveragePlantStress() << " vs " << eventLog.getAveragePlantStress()
+                  << ", efficiency " << exactLog.getWaterEfficiency() << " vs " << eventLog.getWaterEfficiency() << std::endl;
+        assert(exactStats.skippedTicks == 0);
+        assert(eventStats.exactTicks + eventStats.skippedTicks == 10 * 86400);
+        assert(eventStats.exactTicks < 10 * 86400 / 30); // Every pump run adds its start and its heavy-rain stop
+        assert(near(exact.getSoilMoisture(), events.getSoilMoisture(), 0.05f));
+        assert(near(exact.getPlantStress(), events.getPlantStress(), 0.05f));
+        assert(near(exactLog.getAveragePlantStress(), eventLog.getAveragePlantStress(), 0.05f));
+        assert(near(exactLog.getWaterEfficiency(), eventLog.getWaterEfficiency(), 0.05f));
+        // The exact run adds 0.1 L per tick to a float total, which drifts by up to 1.6% per add above 32768 L
+        assert(near(exactLog.getTotalWaterUsed(), eventLog.getTotalWaterUsed(), 0.01f * exactLog.getTotalWaterUsed() + 1e-4f));
+        assert(exactLog.getSensorFailureEvents() == eventLog.getSensorFailureEvents());
+    }
+
+    // Same summary as the tick loop within the documented tolerance, on a zone that waters after every
+    // sensor failure and has its runs cut short by heavy rain and delayed by the forecast
+    SimulationParams params;
+    params.seed = 11;
+    const int duration = 3 * 86400;
+    Logger tickLog{std::unique_ptr<LogSink>()}, eventLog{std::unique_ptr<LogSink>()};
+    {
+        ZoneSimulation zone(params, 0, "Zone1");
+        for (int t = 0; t < duration; ++t) {
+            ZoneStepResult r = zone.step(static_cast<float>(t));
+            tickLog.logSecond(r.time_s, r.soilMoisture, r.effectiveMoisture, r.temperature, r.humidity, r.rainfall,
+                              r.pumpOn, params.pumpFlowRate, r.waterUsed, r.plantStress,
+                              r.weatherFailed || r.soilFailed, "Zone1", "Loam", r.powerUsed);
+        }
+    }
+    EventSimulation events(params);
+    events.run(duration, eventLog);
+    std::cout << "Tick vs event: water " << tickLog.getTotalWaterUsed() << "/" << eventLog.getTotalWaterUsed()
+              << " L, stress " << tickLog.getAveragePlantStress() << "/" << eventLog.getAveragePlantStress()
+              << "%, efficiency " << tickLog.getWaterEfficiency() << "/" << eventLog.getWaterEfficiency()
+              << "%, failures " << tickLog.getSensorFailureEvents() << "/" << eventLog.getSensorFailureEvents() << std::endl;
+    assert(tickLog.getTotalWaterUsed() > 100.0f);
+    assert(near(tickLog.getTotalWaterUsed(), eventLog.getTotalWaterUsed(), 0.03f * tickLog.getTotalWaterUsed()));
+    assert(near(tickLog.getTotalPowerUsed(), eventLog.getTotalPowerUsed(), 0.03f * tickLog.getTotalPowerUsed()));
+    assert(near(tickLog.getAveragePlantStress(), eventLog.getAveragePlantStress(), 1.0f));
+    assert(near(tickLog.getWaterEfficiency(), eventLog.getWaterEfficiency(), 1.0f));
+    assert(tickLog.getSensorFailureEvents() == eventLog.getSensorFailureEvents()); // Replayed from the same seed
+    std::cout << "EventSimulation tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,120 @@
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include "../include/IrrigationPlanner.h"
+#include "../include/ZoneSimulation.h"
+
+static bool near(float a, float b) { return std::fabs(a - b) < 1e-3f; }
+
+int main() {
+    // Test 1: phases are linear until the clamp; the deficit is the area below the threshold
+    float deficit = 0.0f;
+    assert(near(IrrigationPlanner::advance(30.0f, 0.1f, 100, 40.0f, deficit), 40.0f) && near(deficit, 500.0f));
+    deficit = 0.0f;
+    assert(IrrigationPlanner::advance(90.0f, 0.1f, 200, 40.0f, deficit) == 100.0f && deficit == 0.0f);
+    deficit = 0.0f;
+    assert(IrrigationPlanner::advance(10.0f, -0.1f, 200, 40.0f, deficit) == 0.0f && near(deficit, 3500.0f + 4000.0f));
+    deficit = 0.0f;
+    assert(near(IrrigationPlanner::advance(50.0f, -0.1f, 200, 40.0f, deficit), 30.0f) && near(deficit, 500.0f));
+
+    // Test 2: a stage holds one run and the cooldown, unless the horizon needs longer stages
+    PlannerModel model; // Defaults: 600 s runs, 300 s cooldown, 12 h horizon at 1 s steps
+    IrrigationPlanner planner;
+    planner.configure(model);
+    assert(planner.getStageTicks() == 900 && planner.getStageCount() == 48);
+    PlannerModel shortRuns = model;
+    shortRuns.maxRunTicks = 10;
+    shortRuns.cooldownTicks = 0;
+    IrrigationPlanner fine;
+    fine.configure(shortRuns);
+    assert(fine.getStageTicks() == 225 && fine.getStageCount() == IrrigationPlanner::kMaxStages);
+
+    // Test 3: dry soil is watered, wet soil and soil that forecast rain will wet are not, and a cooling pump waits
+    std::vector<PlannerStageInput> dry(48), wet(48);
+    for (int k = 0; k < 48; ++k) {
+        dry[k].evapotranspiration = 0.02f;
+        wet[k] = dry[k];
+        if (k < 4) wet[k].rain = 0.2f; // An hour of rain
+    }
+    planner.plan(0, dry.data());
+    assert(planner.covers(47) && !planner.covers(48));
+    int run = planner.decide(0, 0, 20.0f, true);
+    assert(run > 0 && run <= model.maxRunTicks);
+    assert(planner.decide(0, 0, 90.0f, true) == 0);
+    assert(planner.decide(0, 0, 20.0f, false) == 0);
+    assert(planner.decide(0, 800, 20.0f, true) == 0); // No room left for a run and its cooldown
+    IrrigationPlanner rainy;
+    rainy.configure(model);
+    rainy.plan(0, wet.data());
+    assert(rainy.decide(0, 0, 35.0f, true) == 0);
+    PlannerModel expensive = model;
+    expensive.waterCost = 1000.0f;
+    IrrigationPlanner thrifty;
+    thrifty.configure(expensive);
+    thrifty.plan(0, dry.data());
+    assert(thrifty.decide(0, 0, 20.0f, true) == 0);
+
+    // Test 4: an hourly re-plan builds only the newly reached stages and matches a cold plan
+    std::vector<PlannerStageInput> later(dry.begin() + 4, dry.end());
+    later.resize(48, dry[0]);
+    later[47].rain = 0.05f;
+    planner.plan(4, later.data());
+    assert(planner.getStats().plans == 2 && planner.getStats().tablesBuilt == 48 + 4 && planner.getStats().tablesReused == 44);
+    IrrigationPlanner cold;
+    cold.configure(model);
+    cold.plan(4, later.data());
+    for (float m = 0.0f; m <= 100.0f; m += 7.5f) {
+        assert(cold.expectedCost(m) == planner.expectedCost(m));
+        assert(cold.decide(5, 0, m, true) == planner.decide(5, 0, m, true));
+    }
+    planner.configure(expensive); // A new model drops the tables
+    planner.plan(4, later.data());
+    assert(planner.getStats().tablesBuilt == 48 + 4 + 48);
+
+    // Test 5: in a zone, runs respect the pump limits and a restored checkpoint follows the same schedule
+    SimulationParams params;
+    params.seed = 7;
+    params.plannerEnabled = true;
+    params.plannerHorizonHours = 6;
+    PumpBudget budget(1);
+    ZoneSimulation zone(params, 0, "Zone1", "Loam", &budget);
+    std::vector<bool> pumpOn;
+    int onRun = 0, offRun = 0, runs = 0;
+    std::string state;
+    for (int t = 0; t < 4 * 3600; ++t) {
+        ZoneStepResult r = zone.step(static_cast<float>(t));
+        pumpOn.push_back(r.pumpOn);
+        if (t >= 5) assert(r.pumpReason == PumpReason::Planned || r.pumpReason == PumpReason::PumpLimit);
+        if (r.pumpOn) {
+            if (onRun == 0 && t > 0) {
+                assert(offRun >= 300); // Cooldown between runs
+                ++runs;
+            }
+            ++onRun;
+            offRun = 0;
+            assert(onRun <= 600 && budget.getActive() == 1);
+        } else {
+            onRun = 0;
+            ++offRun;
+            assert(budget.getActive() == 0);
+        }
+        if (t == 5000) { // Mid-stage, mid-hour
+            std::ostringstream out;
+            SnapshotWriter writer(out);
+            zone.save(writer);
+            state = out.str();
+        }
+    }
+    assert(runs > 0);
+    ZoneSimulation resumed(params, 0, "Zone1", "Loam", &budget);
+    std::istringstream in(state);
+    SnapshotReader reader(in);
+    resumed.restore(reader);
+    budget.setActive(pumpOn[5000] ? 1 : 0);
+    for (int t = 5001; t < 4 * 3600; ++t) assert(resumed.step(static_cast<float>(t)).pumpOn == pumpOn[t]);
+
+    std::cout << "IrrigationPlanner tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,128 @@
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "../include/LogIndex.h"
+
+static LogRecord makeRecord(int time_s, uint16_t zone, float moisture, float stress, bool pumpOn) {
+    LogRecord r = LogRecord();
+    r.time_s = time_s;
+    r.soil_moisture = moisture;
+    r.effective_moisture = moisture;
+    r.temp = 20.0f;
+    r.humidity = 50.0f;
+    r.plant_stress = stress;
+    r.zone_id = zone;
+    r.soil_type = 2;
+    r.pump_on = pumpOn;
+    return r;
+}
+
+// Zone1 waters during hour 30 only; Zone2 dries out after day 1; two rows (one per zone) per minute for 2 days
+static void writeLog(const char* logPath, const char* indexPath) {
+    CsvLogSink csv(logPath);
+    assert(csv.enableIndex(indexPath, 100));
+    csv.defineName(0, "Zone1");
+    csv.defineName(1, "Zone2");
+    csv.defineName(2, "Loam");
+    for (int t = 0; t < 2 * 86400; t += 60) {
+        bool watering = t >= 30 * 3600 && t < 31 * 3600;
+        csv.write(makeRecord(t, 0, watering ? 45.0f : 35.0f, 5.0f, watering));
+        csv.write(makeRecord(t, 1, t < 86400 ? 40.0f : 12.34f, t < 86400 ? 0.0f : 60.0f, false));
+    }
+    csv.flush();
+}
+
+static std::vector<std::string> run(const MappedFile& log, const LogIndex* index, const LogQuery& query,
+                                    LogQueryStats& stats) {
+    std::vector<std::string> rows;
+    std::string error;
+    bool ok = queryLog(log.data(), log.size(), index, query,
+                       [&rows](const LogRow&, const char* line, size_t length) { rows.push_back(std::string(line, length)); },
+                       stats, error);
+    assert(ok);
+    return rows;
+}
+
+int main() {
+    const char* logPath = "test_logindex.csv";
+    const char* indexPath = "test_logindex.csv.idx";
+    writeLog(logPath, indexPath);
+
+    // Test 1: the index tiles the rows in blocks of 100 with their summaries
+    LogIndex index;
+    std::string error;
+    assert(index.load(indexPath, error));
+    const std::vector<LogIndexBlock>& blocks = index.getBlocks();
+    assert(blocks.size() == 58 && blocks.back().rows == 5760 - 57 * 100 && index.isAscending());
+    assert(blocks[0].offset == std::strlen(CsvLogSink::header()) + 1 && blocks[0].minTime == 0 && blocks[0].maxTime == 49 * 60);
+    assert(blocks[0].zones == 3 && blocks[0].pumpZones == 0 && blocks[0].minMoisture == 35.0f && blocks[0].maxMoisture == 40.0f);
+    assert(index.zoneMask("Zone2") == 2 && index.zoneMask("Zone9") == 0);
+    MappedFile log;
+    assert(log.open(logPath, error));
+    assert(blocks.back().offset + blocks.back().length == log.size() && index.getCoveredBytes() == log.size());
+
+    // Test 2: rows parse back to the logged values
+    const char* firstRow = log.data() + blocks[0].offset;
+    LogRow row;
+    assert(parseLogRow(firstRow, static_cast<const char*>(std::memchr(firstRow, '\n', 200)), row));
+    assert(row.time == 0 && row.moisture == 35.0f && !row.pumpOn && std::string(row.zone, row.zoneLength) == "Zone1");
+    const char* truncated = "2025-07-01 00:00:00,1.0,1.0";
+    assert(!parseLogRow(truncated, truncated + std::strlen(truncated), row));
+
+    // Test 3: indexed queries return exactly the rows a full scan does, while skipping blocks
+    LogQuery pump;
+    pump.zone = "Zone1";
+    pump.pump = 1;
+    LogQueryStats indexed, full;
+    std::vector<std::string> fast = run(log, &index, pump, indexed);
+    assert(fast == run(log, nullptr, pump, full));
+    assert(fast.size() == 60 && fast[0].find("2025-07-02 06:00:00") == 0 && fast.back().find("2025-07-02 06:59:00") == 0);
+    assert(indexed.blocksScanned <= 3 && indexed.rowsScanned < full.rowsScanned / 10);
+    LogQuery window;
+    window.zone = "Zone2";
+    window.from = 86400 + 3600;
+    window.to = 86400 + 7200;
+    fast = run(log, &index, window, indexed);
+    assert(fast == run(log, nullptr, window, full) && fast.size() == 60 && indexed.blocksScanned <= 3);
+    // Rounded to 12.3 in the log: a bound just under it must not skip the blocks summarised as 12.34
+    LogQuery dry;
+    dry.moistureBelow = 12.31f;
+    dry.stressAbove = 59.9f;
+    fast = run(log, &index, dry, indexed);
+    assert(fast == run(log, nullptr, dry, full) && fast.size() == 1440);
+    assert(indexed.blocksScanned == 30); // The blocks holding day 2
+    LogQuery nobody;
+    nobody.zone = "Zone9";
+    assert(run(log, &index, nobody, indexed).empty() && indexed.blocksScanned == 0 && indexed.rowsScanned == 0);
+
+    // Test 4: rows appended after the index are scanned in full; an index of another log is refused
+    {
+        std::ofstream append(logPath, std::ios::app);
+        append << "2025-07-03 00:00:00,50.0,50.0,20.0,50.0,0.0,ON,6.0,0.1,5.0,FALSE,Zone1,Loam,0.02\n";
+    }
+    MappedFile grown;
+    assert(grown.open(logPath, error));
+    std::vector<std::string> rows = run(grown, &index, pump, indexed);
+    assert(rows.size() == 61 && indexed.bytesScanned < grown.size() / 10);
+    {
+        CsvLogSink other("test_logindex_other.csv");
+        other.defineName(0, "Zone1");
+        other.write(makeRecord(0, 0, 1.0f, 1.0f, true));
+        other.flush();
+    }
+    MappedFile otherLog;
+    assert(otherLog.open("test_logindex_other.csv", error));
+    LogQueryStats stats;
+    assert(!queryLog(otherLog.data(), otherLog.size(), &index, pump, [](const LogRow&, const char*, size_t) {}, stats, error));
+    assert(!index.load("test_logindex_other.csv", error));
+    std::remove(logPath);
+    std::remove(indexPath);
+    std::remove("test_logindex_other.csv");
+
+    std::cout << "LogIndex tests passed!" << std::endl;
+    return 0;
+}
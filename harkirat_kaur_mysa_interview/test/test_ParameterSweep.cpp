@@ -0,0 +1,74 @@
+#include <cassert>
+#include <iostream>
+#include <sstream>
+#include "../include/ParameterSweep.h"
+#include "../include/ZoneScheduler.h"
+
+int main() {
+    std::istringstream text(
+        "# grid x random x seeds\n"
+        "moisture_threshold=30:50:10\n"
+        "pump_flow_rate=4, 8\n"
+        "conservation_moisture_threshold=~25:40\n"
+        "samples=3\n"
+        "seeds=2\n");
+    SweepSpec spec;
+    std::string error;
+    assert(parseSweepSpec(text, spec, error));
+    assert(spec.axes.size() == 3 && spec.axes[0].values.size() == 3 && spec.axes[1].values.size() == 2);
+
+    SimulationParams base;
+    base.seed = 5;
+    std::vector<SweepRun> runs = expandSweep(spec, base);
+    std::cout << "Runs: " << runs.size() << " (3 x 2 grid x 3 samples x 2 seeds)" << std::endl;
+    assert(runs.size() == 36);
+    assert(runs[0].params.moistureThreshold == 30.0f && runs[0].params.pumpFlowRate == 4.0f);
+    assert(runs[35].params.moistureThreshold == 50.0f && runs[35].params.pumpFlowRate == 8.0f);
+    assert(runs[0].params.seed == 5 && runs[1].params.seed == 6);
+    for (const SweepRun& run : runs) {
+        assert(run.params.conservationMoistureThreshold >= 25.0f && run.params.conservationMoistureThreshold <= 40.0f);
+    }
+    // Random draws are reproducible from the base seed
+    std::vector<SweepRun> again = expandSweep(spec, base);
+    for (size_t i = 0; i < runs.size(); ++i) assert(again[i].values == runs[i].values);
+
+    // Bad specs are rejected with the line number
+    std::istringstream unknown("moisture_threshold=30\nnot_a_key=1\n");
+    SweepSpec badSpec;
+    assert(!parseSweepSpec(unknown, badSpec, error));
+    std::cout << "Rejected: " << error << std::endl;
+    assert(error.find("line 2") == 0);
+    // Every value gets config.yaml's parse and range check: out of range, trailing junk, a bad grid
+    // end, an integer key given a fraction, and a random range reaching past the key's limit
+    const char* invalid[] = {"soil_drainage_factor=8\n", "soil_retention_rate=0.5,abc\n", "soil_retention_rate=0.5x\n",
+                             "moisture_threshold=30:50x:10\n", "planner_horizon_hours=1:3:0.5\n",
+                             "plant_absorption_rate=~0.5:2\n", "planner_horizon_hours=~1:4\n"};
+    for (const char* line : invalid) {
+        std::istringstream bad(std::string("seeds=2\n") + line);
+        SweepSpec rejected;
+        assert(!parseSweepSpec(bad, rejected, error));
+        assert(error.find("line 2: ") == 0);
+    }
+    std::istringstream range("soil_drainage_factor=0.5:1.5:0.5\n");
+    assert(!parseSweepSpec(range, badSpec, error));
+    std::cout << "Rejected: " << error << std::endl;
+    assert(error == "line 1: invalid value '1.5' for soil_drainage_factor (expected a number >= 0 and <= 1)");
+
+    // Runs are independent: parallel results match running them one by one
+    std::vector<SweepResult> parallel(8), serial(8);
+    ZoneScheduler scheduler(4, 1);
+    scheduler.runTick(parallel.size(), [&](size_t r) {
+        parallel[r] = runSweepSimulation(runs[r].params, 3600, false, 2);
+    });
+    for (size_t r = 0; r < serial.size(); ++r) {
+        serial[r] = runSweepSimulation(runs[r].params, 3600, false, 2);
+        assert(serial[r].waterUsed == parallel[r].waterUsed);
+        assert(serial[r].averageStress == parallel[r].averageStress);
+        assert(serial[r].sensorFailures == parallel[r].sensorFailures);
+    }
+    std::ostringstream table;
+    writeSweepResults(table, spec, runs, parallel);
+    assert(table.str().find("Run,Seed,moisture_threshold,pump_flow_rate,conservation_moisture_threshold,") == 0);
+    std::cout << "ParameterSweep tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,95 @@
+#include <cassert>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include "../include/Profiler.h"
+#include "../include/ZoneSimulation.h"
+
+typedef std::chrono::steady_clock Clock;
+
+static const ProfileStats* find(const std::vector<ProfileStats>& stats, ProfileSection section) {
+    for (const ProfileStats& s : stats) {
+        if (s.section == section) return &s;
+    }
+    return nullptr;
+}
+
+static size_t countOf(const std::string& text, const std::string& needle) {
+    size_t n = 0;
+    for (size_t pos = text.find(needle); pos != std::string::npos; pos = text.find(needle, pos + 1)) ++n;
+    return n;
+}
+
+int main() {
+    // Test 1: disabled scopes record nothing
+    assert(!Profiler::isEnabled());
+    { ProfileScope scope(ProfileSection::ZoneStep); }
+    assert(Profiler::report().empty());
+
+    // Test 2: percentiles from the histogram, within one bucket (1/8 of a power of two)
+    Profiler::enable(false);
+    Clock::time_point t0 = Clock::now();
+    for (int i = 1; i <= 1000; ++i) {
+        Profiler::record(ProfileSection::LogFormat, t0, t0 + std::chrono::microseconds(i));
+    }
+    std::vector<ProfileStats> stats = Profiler::report();
+    assert(stats.size() == 1);
+    const ProfileStats& format = stats[0];
+    assert(format.section == ProfileSection::LogFormat && format.count == 1000);
+    assert(format.maxUs == 1000.0 && format.totalMs > 500.0 && format.totalMs < 501.0);
+    assert(format.p50Us >= 500.0 && format.p50Us <= 500.0 * 1.125);
+    assert(format.p90Us >= 900.0 && format.p90Us <= 900.0 * 1.125);
+    assert(format.p99Us >= 990.0 && format.p99Us <= 1000.0); // Capped by the max
+
+    // Test 3: thread buffers merge, and enable() starts from empty
+    Profiler::enable(true);
+    std::thread worker([]() {
+        for (int i = 0; i < 10; ++i) { ProfileScope scope(ProfileSection::WeatherUpdate); }
+    });
+    worker.join(); // Its buffer outlives the thread
+    for (int i = 0; i < 5; ++i) { ProfileScope scope(ProfileSection::WeatherUpdate); }
+    stats = Profiler::report();
+    assert(stats.size() == 1 && stats[0].count == 15);
+
+    // Test 4: the instrumented zone step covers controller, zone, weather and forecast
+    SimulationParams params;
+    params.seed = 4;
+    ZoneSimulation zone(params, 0, "Zone1", "Loam");
+    for (int t = 0; t < 3600; ++t) zone.step(static_cast<float>(t));
+    stats = Profiler::report();
+    assert(find(stats, ProfileSection::ZoneStep)->count == 3600);
+    assert(find(stats, ProfileSection::ControllerUpdate)->count == 3600);
+    assert(find(stats, ProfileSection::ZoneUpdate)->count == 3600);
+    assert(find(stats, ProfileSection::WeatherUpdate)->count == 3615);
+    assert(find(stats, ProfileSection::Forecast)->count >= 1);
+    std::ostringstream table;
+    Profiler::printTable(table);
+    assert(table.str().find("ControllerUpdate") != std::string::npos);
+
+    // Test 5: Chrome trace export, one complete event per recorded scope plus thread names
+    Profiler::disable();
+    const char* path = "test_profile_trace.json";
+    std::string error;
+    assert(Profiler::writeChromeTrace(path, error));
+    std::ifstream file(path);
+    std::string json((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    uint64_t recorded = 0;
+    for (const ProfileStats& s : stats) recorded += s.count;
+    assert(json.compare(0, 1, "{") == 0 && json.find("\"traceEvents\":[") != std::string::npos);
+    assert(countOf(json, "\"ph\":\"X\"") == recorded);
+    assert(countOf(json, "\"thread_name\"") == 2);
+    std::remove(path);
+    assert(!Profiler::writeChromeTrace("missing_dir/trace.json", error) && !error.empty());
+
+    // Test 6: events over the per-thread limit are counted, not stored; the histogram still sees them
+    Profiler::enable(true, 2);
+    for (int i = 0; i < 5; ++i) { ProfileScope scope(ProfileSection::LogWrite); }
+    Profiler::disable();
+    assert(Profiler::getDroppedTraceEvents() == 3 && Profiler::report()[0].count == 5);
+
+    std::cout << "Profiler tests passed!" << std::endl;
+    return 0;
+}
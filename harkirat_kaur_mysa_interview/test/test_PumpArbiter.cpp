@@ -0,0 +1,103 @@
+#include <cassert>
+#include <iostream>
+#include <memory>
+#include <vector>
+#include "../include/PumpArbiter.h"
+#include "../include/ZoneSimulation.h"
+
+int main() {
+    // Test 1: free permits go to the most urgent waiting zones; ties to the lower index
+    PumpArbiter arbiter(6, 2);
+    arbiter.post(0, true, 5.0f);
+    arbiter.post(1, true, 30.0f);
+    arbiter.post(2, true, 12.0f);
+    arbiter.post(3, true, 30.0f);
+    arbiter.post(4, false, 90.0f); // Does not want water
+    arbiter.arbitrate(0);
+    assert(arbiter.isGranted(1) && arbiter.isGranted(3) && arbiter.getActive() == 2);
+    assert(!arbiter.isGranted(0) && !arbiter.isGranted(2) && !arbiter.isGranted(4));
+
+    // Test 2: a permit is kept while the pump runs and passed on when the zone stops wanting water
+    arbiter.post(1, true, 31.5f); // Pump running, urgency moved: a permit holder is not re-queued
+    arbiter.post(2, true, 40.0f); // Re-keyed above zone 3, but permits are not preempted
+    arbiter.arbitrate(1);
+    assert(arbiter.isGranted(1) && arbiter.isGranted(3) && !arbiter.isGranted(2));
+    arbiter.post(3, false, 0.0f);
+    arbiter.arbitrate(30);
+    assert(!arbiter.isGranted(3) && arbiter.isGranted(2) && !arbiter.isGranted(0));
+    ArbiterStats stats = arbiter.getStats(30);
+    assert(stats.grants == 3 && stats.maxWaitSeconds == 30 && stats.waitingZones == 1);
+
+    // Test 3: small urgency changes do not touch the heap
+    uint64_t updates = arbiter.getStats(30).heapUpdates;
+    arbiter.post(0, true, 5.5f);
+    arbiter.arbitrate(31);
+    assert(arbiter.getStats(31).heapUpdates == updates);
+    arbiter.post(0, true, 7.0f);
+    arbiter.arbitrate(32);
+    assert(arbiter.getStats(32).heapUpdates == updates + 1);
+
+    // Test 4: a zone that withdraws leaves the queue
+    arbiter.post(0, false, 0.0f);
+    arbiter.arbitrate(33);
+    assert(arbiter.getStats(33).waitingZones == 0);
+
+    // Test 5: aging lets a zone that has not been watered for a long time overtake more urgent ones
+    PumpArbiter aging(3, 1);
+    aging.post(0, true, 20.0f);
+    aging.arbitrate(0);
+    aging.post(0, false, 0.0f);
+    aging.arbitrate(7200); // Zone 0 watered at 2 h; zone 1 never
+    aging.post(0, true, 20.0f);
+    aging.post(1, true, 5.0f);
+    aging.arbitrate(7201);
+    assert(aging.isGranted(1) && !aging.isGranted(0)); // 5 > 20 - 10 points/h * 2 h
+
+    // Test 6: starvation and fairness
+    PumpArbiter queue(3, 1);
+    queue.setStarvationSeconds(100);
+    queue.post(0, true, 50.0f);
+    queue.post(1, true, 10.0f);
+    queue.arbitrate(0);
+    queue.post(0, false, 0.0f);
+    queue.arbitrate(200);
+    stats = queue.getStats(200);
+    assert(queue.isGranted(1) && stats.starvedZones == 1 && stats.maxWaitSeconds == 200);
+    assert(stats.fairness == 1.0); // One grant each
+    queue.post(1, false, 0.0f);
+    queue.post(0, true, 50.0f);
+    queue.arbitrate(201);
+    queue.post(0, false, 0.0f);
+    queue.arbitrate(202);
+    stats = queue.getStats(202);
+    assert(stats.fairness > 0.89 && stats.fairness < 0.91); // (2 + 1)^2 / (2 * (4 + 1))
+
+    // Test 7: arbitrated zones never run more pumps than there are permits
+    SimulationParams params;
+    params.seed = 11;
+    params.forecastDelayEnabled = false;
+    const int zones = 40;
+    PumpBudget unused(zones);
+    PumpArbiter site(zones, 3);
+    std::vector<std::unique_ptr<ZoneSimulation>> sims;
+    for (int z = 0; z < zones; ++z) {
+        sims.emplace_back(new ZoneSimulation(params, z, "Zone" + std::to_string(z + 1), "Loam", &unused));
+        sims.back()->setPumpArbiter(&site);
+    }
+    int waited = 0;
+    for (int t = 0; t < 600; ++t) {
+        int running = 0;
+        for (auto& sim : sims) {
+            ZoneStepResult r = sim->step(static_cast<float>(t));
+            running += r.pumpOn ? 1 : 0;
+            waited += r.pumpReason == PumpReason::ZoneBudget ? 1 : 0;
+        }
+        assert(running <= 3);
+        site.arbitrate(t);
+    }
+    stats = site.getStats(600);
+    assert(waited > 0 && stats.grants > 3 && unused.getActive() == 0);
+
+    std::cout << "PumpArbiter tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,41 @@
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <vector>
+#include "../include/RollingWindow.h"
+
+// Brute-force mean and least-squares slope over the last `window` values
+static void reference(const std::vector<float>& v, size_t window, double& mean, double& slope) {
+    size_t start = v.size() > window ? v.size() - window : 0;
+    double n = static_cast<double>(v.size() - start), sx = 0, sy = 0, sxy = 0, sxx = 0;
+    for (size_t i = start; i < v.size(); ++i) {
+        double x = static_cast<double>(i - start);
+        sx += x; sy += v[i]; sxy += x * v[i]; sxx += x * x;
+    }
+    mean = n > 0 ? sy / n : 0.0;
+    slope = n > 1 ? (n * sxy - sx * sy) / (n * sxx - sx * sx) : 0.0;
+}
+
+int main() {
+    RollingWindow w(72);
+    assert(w.empty() && w.mean() == 0.0f && w.slope() == 0.0f);
+    // Matches a full re-sum at every step, before and long after the window wraps
+    std::vector<float> values;
+    for (int h = 0; h < 24 * 40; ++h) {
+        float v = 50.0f + 20.0f * std::sin(h / 9.0f) + (h % 7) * 0.3f;
+        values.push_back(v);
+        w.push(v);
+        double mean, slope;
+        reference(values, 72, mean, slope);
+        assert(w.size() == (values.size() < 72 ? values.size() : 72));
+        assert(std::fabs(w.mean() - mean) < 1e-3);
+        assert(std::fabs(w.slope() - slope) < 1e-4);
+    }
+    // A straight line has exactly that slope
+    w.reset(30 * 24);
+    for (int h = 0; h < 2000; ++h) w.push(80.0f - 0.25f * h);
+    std::cout << "Slope of falling line (should be -0.25): " << w.slope() << std::endl;
+    assert(std::fabs(w.slope() + 0.25f) < 1e-4);
+    std::cout << "RollingWindow tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,115 @@
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "../include/Rollup.h"
+#include "../include/Logger.h"
+
+static std::vector<std::vector<std::string>> readRows(const char* path) {
+    std::vector<std::vector<std::string>> rows;
+    std::ifstream in(path);
+    std::string line;
+    std::getline(in, line); // Header
+    while (std::getline(in, line)) {
+        std::vector<std::string> fields;
+        std::stringstream row(line);
+        std::string f;
+        while (std::getline(row, f, ',')) fields.push_back(f);
+        rows.push_back(fields);
+    }
+    return rows;
+}
+
+int main() {
+    // Sketch percentiles are exact to one 0.5% bin
+    StressSketch sketch;
+    assert(sketch.percentile(0.5f) == 0.0f);
+    for (int i = 0; i < 100; ++i) sketch.add(static_cast<float>(i));
+    assert(std::fabs(sketch.percentile(0.5f) - 49.0f) <= 0.5f);
+    assert(std::fabs(sketch.percentile(0.9f) - 89.0f) <= 0.5f);
+    sketch.add(150.0f); // Clamped into the last bin
+    assert(sketch.percentile(1.0f) <= 100.0f);
+    // Percentiles stay within the values added: an hour without stress reports 0, not a bin midpoint
+    StressSketch calm;
+    calm.add(0.0f, 3600);
+    assert(calm.percentile(0.5f) == 0.0f && calm.percentile(0.99f) == 0.0f);
+    // A span's ticks spread over the bins its stress moved through
+    StressSketch spread;
+    spread.addRange(0.0f, 50.0f, 1000);
+    assert(std::fabs(spread.percentile(0.5f) - 25.0f) <= 0.5f && spread.percentile(0.99f) <= 50.0f);
+
+    // Two zones over 26 hours: one row per zone per closed hour and day, written as periods end
+    const char* path = "test_rollup.csv";
+    {
+        Logger logger{std::unique_ptr<LogSink>()};
+        assert(logger.enableRollups(path));
+        for (int t = 0; t < 26 * 3600; ++t) {
+            bool on = t % 3600 < 600; // 10 minutes per hour
+            logger.logSecond(t, 40.0f + (t % 3600) / 360.0f, 0.0f, 20.0f, 60.0f, 0.0f, on, 6.0f, on ? 0.1f : 0.0f,
+                             t < 3600 ? 5.0f : 0.0f, t % 3600 == 0, "ZoneA", "Loam", on ? 1.0f / 60.0f : 0.0f);
+            logger.logSecond(t, 70.0f, 0.0f, 20.0f, 60.0f, 0.0f, false, 6.0f, 0.0f, 0.0f, false, "ZoneB");
+        }
+        assert(logger.getRollupRowsWritten() == 2 * 25 + 2); // Hours 0-24 and day 0 closed
+        logger.finalize();
+        assert(logger.getRollupRowsWritten() == 2 * 26 + 4);
+    }
+    std::vector<std::vector<std::string>> rows = readRows(path);
+    assert(rows.size() == 56);
+    // hour,0,ZoneA: moisture 40..49.99, 1/6 duty, 60 L, stress 5 everywhere, 1 sensor error
+    const std::vector<std::string>& a0 = rows[0];
+    assert(a0[0] == "hour" && a0[1] == "0" && a0[2] == "ZoneA" && a0[3] == "3600");
+    assert(std::stof(a0[4]) == 40.0f && std::stof(a0[5]) > 49.9f);
+    assert(std::fabs(std::stof(a0[7]) - 100.0f / 6.0f) < 0.01f);
+    assert(std::fabs(std::stof(a0[8]) - 60.0f) < 0.01f);
+    assert(std::fabs(std::stof(a0[10]) - 5.0f) <= 0.5f);
+    assert(a0[13] == "1");
+    bool sawDayB = false;
+    for (const auto& r : rows) {
+        if (r[0] == "day" && r[1] == "0" && r[2] == "ZoneB") {
+            sawDayB = true;
+            assert(r[3] == "86400" && std::stof(r[6]) == 70.0f && std::stof(r[7]) == 0.0f);
+        }
+    }
+    assert(sawDayB);
+
+    // A closed-form span gives the same rollup as the ticks it stands for
+    const char* tickPath = "test_rollup_ticks.csv";
+    {
+        RollupWriter ticks(tickPath), span(path);
+        ticks.defineName(0, "Zone1");
+        span.defineName(0, "Zone1");
+        for (int i = 0; i < 1000; ++i) ticks.add(0, 100 + i, 30.0f + 0.01f * i, true, 0.1f, 0.0f, 2.0f, false);
+        span.addSpan(0, 100, 1000, 30.0f, 30.0f + 0.01f * 999, 30.0 * 1000 + 0.01 * 999 * 1000 / 2, true, 100.0f,
+                     0.0f, 2.0f, 2.0f, 0);
+    }
+    std::vector<std::string> t = readRows(tickPath)[0], s = readRows(path)[0];
+    assert(t[3] == s[3] && t[4] == s[4] && t[7] == s[7] && t[10] == s[10]);
+    assert(std::fabs(std::stof(t[5]) - std::stof(s[5])) < 1e-3f);
+    assert(std::fabs(std::stof(t[6]) - std::stof(s[6])) < 1e-3f);
+    assert(std::fabs(std::stof(t[8]) - std::stof(s[8])) < 1e-2f);
+
+    // A span that reaches the 100% clamp partway: its mean comes from the exact sum, not the end points
+    {
+        RollupWriter ticks(tickPath), span(path);
+        double sum = 0.0;
+        for (int i = 0; i < 1000; ++i) {
+            float m = std::min(100.0f, 95.0f + 0.02f * i);
+            ticks.add(0, i, m, false, 0.0f, 0.0f, 0.0f, false);
+            sum += m;
+        }
+        span.addSpan(0, 0, 1000, 95.0f, 100.0f, sum, false, 0.0f, 0.0f, 0.0f, 0.0f, 0);
+    }
+    t = readRows(tickPath)[0];
+    s = readRows(path)[0];
+    assert(std::fabs(std::stof(t[6]) - std::stof(s[6])) < 1e-3f && std::stof(s[6]) > 99.0f);
+    assert(s[10] == "0" && s[12] == "0");
+    std::remove(path);
+    std::remove(tickPath);
+    std::cout << "Rollup tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,146 @@
+#include <cassert>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include <unistd.h>
+#include "../include/SensorIngest.h"
+#include "../include/WeatherSensor.h"
+#include "../include/Soil.h"
+
+// Waits up to a second for the ingestion thread to store `readings` readings
+static bool waitForReadings(const SensorIngestService& service, uint64_t readings) {
+    for (int i = 0; i < 1000 && service.getStats().readings < readings; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return service.getStats().readings >= readings;
+}
+
+int main() {
+    // Test 1: line protocol, any field order, failures, CRLF, malformed lines
+    const char lines[] =
+        "weather,zone=2 humidity=61.5,temperature=21.25,rainfall=0\n"
+        "soil,zone=0 moisture=44.5 1720000000\r\n"
+        "weather,zone=1 failed=1\n"
+        "\n"
+        "soil,zone=3 temperature=5\n"   // Not a soil field
+        "weather,zone=1 temperature=20\n" // Missing fields
+        "rain,zone=1 mm=3\n"
+        "soil,zone=-1 moisture=3\n";
+    SensorReading decoded[16];
+    size_t malformed = 0;
+    size_t n = decodeSensorDatagram(lines, sizeof(lines) - 1, decoded, 16, malformed);
+    assert(n == 3 && malformed == 4);
+    assert(decoded[0].kind == SensorKind::Weather && decoded[0].zone == 2 && !decoded[0].failed);
+    assert(decoded[0].values[0] == 21.25f && decoded[0].values[1] == 61.5f && decoded[0].values[2] == 0.0f);
+    assert(decoded[1].kind == SensorKind::Soil && decoded[1].zone == 0 && decoded[1].values[0] == 44.5f);
+    assert(decoded[2].failed && decoded[2].zone == 1);
+
+    // Test 2: both encodings round-trip; a truncated binary record is malformed
+    SensorReading reading;
+    reading.kind = SensorKind::Weather;
+    reading.zone = 7;
+    reading.values[0] = 18.5f;
+    reading.values[1] = 70.25f;
+    reading.values[2] = 1.5f;
+    char buffer[256];
+    size_t used = encodeSensorBinary(reading, buffer, sizeof(buffer));
+    reading.kind = SensorKind::Soil;
+    reading.values[0] = 33.0f;
+    used += encodeSensorBinary(reading, buffer + used, sizeof(buffer) - used);
+    malformed = 0;
+    n = decodeSensorDatagram(buffer, used + 3, decoded, 16, malformed);
+    assert(n == 2 && malformed == 1 && used == 2 * kBinaryRecordSize);
+    assert(decoded[0].kind == SensorKind::Weather && decoded[0].values[1] == 70.25f && decoded[1].values[0] == 33.0f);
+    used = encodeSensorLine(reading, buffer, sizeof(buffer));
+    malformed = 0;
+    assert(decodeSensorDatagram(buffer, used, decoded, 16, malformed) == 1 && malformed == 0);
+    assert(decoded[0].zone == 7 && decoded[0].values[0] == 33.0f);
+    assert(encodeSensorLine(reading, buffer, 8) == 0); // Does not fit
+
+    // Test 3: sensors read their zone's slot with the -999 / -1 failure conventions, and stale readings fail
+    SensorSlots slots(2, 0.05);
+    WeatherSensor weather(CounterRng(1, 0));
+    Soil soil(0.8f, 0.2f);
+    weather.setLiveSource(&slots, 1);
+    soil.setLiveSource(&slots, 1);
+    assert(weather.hasFailed() && weather.getTemperature() == -999.0f && soil.getMoisture() == -1.0f); // Nothing yet
+    SensorReading w;
+    w.kind = SensorKind::Weather;
+    w.zone = 1;
+    w.values[0] = 23.0f;
+    w.values[1] = 55.0f;
+    w.values[2] = 0.5f;
+    SensorReading s;
+    s.kind = SensorKind::Soil;
+    s.zone = 1;
+    s.values[0] = 41.0f;
+    assert(slots.store(w, SensorSlots::nowNs()) && slots.store(s, SensorSlots::nowNs()));
+    weather.update(10);
+    soil.update(0.0f, 0.0f, 0.0f);
+    assert(!weather.hasFailed() && weather.getTemperature() == 23.0f && weather.getRainfall() == 0.5f);
+    assert(soil.getMoisture() == 41.0f);
+    s.failed = true;
+    slots.store(s, SensorSlots::nowNs());
+    soil.update(0.0f, 5.0f, 5.0f);
+    assert(soil.getMoisture() == -1.0f);
+    soil.resetFailure(); // The device still reports a failure
+    assert(soil.getMoisture() == -1.0f);
+    std::this_thread::sleep_for(std::chrono::milliseconds(80));
+    weather.update(11);
+    assert(weather.hasFailed() && weather.getHumidity() == -999.0f); // Stale
+    SensorReading other = w;
+    other.zone = 2;
+    assert(!slots.store(other, SensorSlots::nowNs()));
+
+    // Test 4: the service stores datagrams from a UNIX socket and a UDP port; unknown zones are counted
+    SensorSlots live(3);
+    SensorIngestService service(live);
+    std::string error;
+    std::string path = "/tmp/mysa_sensor_test_" + std::to_string(getpid()) + ".sock";
+    bool started = service.start("unix:" + path, error);
+    assert(started);
+    SensorClient client;
+    assert(client.open("unix:" + path, error));
+    const char packet[] = "weather,zone=0 temperature=12,humidity=90,rainfall=2\nsoil,zone=0 moisture=25\nsoil,zone=9 moisture=1\n";
+    assert(client.send(packet, sizeof(packet) - 1));
+    assert(waitForReadings(service, 2));
+    float values[3];
+    assert(live.read(0, SensorKind::Weather, values) && values[1] == 90.0f);
+    assert(live.read(0, SensorKind::Soil, values) && values[0] == 25.0f);
+    IngestStats stats = service.getStats();
+    assert(stats.datagrams == 1 && stats.unknownZone == 1 && stats.malformed == 0);
+    service.stop();
+    assert(access(path.c_str(), F_OK) != 0); // Socket file removed
+    assert(service.start("udp:127.0.0.1:0", error) && service.getPort() > 0);
+    assert(client.open("udp:127.0.0.1:" + std::to_string(service.getPort()), error));
+    used = encodeSensorBinary(s, buffer, sizeof(buffer)); // Zone 1, failed
+    assert(client.send(buffer, used));
+    for (int i = 0; i < 1000 && service.getStats().datagrams < 2; ++i) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    assert(service.getStats().datagrams == 2 && !live.read(1, SensorKind::Soil, values));
+    assert(!service.start("tcp:localhost:80", error) && !error.empty());
+
+    // Test 5: the replay client turns a CSV log into one weather and one soil reading per zone and step
+    std::istringstream log(
+        "Timestamp,SoilMoisture (%),EffectiveMoisture (%),Temperature (C),Humidity (%),Rainfall (mm),PumpState,"
+        "FlowRate (L/min),WaterUsed (L),PlantStress (%),SensorError,ZoneID,SoilType,PowerUsed (Wh)\n"
+        "2025-07-01 00:00:00,30.0,31.0,15.5,79.1,0.0,OFF,6.0,0.0,0.0,FALSE,Zone1,Loam,0.00\n"
+        "2025-07-01 00:00:00,40.0,41.0,16.5,75.0,1.0,OFF,6.0,0.0,0.0,FALSE,Zone2,Loam,0.00\n"
+        "2025-07-01 00:00:01,31.0,32.0,15.6,79.0,0.0,OFF,6.0,0.0,0.0,TRUE,Zone1,Loam,0.00\n");
+    SensorSlots replayed(2);
+    SensorIngestService replayService(replayed);
+    assert(replayService.start("unix:" + path, error));
+    assert(client.open("unix:" + path, error));
+    ReplayStats replay;
+    assert(replaySensorLog(log, client, SensorEncoding::Binary, 0.0, replay, error));
+    assert(replay.steps == 2 && replay.readings == 6 && replay.datagrams == 2);
+    assert(waitForReadings(replayService, 6));
+    assert(replayed.read(1, SensorKind::Soil, values) && values[0] == 40.0f);
+    assert(!replayed.read(0, SensorKind::Weather, values)); // Last step flagged SensorError
+    std::istringstream notALog("time_s,temperature\n0,1\n");
+    assert(!replaySensorLog(notALog, client, SensorEncoding::Line, 0.0, replay, error));
+
+    std::cout << "SensorIngest tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,84 @@
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <vector>
+#include "../include/WeatherBatch.h"
+#include "../include/WeatherSensor.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// The per-tick model before batching, kept as the reference
+static void referenceWeather(const CounterRng& rng, int s, float& temperature, float& humidity, float& rainfall) {
+    float dayFraction = (s % 86400) / 86400.0f;
+    temperature = 15.0f + 10.0f * std::sin(2 * M_PI * dayFraction) + (rng.drawInt(s, 1, 200) - 100) / 100.0f;
+    humidity = 80.0f - (temperature - 15.0f) * 2.0f + (rng.drawInt(s, 2, 100) - 50) / 100.0f;
+    if (temperature < -10.0f) temperature = -10.0f;
+    if (temperature > 40.0f) temperature = 40.0f;
+    if (humidity < 0.0f) humidity = 0.0f;
+    if (humidity > 100.0f) humidity = 100.0f;
+    rainfall = rng.drawInt(s, 3, 3600) < 360 ? (rng.drawInt(s, 4, 10) + 1) * 0.5f : 0.0f;
+}
+
+static bool sameBits(float a, float b) {
+    return std::memcmp(&a, &b, sizeof a) == 0;
+}
+
+int main() {
+    std::cout << "SIMD level: " << WeatherBatch::simdLevel() << std::endl;
+    CounterRng rng = CounterRng(9, 2).withStream(CounterRng::WeatherStream);
+
+    // Test 1: a block of ticks across midnight, with an odd length, matches the per-tick model bit for bit
+    const int first = 86400 - 1000;
+    const size_t count = 3001;
+    std::vector<float> temperature(count), humidity(count), rainfall(count);
+    WeatherBatch::generateTicks(rng, first, count, temperature.data(), humidity.data(), rainfall.data());
+    int rainy = 0;
+    for (size_t i = 0; i < count; ++i) {
+        float t, h, r;
+        referenceWeather(rng, first + static_cast<int>(i), t, h, r);
+        assert(sameBits(temperature[i], t) && sameBits(humidity[i], h) && sameBits(rainfall[i], r));
+        rainy += r > 0.0f ? 1 : 0;
+    }
+    assert(rainy > 200 && rainy < 400); // 10% of ticks
+
+    // Test 2: one tick for many zones matches each zone's own stream
+    const size_t zones = 37;
+    std::vector<CounterRng> rngs;
+    for (size_t z = 0; z < zones; ++z) rngs.push_back(CounterRng(9, static_cast<uint32_t>(z)).withStream(CounterRng::WeatherStream));
+    WeatherBatch::generateZones(rngs.data(), zones, 45123, temperature.data(), humidity.data(), rainfall.data());
+    for (size_t z = 0; z < zones; ++z) {
+        float t, h, r;
+        referenceWeather(rngs[z], 45123, t, h, r);
+        assert(sameBits(temperature[z], t) && sameBits(humidity[z], h) && sameBits(rainfall[z], r));
+    }
+
+    // Test 3: the sensor's per-call view gives the same readings for every stride, including repeated ticks
+    const int strides[] = {1, 7, 64, 100};
+    for (int stride : strides) {
+        WeatherSensor sensor(CounterRng(9, 2));
+        for (int s = 0; s < 20000; s += stride) {
+            sensor.update(s);
+            if (s % 3 == 0) sensor.update(s); // Fractional steps repeat a tick
+            if (sensor.hasFailed()) { // Failures are drawn per tick; the next update reads the model again
+                sensor.resetFailure();
+                continue;
+            }
+            float t, h, r;
+            referenceWeather(rng, s, t, h, r);
+            assert(sameBits(sensor.getTemperature(), t) && sameBits(sensor.getHumidity(), h));
+            assert(sameBits(sensor.getRainfall(), r));
+        }
+    }
+
+    // Test 4: the diurnal table is the original curve
+    for (int s = 0; s < WeatherBatch::kDaySeconds; s += 997) {
+        double curve = 15.0f + 10.0f * std::sin(2 * M_PI * (s / 86400.0f));
+        assert(WeatherBatch::diurnal(s) == curve);
+    }
+
+    std::cout << "WeatherBatch tests passed!" << std::endl;
+    return 0;
+}
@@ -1,4 +1,5 @@
 #include <cassert>
+#include <cmath>
 #include <iostream>
 #include "../include/WeatherSensor.h"
 
@@ -28,6 +29,42 @@ int main() {
         }
     }
     assert(failed && "Sensor should eventually fail in 10,000 updates");
+    // Forecast: issued once per hour, cumulative over hours, and consecutive issues agree
+    WeatherSensor forecast(CounterRng(7, 0));
+    forecast.update(7200);
+    float sixHours = forecast.getRainForecast(6);
+    for (int t = 7201; t < 10800; ++t) {
+        forecast.update(t);
+        if (forecast.hasFailed()) forecast.resetFailure(); // Failed sensors report -999
+        assert(forecast.getRainForecast(6) == sixHours); // Stable within the hour
+    }
+    float previous = 0.0f;
+    for (int h = 0; h <= WeatherSensor::kForecastHours; ++h) {
+        assert(forecast.getRainForecast(h) >= previous);
+        previous = forecast.getRainForecast(h);
+    }
+    assert(forecast.getRainForecast(1000) == forecast.getRainForecast(WeatherSensor::kForecastHours));
+    float hours3to8 = forecast.getRainForecast(6) - forecast.getRainForecast(1); // Hours 3..7
+    forecast.update(10800);
+    if (forecast.hasFailed()) forecast.resetFailure();
+    assert(std::fabs(forecast.getRainForecast(5) - hours3to8) < 1e-4f);
+    // Ensemble: probabilities in [0, 1], non-decreasing, and the mean is near 10% x 2.75 mm per hour
+    forecast.setForecastEnsembleMembers(64);
+    assert(forecast.getForecastEnsembleMembers() == 64);
+    assert(forecast.getRainProbability(0) == 0.0f);
+    for (int h = 1; h <= 24; ++h) {
+        assert(forecast.getRainProbability(h) >= forecast.getRainProbability(h - 1));
+        assert(forecast.getRainProbability(h) <= 1.0f);
+    }
+    assert(forecast.getRainProbability(72) > 0.9f); // 1 - 0.9^72 per member
+    float meanPerHour = forecast.getRainForecast(72) / 72.0f;
+    assert(meanPerHour > 0.2f && meanPerHour < 0.35f);
+    // The issued hours can be recomputed without a sensor, bit for bit (EventSimulation's forecast)
+    CounterRng forecastRng = CounterRng(7, 0).withStream(CounterRng::ForecastStream);
+    for (int h = 3; h < 3 + WeatherSensor::kForecastHours; ++h) {
+        assert(WeatherSensor::syntheticForecastRain(forecastRng, 64, h) == forecast.getForecastRainAt(h));
+    }
+    std::cout << "Forecast tests passed (ensemble 72h mean " << meanPerHour << " mm/h)" << std::endl;
     std::cout << "WeatherSensor tests passed!" << std::endl;
     return 0;
 } 
\ No newline at end of file
@@ -0,0 +1,79 @@
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include "../include/WeatherTrace.h"
+#include "../include/WeatherSensor.h"
+
+static bool near(float a, float b) { return std::fabs(a - b) < 1e-4f; }
+
+int main() {
+    const char* path = "test_trace.mwx";
+    // Three 10-minute samples: 10 -> 20 -> 30 C, rain only in the second interval
+    std::vector<float> temperature = {10.0f, 20.0f, 30.0f};
+    std::vector<float> humidity = {90.0f, 60.0f, 30.0f};
+    std::vector<float> rainfall = {0.0f, 6.0f, 0.0f};
+    assert(writeWeatherTrace(path, 600, temperature, humidity, rainfall));
+
+    WeatherTrace trace;
+    std::string error;
+    assert(trace.open(path, error));
+    assert(trace.getInterval() == 600 && trace.getSampleCount() == 3 && trace.getDuration() == 1800);
+    // Linear interpolation, rain spread evenly over its interval, and wrap-around after the last sample
+    assert(near(trace.sample(0).temperature, 10.0f));
+    assert(near(trace.sample(300).temperature, 15.0f));
+    assert(near(trace.sample(300).humidity, 75.0f));
+    assert(near(trace.sample(600).rainfall, 6.0f / 600.0f));
+    assert(near(trace.sample(1500).temperature, 20.0f)); // Halfway from 30 back to the first sample
+    assert(near(trace.sample(1800 + 300).temperature, trace.sample(300).temperature));
+    assert(near(trace.rainBetween(0, 1800), 6.0f));
+    assert(near(trace.rainBetween(900, 1200), 3.0f));
+    assert(near(trace.rainBetween(0, 3 * 1800), 18.0f));
+
+    // Sensors replay the shared mapping; the forecast is the trace's rain
+    WeatherSensor a(CounterRng(1, 0)), b(CounterRng(1, 1));
+    a.setTrace(&trace);
+    b.setTrace(&trace);
+    for (int t = 0; t < 1800; ++t) {
+        a.update(t);
+        b.update(t);
+        if (a.hasFailed() || b.hasFailed()) {
+            a.resetFailure();
+            b.resetFailure();
+            continue;
+        }
+        assert(a.getTemperature() == b.getTemperature());
+        assert(near(a.getTemperature(), trace.sample(t).temperature));
+    }
+    a.update(3600);
+    if (a.hasFailed()) a.resetFailure();
+    assert(near(a.getRainForecast(1), 12.0f)); // Two trace cycles per hour
+    assert(a.getRainProbability(1) == 1.0f);
+
+    // Invalid files are rejected
+    a.setTrace(nullptr);
+    b.setTrace(nullptr);
+    trace.close();
+    std::ofstream(path, std::ios::binary) << "MYSAWX";
+    WeatherTrace truncated;
+    assert(!truncated.open(path, error));
+    assert(!truncated.open("does_not_exist.mwx", error));
+
+    // CSV conversion
+    std::istringstream csv("time_s,temperature,humidity,rain_mm\n0,12.5,70,0\n60,13,69,0.2\n120,13.5,68,0\n");
+    assert(convertWeatherCsv(csv, path, error));
+    WeatherTrace converted;
+    assert(converted.open(path, error));
+    assert(converted.getInterval() == 60 && converted.getSampleCount() == 3);
+    assert(near(converted.sample(90).temperature, 13.25f));
+    std::istringstream uneven("0,12,70,0\n60,13,69,0\n180,14,68,0\n");
+    assert(!convertWeatherCsv(uneven, path, error));
+    std::cout << "Rejected uneven CSV: " << error << std::endl;
+    converted.close();
+    std::remove(path);
+    std::cout << "WeatherTrace tests passed!" << std::endl;
+    return 0;
+}
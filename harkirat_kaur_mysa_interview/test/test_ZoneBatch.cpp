@@ -0,0 +1,69 @@
+#include <cassert>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+#include "../include/ZoneBatch.h"
+#include "../include/Soil.h"
+#include "../include/Plant.h"
+#include "../include/WaterPump.h"
+
+// Equivalence test: ZoneBatch kernels must match the single-zone classes bit for bit
+int main() {
+    const size_t zones = 37; // Not a multiple of the SIMD width, so the scalar tail runs too
+    ZoneBatch batch;
+    std::vector<Soil> soils;
+    std::vector<Plant> plants;
+    std::vector<WaterPump> pumps;
+    std::srand(42);
+    for (size_t z = 0; z < zones; ++z) {
+        ZoneParams p;
+        p.retentionRate = 0.5f + (z % 5) * 0.1f;
+        p.drainageFactor = 0.1f + (z % 3) * 0.1f;
+        p.waterNeedPerDay = 2.0f + z;
+        p.absorptionRate = 0.01f + (z % 4) * 0.02f;
+        p.flowRateLpm = 3.0f + (z % 6);
+        p.maxRunTime = 20 + static_cast<int>(z);
+        p.cooldownTime = 10 + static_cast<int>(z % 7);
+        assert(batch.addZone(p) == z);
+        soils.push_back(Soil(p.retentionRate, p.drainageFactor));
+        plants.push_back(Plant(p.waterNeedPerDay, 10.0f, p.absorptionRate));
+        pumps.push_back(WaterPump(p.flowRateLpm, p.powerWatts));
+        pumps.back().setMaxRunTime(p.maxRunTime);
+        pumps.back().setCooldownTime(p.cooldownTime);
+    }
+    std::vector<float> temp(zones), humidity(zones), rain(zones);
+    for (int t = 0; t < 20000; ++t) {
+        for (size_t z = 0; z < zones; ++z) {
+            temp[z] = 5.0f + (std::rand() % 3000) / 100.0f;
+            humidity[z] = (std::rand() % 10000) / 100.0f;
+            rain[z] = (std::rand() % 50 == 0) ? (std::rand() % 10 + 1) * 0.5f : 0.0f;
+            // Random controller decisions
+            int action = std::rand() % 100;
+            if (action < 10) {
+                pumps[z].turnOn();
+                batch.turnOn(z);
+            } else if (action == 10) {
+                pumps[z].turnOff();
+                batch.turnOff(z);
+            }
+        }
+        batch.updatePumps();
+        batch.step(temp.data(), humidity.data(), rain.data());
+        for (size_t z = 0; z < zones; ++z) {
+            // Reference: IrrigationController's pump->update, then GardenZone::update physics
+            pumps[z].update(t);
+            float evap = (temp[z] / 30.0f) * (1.0f - humidity[z] / 100.0f) * 0.05f;
+            float irrigation = pumps[z].isOn() ? pumps[z].getFlowRate() / 60.0f : 0.0f;
+            soils[z].update(evap, rain[z], irrigation);
+            plants[z].update(soils[z].getMoisture());
+            assert(batch.isOn(z) == pumps[z].isOn());
+            assert(batch.canRun(z) == pumps[z].canRun());
+            assert(batch.getMoisture(z) == soils[z].getMoisture());
+            assert(batch.getStress(z) == plants[z].getStress());
+        }
+    }
+    std::cout << "ZoneBatch (" << ZoneBatch::simdLevel() << ") matches reference classes for "
+              << zones << " zones" << std::endl;
+    std::cout << "ZoneBatch tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,67 @@
+#include <atomic>
+#include <cassert>
+#include <iostream>
+#include <thread>
+#include <vector>
+#include "../include/ZoneScheduler.h"
+#include "../include/GardenZone.h"
+#include "../include/ZoneSimulation.h"
+
+int main() {
+    // Every zone is updated exactly once per tick, whatever the thread count
+    for (size_t threads = 1; threads <= 4; ++threads) {
+        ZoneScheduler scheduler(threads, 3);
+        std::vector<int> calls(1000, 0);
+        for (int tick = 1; tick <= 200; ++tick) {
+            scheduler.runTick(calls.size(), [&calls](size_t z) { ++calls[z]; });
+            for (size_t z = 0; z < calls.size(); ++z) assert(calls[z] == tick);
+        }
+        std::cout << threads << " thread(s): " << scheduler.getStealCount() << " chunks stolen" << std::endl;
+    }
+
+    // Pump permits never exceed the site-wide budget under contention
+    GardenZone::setMaxConcurrentPumps(3);
+    std::atomic<int> holders(0), maxHolders(0);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < 8; ++t) {
+        workers.emplace_back([&holders, &maxHolders]() {
+            for (int i = 0; i < 20000; ++i) {
+                if (!GardenZone::tryAcquirePump()) continue;
+                int now = ++holders;
+                int seen = maxHolders.load();
+                while (now > seen && !maxHolders.compare_exchange_weak(seen, now)) {}
+                --holders;
+                GardenZone::decrementActivePumps();
+            }
+        });
+    }
+    for (auto& w : workers) w.join();
+    std::cout << "Max concurrent pump permits: " << maxHolders.load() << std::endl;
+    assert(maxHolders.load() <= 3);
+    assert(GardenZone::getActivePumpCount() == 0);
+
+    // Permits follow real pump runs: dry zones water again after each cooldown and never hold a permit while off
+    SimulationParams dry;
+    dry.seed = 4;
+    dry.moistureThreshold = 100.0f;
+    dry.forecastDelayEnabled = false;
+    PumpBudget budget(1);
+    ZoneSimulation a(dry, 0, "Zone1", "Loam", &budget), b(dry, 1, "Zone2", "Loam", &budget);
+    int starts[2] = {0, 0}, offRun[2] = {0, 0}, refused = 0;
+    for (int t = 0; t < 4 * 3600; ++t) {
+        ZoneStepResult r[2] = {a.step(static_cast<float>(t)), b.step(static_cast<float>(t))};
+        for (int z = 0; z < 2; ++z) {
+            if (r[z].pumpOn && offRun[z] > 0) {
+                assert(offRun[z] >= 300); // Cooldown between runs
+                ++starts[z];
+            }
+            offRun[z] = r[z].pumpOn ? 0 : offRun[z] + 1;
+            if (r[z].pumpReason == PumpReason::ZoneBudget) ++refused;
+        }
+        assert(budget.getActive() == (r[0].pumpOn ? 1 : 0) + (r[1].pumpOn ? 1 : 0));
+    }
+    std::cout << "Dry zone restarts: " << starts[0] << " and " << starts[1] << ", " << refused << " refused" << std::endl;
+    assert(starts[0] > 1 && starts[1] > 1 && refused > 0);
+    std::cout << "ZoneScheduler tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,148 @@
+// mysa_calibrate: fits soil_retention_rate, soil_drainage_factor and plant_absorption_rate to a recorded bed.
+// Usage: mysa_calibrate <observed.csv> [--zone <id>] [--configuration <config.yaml>] [--water-need <L/day>]
+//                       [--stress-weight <w>] [--segment <steps>] [--grid <n>] [--rounds <n>] [--threads <n>|auto]
+//                       [--min-stressed <share>] [--output <file>]
+// The log is in output.csv's layout (mysa_log2csv converts a binary one). --configuration takes
+// plant_water_need_per_day and the starting parameters from a config.yaml and reports the fit before and
+// after. Each replay restarts from the measurements every --segment steps (default 3600, 0 for one replay of
+// the whole log). plant_absorption_rate is fitted only when at least --min-stressed (default 0.05) of the
+// rows show plant stress; otherwise it keeps the configured value. The fitted parameters are printed as
+// config.yaml lines, and also written to --output.
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include "../include/Calibration.h"
+#include "../include/Config.h"
+#include "../include/ZoneScheduler.h"
+
+static bool parseFloat(const std::string& text, float& value) {
+    char* end = nullptr;
+    value = std::strtof(text.c_str(), &end);
+    return end != text.c_str() && *end == '\0';
+}
+
+static bool parseInt(const std::string& text, int& value, int min) {
+    char* end = nullptr;
+    long parsed = std::strtol(text.c_str(), &end, 10);
+    value = static_cast<int>(parsed);
+    return end != text.c_str() && *end == '\0' && parsed >= min && parsed <= 1000000;
+}
+
+static void printFit(const char* label, const FitError& e) {
+    std::cout << label << ": moisture RMSE " << (e.rows ? std::sqrt(e.moistureSquared / e.rows) : 0.0)
+              << " %, stress RMSE " << (e.rows ? std::sqrt(e.stressSquared / e.rows) : 0.0) << " %" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    const char* usage = " <observed.csv> [--zone <id>] [--configuration <config.yaml>] [--water-need <L/day>] "
+                        "[--stress-weight <w>] [--segment <steps>] [--grid <n>] [--rounds <n>] [--threads <n>|auto] "
+                        "[--min-stressed <share>] [--output <file>]";
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << usage << std::endl;
+        return 12;
+    }
+    std::string logPath = argv[1];
+    std::string zone, configPath, outputPath;
+    int threads = 1;
+    bool waterNeedSet = false;
+    CalibrationOptions options;
+    for (int i = 2; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        bool ok = true;
+        if (arg == "--zone" && hasValue) {
+            zone = argv[++i];
+        } else if (arg == "--configuration" && hasValue) {
+            configPath = argv[++i];
+        } else if (arg == "--water-need" && hasValue) {
+            ok = parseFloat(argv[++i], options.waterNeedPerDay) && options.waterNeedPerDay >= 0.0f;
+            waterNeedSet = true;
+        } else if (arg == "--stress-weight" && hasValue) {
+            ok = parseFloat(argv[++i], options.stressWeight) && options.stressWeight >= 0.0f;
+        } else if (arg == "--segment" && hasValue) {
+            int steps = 0;
+            ok = parseInt(argv[++i], steps, 0);
+            options.segmentSteps = static_cast<size_t>(steps);
+        } else if (arg == "--grid" && hasValue) {
+            ok = parseInt(argv[++i], options.gridPoints, 2);
+        } else if (arg == "--rounds" && hasValue) {
+            ok = parseInt(argv[++i], options.rounds, 1);
+        } else if (arg == "--threads" && hasValue) {
+            std::string t = argv[++i];
+            threads = t == "auto" ? static_cast<int>(std::thread::hardware_concurrency()) : 0;
+            ok = t == "auto" || parseInt(t, threads, 1);
+        } else if (arg == "--min-stressed" && hasValue) {
+            ok = parseFloat(argv[++i], options.minStressedShare) && options.minStressedShare >= 0.0f &&
+                 options.minStressedShare <= 1.0f;
+        } else if (arg == "--output" && hasValue) {
+            outputPath = argv[++i];
+        } else {
+            ok = false;
+        }
+        if (!ok) {
+            std::cerr << "Invalid argument: " << arg << "\nUsage: " << argv[0] << usage << std::endl;
+            return 12;
+        }
+    }
+
+    std::string error;
+    if (!configPath.empty()) {
+        Config config;
+        if (loadConfig(configPath, config, error) != ConfigStatus::Ok) {
+            std::cerr << "Failed to load configuration: " << error << std::endl;
+            return 1;
+        }
+        if (!waterNeedSet) options.waterNeedPerDay = config.params.plantWaterNeedPerDay;
+        options.initial.soilRetentionRate = config.params.soilRetentionRate;
+        options.initial.soilDrainageFactor = config.params.soilDrainageFactor;
+        options.initial.plantAbsorptionRate = config.params.plantAbsorptionRate;
+    }
+    std::ifstream csv(logPath);
+    if (!csv) {
+        std::cerr << "Failed to open log: " << logPath << std::endl;
+        return 1;
+    }
+    ObservedSeries series;
+    if (!loadObservedSeries(csv, zone, series, error)) {
+        std::cerr << "Failed to load log: " << error << std::endl;
+        return 1;
+    }
+    std::cout << "Observed: " << series.size() << " steps, " << series.stressedRows << " with plant stress" << std::endl;
+    if (!configPath.empty()) {
+        printFit("Configured", evaluateFit(series, options.initial, options.waterNeedPerDay, options.segmentSteps));
+    }
+
+    ZoneScheduler scheduler(threads > 0 ? static_cast<size_t>(threads) : 1, 1);
+    auto start = std::chrono::steady_clock::now();
+    CalibrationResult result = calibrate(series, options, scheduler);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    printFit("Fitted", evaluateFit(series, result.params, options.waterNeedPerDay, options.segmentSteps));
+    std::cout << result.evaluations << " evaluations on " << scheduler.getThreadCount() << " threads in "
+              << std::fixed << std::setprecision(3) << seconds << " s ("
+              << std::setprecision(2) << seconds * 1e6 / result.evaluations << " us each)" << std::endl;
+
+    std::ostringstream lines;
+    lines << std::setprecision(6) << std::defaultfloat
+          << "soil_retention_rate=" << result.params.soilRetentionRate << '\n'
+          << "soil_drainage_factor=" << result.params.soilDrainageFactor << '\n';
+    if (result.fittedAbsorption) lines << "plant_absorption_rate=" << result.params.plantAbsorptionRate << '\n';
+    std::cout << lines.str();
+    if (!result.fittedAbsorption) {
+        std::cout << std::defaultfloat << std::setprecision(6) << "plant_absorption_rate not fitted: fewer than " << options.minStressedShare * 100.0f
+                  << " % of the rows show plant stress, kept " << result.params.plantAbsorptionRate << std::endl;
+    }
+    if (!outputPath.empty()) {
+        std::ofstream out(outputPath);
+        if (!(out << lines.str())) {
+            std::cerr << "Failed to write " << outputPath << std::endl;
+            return 1;
+        }
+    }
+    return 0;
+}
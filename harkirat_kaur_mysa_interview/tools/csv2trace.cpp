@@ -0,0 +1,33 @@
+// mysa_csv2trace: converts recorded station data to a memory-mappable weather trace (.mwx).
+// Usage: mysa_csv2trace <input.csv> <output.mwx>
+// Input rows are time_s,temperature,humidity,rain_mm with evenly spaced times (header line optional);
+// rain_mm is the rain that fell between a row and the next one.
+#include <iostream>
+#include <fstream>
+#include <string>
+#include "../include/WeatherTrace.h"
+
+int main(int argc, char* argv[]) {
+    if (argc != 3) {
+        std::cerr << "Usage: " << argv[0] << " <input.csv> <output.mwx>" << std::endl;
+        return 12;
+    }
+    std::ifstream csv(argv[1]);
+    if (!csv) {
+        std::cerr << "Failed to open " << argv[1] << std::endl;
+        return 1;
+    }
+    std::string error;
+    if (!convertWeatherCsv(csv, argv[2], error)) {
+        std::cerr << "Failed to convert " << argv[1] << ": " << error << std::endl;
+        return 2;
+    }
+    WeatherTrace trace;
+    if (!trace.open(argv[2], error)) {
+        std::cerr << error << std::endl;
+        return 2;
+    }
+    std::cout << argv[2] << ": " << trace.getSampleCount() << " samples every " << trace.getInterval() << " s ("
+              << trace.getDuration() / 86400.0 << " days)" << std::endl;
+    return 0;
+}
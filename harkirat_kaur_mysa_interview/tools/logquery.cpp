@@ -0,0 +1,184 @@
+// mysa_log_query: finds rows of an output.csv log, using its block index (--log-index) to skip blocks.
+// Usage: mysa_log_query <output.csv> [--zone <id>] [--from <t>] [--to <t>] [--pump on|off]
+//                       [--moisture-below <%>] [--moisture-above <%>] [--stress-below <%>] [--stress-above <%>]
+//                       [--count|--spans] [--index <file.idx>|--no-index]
+// Times are <number>[s|m|h|d] since the start of the run, e.g. --from 12d --to 14d. Matching rows are printed
+// as CSV; --spans prints one line per run of consecutive matching steps of a zone instead.
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+#include "../include/LogIndex.h"
+
+static bool parseTime(const std::string& text, int64_t& seconds) {
+    char* end = nullptr;
+    double value = std::strtod(text.c_str(), &end);
+    if (end == text.c_str()) return false;
+    std::string unit(end);
+    double scale = unit.empty() || unit == "s" ? 1 : unit == "m" ? 60 : unit == "h" ? 3600 : unit == "d" ? 86400 : 0;
+    if (scale == 0) return false;
+    seconds = static_cast<int64_t>(value * scale);
+    return true;
+}
+
+static bool parseFloat(const std::string& text, float& value) {
+    char* end = nullptr;
+    value = std::strtof(text.c_str(), &end);
+    return end != text.c_str() && *end == '\0';
+}
+
+// Seconds between the first two distinct timestamps (the simulation step), 1 if the log has fewer
+static int64_t logStep(const char* data, size_t size) {
+    const char* p = static_cast<const char*>(std::memchr(data, '\n', size));
+    const char* stop = data + size;
+    bool haveFirst = false;
+    int64_t first = 0;
+    while (p && ++p < stop) {
+        const char* newline = static_cast<const char*>(std::memchr(p, '\n', stop - p));
+        LogRow row;
+        if (parseLogRow(p, newline ? newline : stop, row)) {
+            if (haveFirst && row.time != first) return row.time > first ? row.time - first : 1;
+            haveFirst = true;
+            first = row.time;
+        }
+        p = newline;
+    }
+    return 1;
+}
+
+struct Span {
+    std::string zone;
+    std::string start; // Timestamps as logged
+    std::string end;
+    int64_t startTime = 0;
+    int64_t endTime = 0;
+    uint64_t steps = 0;
+};
+
+int main(int argc, char* argv[]) {
+    const char* usage = " <output.csv> [--zone <id>] [--from <t>] [--to <t>] [--pump on|off] [--moisture-below <%>] "
+                        "[--moisture-above <%>] [--stress-below <%>] [--stress-above <%>] [--count|--spans] "
+                        "[--index <file.idx>|--no-index]";
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << usage << std::endl;
+        return 12;
+    }
+    std::string logPath = argv[1];
+    std::string indexPath = logPath + ".idx";
+    bool useIndex = true, explicitIndex = false, countOnly = false, spans = false;
+    LogQuery query;
+    for (int i = 2; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        bool ok = true;
+        if (arg == "--zone" && hasValue) {
+            query.zone = argv[++i];
+        } else if (arg == "--from" && hasValue) {
+            ok = parseTime(argv[++i], query.from);
+        } else if (arg == "--to" && hasValue) {
+            ok = parseTime(argv[++i], query.to);
+        } else if (arg == "--pump" && hasValue) {
+            std::string state = argv[++i];
+            query.pump = state == "on" ? 1 : state == "off" ? 0 : -1;
+            ok = query.pump >= 0;
+        } else if (arg == "--moisture-below" && hasValue) {
+            ok = parseFloat(argv[++i], query.moistureBelow);
+        } else if (arg == "--moisture-above" && hasValue) {
+            ok = parseFloat(argv[++i], query.moistureAbove);
+        } else if (arg == "--stress-below" && hasValue) {
+            ok = parseFloat(argv[++i], query.stressBelow);
+        } else if (arg == "--stress-above" && hasValue) {
+            ok = parseFloat(argv[++i], query.stressAbove);
+        } else if (arg == "--count") {
+            countOnly = true;
+        } else if (arg == "--spans") {
+            spans = true;
+        } else if (arg == "--index" && hasValue) {
+            indexPath = argv[++i];
+            explicitIndex = true;
+        } else if (arg == "--no-index") {
+            useIndex = false;
+        } else {
+            ok = false;
+        }
+        if (!ok) {
+            std::cerr << "Invalid argument: " << arg << "\nUsage: " << argv[0] << usage << std::endl;
+            return 12;
+        }
+    }
+
+    MappedFile log;
+    std::string error;
+    if (!log.open(logPath, error)) {
+        std::cerr << "Failed to open log: " << error << std::endl;
+        return 1;
+    }
+    LogIndex index;
+    bool indexed = false;
+    if (useIndex) {
+        indexed = index.load(indexPath, error);
+        if (!indexed && (explicitIndex || std::ifstream(indexPath))) {
+            std::cerr << "Failed to load index: " << error << std::endl;
+            return 1;
+        }
+        if (!indexed) std::cerr << "No index at " << indexPath << ", scanning the whole log" << std::endl;
+    }
+
+    int64_t step = spans ? logStep(log.data(), log.size()) : 1;
+    std::map<std::string, Span> open; // Per zone, the span its last matching row extended
+    std::vector<Span> closed;
+    if (!countOnly && !spans) std::cout << CsvLogSink::header() << '\n';
+    LogQueryStats stats;
+    bool ok = queryLog(log.data(), log.size(), indexed ? &index : nullptr, query,
+        [&](const LogRow& row, const char* line, size_t length) {
+            if (countOnly) return;
+            if (!spans) {
+                std::cout.write(line, length);
+                std::cout << '\n';
+                return;
+            }
+            std::string zone(row.zone, row.zoneLength);
+            std::string timestamp(line, 19);
+            std::map<std::string, Span>::iterator it = open.find(zone);
+            if (it != open.end() && row.time - it->second.endTime <= step) {
+                it->second.end = timestamp;
+                it->second.endTime = row.time;
+                ++it->second.steps;
+                return;
+            }
+            if (it != open.end()) closed.push_back(it->second);
+            Span span;
+            span.zone = zone;
+            span.start = span.end = timestamp;
+            span.startTime = span.endTime = row.time;
+            span.steps = 1;
+            open[zone] = span;
+        },
+        stats, error);
+    if (!ok) {
+        std::cerr << "Query failed: " << error << " (rebuild it with --log-index or pass --no-index)" << std::endl;
+        return 2;
+    }
+    if (countOnly) std::cout << stats.rowsMatched << std::endl;
+    if (spans) {
+        for (const auto& entry : open) closed.push_back(entry.second);
+        std::sort(closed.begin(), closed.end(), [](const Span& a, const Span& b) {
+            return a.startTime != b.startTime ? a.startTime < b.startTime : a.zone < b.zone;
+        });
+        std::cout << "ZoneID,Start,End,Steps\n";
+        for (const Span& span : closed) {
+            std::cout << span.zone << ',' << span.start << ',' << span.end << ',' << span.steps << '\n';
+        }
+    }
+    std::cout.flush();
+    std::cerr << stats.rowsMatched << " matching rows; scanned " << stats.rowsScanned << " rows, "
+              << stats.bytesScanned << " of " << log.size() << " bytes";
+    if (indexed) std::cerr << ", " << stats.blocksScanned << " of " << stats.blocks << " blocks";
+    if (stats.malformedRows > 0) std::cerr << ", " << stats.malformedRows << " malformed rows skipped";
+    std::cerr << std::endl;
+    return 0;
+}